@@ -0,0 +1,99 @@
+<#
+.SYNOPSIS
+    Compiles language files into binary language packs.
+
+.DESCRIPTION
+    Writes a .wmlang pack next to every given JSON file: the texts already
+    encoded as UTF-16 plus a key table sorted ordinally, see
+    WinMute\LanguagePack.hpp for the layout. WinMute maps the pack instead of
+    parsing the JSON file, but only if the pack records the size and content
+    hash of the JSON file next to it.
+
+.PARAMETER Path
+    The language files to compile.
+
+.EXAMPLE
+    .\Tools\BuildLanguagePacks.ps1 -Path (Get-ChildItem Dist\bin\lang\*.json).FullName
+#>
+param(
+    [Parameter(Mandatory = $true)]
+    [string[]]$Path
+)
+
+$ErrorActionPreference = 'Stop'
+
+# Must match LanguagePackView::kVersion.
+$packVersion = 2
+$headerSize = 40
+$entrySize = 16
+
+# Must match LanguagePackView::HashSource.
+Add-Type -TypeDefinition @'
+public static class WinMuteLanguagePack {
+    public static ulong HashSource(byte[] source) {
+        ulong hash = 14695981039346656037UL;
+        foreach (byte b in source) {
+            hash = unchecked((hash ^ b) * 1099511628211UL);
+        }
+        return hash;
+    }
+}
+'@
+
+foreach ($source in $Path) {
+    $file = Get-Item -LiteralPath $source
+    $sourceBytes = [System.IO.File]::ReadAllBytes($file.FullName)
+    $json = Get-Content -LiteralPath $file.FullName -Raw -Encoding UTF8 |
+        ConvertFrom-Json
+    $keys = [string[]]@($json.PSObject.Properties.Name)
+    [Array]::Sort($keys, [StringComparer]::Ordinal)
+
+    # Texts come first in the blob, so they stay 2-byte aligned; the key
+    # offsets are moved behind them when the entries are written.
+    $texts = New-Object System.IO.MemoryStream
+    $keyBlob = New-Object System.IO.MemoryStream
+    $entries = New-Object System.Collections.Generic.List[object]
+    foreach ($key in $keys) {
+        if ($key -cnotmatch '^[a-z][a-z0-9._-]*$') {
+            throw "$($file.Name): key '$key' is not of the form a.b-c"
+        }
+        $value = $json.$key
+        if ($value -isnot [string]) {
+            throw "$($file.Name): '$key' is not a string"
+        }
+        $keyBytes = [System.Text.Encoding]::ASCII.GetBytes($key)
+        $textBytes = [System.Text.Encoding]::Unicode.GetBytes($value)
+        $entries.Add(@($keyBlob.Length, $keyBytes.Length, $texts.Length,
+                       $value.Length))
+        $keyBlob.Write($keyBytes, 0, $keyBytes.Length)
+        $texts.Write($textBytes, 0, $textBytes.Length)
+        $texts.Write([byte[]](0, 0), 0, 2)
+    }
+
+    $blobOffset = $headerSize + $entrySize * $entries.Count
+    $packPath = [System.IO.Path]::ChangeExtension($file.FullName, '.wmlang')
+    $stream = [System.IO.File]::Create($packPath)
+    try {
+        $writer = New-Object System.IO.BinaryWriter $stream
+        $writer.Write([System.Text.Encoding]::ASCII.GetBytes('WMLP'))
+        $writer.Write([uint32]$packVersion)
+        $writer.Write([uint64]$sourceBytes.Length)
+        $writer.Write([WinMuteLanguagePack]::HashSource($sourceBytes))
+        $writer.Write([uint32]$entries.Count)
+        $writer.Write([uint32]$headerSize)
+        $writer.Write([uint32]$blobOffset)
+        $writer.Write([uint32]($texts.Length + $keyBlob.Length))
+        foreach ($entry in $entries) {
+            $writer.Write([uint32]($texts.Length + $entry[0]))
+            $writer.Write([uint32]$entry[1])
+            $writer.Write([uint32]$entry[2])
+            $writer.Write([uint32]$entry[3])
+        }
+        $writer.Write($texts.ToArray())
+        $writer.Write($keyBlob.ToArray())
+        $writer.Flush()
+    } finally {
+        $stream.Dispose()
+    }
+    Write-Host "Compiled $($file.Name) into $(Split-Path $packPath -Leaf)"
+}
@@ -0,0 +1,73 @@
+<#
+.SYNOPSIS
+    Generates WinMute\TranslationKeys.h from the default language file.
+
+.DESCRIPTION
+    Every key of lang-en.json becomes a TextId, named after the key with '.'
+    and '-' replaced by '_', and an entry of kTextKeys. Keys are sorted
+    ordinally, so WinMute can look them up at compile time with a binary
+    search; a key that is not in lang-en.json then fails to compile.
+
+    The build runs this whenever lang-en.json changes. The header is only
+    rewritten if its content changed, so the precompiled header is not
+    rebuilt for a changed translation text.
+
+.EXAMPLE
+    .\Tools\GenerateTranslationKeys.ps1
+#>
+param(
+    [string]$Source = (Join-Path $PSScriptRoot '..\Translations\lang-en.json'),
+    [string]$Output = (Join-Path $PSScriptRoot '..\WinMute\TranslationKeys.h')
+)
+
+$ErrorActionPreference = 'Stop'
+
+$json = Get-Content -LiteralPath $Source -Raw -Encoding UTF8 | ConvertFrom-Json
+$keys = [string[]]@($json.PSObject.Properties.Name)
+[Array]::Sort($keys, [StringComparer]::Ordinal)
+
+$ids = @{}
+$enumLines = New-Object System.Collections.Generic.List[string]
+$keyLines = New-Object System.Collections.Generic.List[string]
+foreach ($key in $keys) {
+    if ($key -cnotmatch '^[a-z][a-z0-9._-]*$') {
+        throw "Translation key '$key' in $Source is not of the form a.b-c"
+    }
+    $id = $key -replace '[.-]', '_'
+    if ($ids.ContainsKey($id)) {
+        throw "Translation keys '$($ids[$id])' and '$key' both map to $id"
+    }
+    $ids[$id] = $key
+    $enumLines.Add("    $id,")
+    $keyLines.Add("    `"$key`",")
+}
+
+$lines = @(
+    '// Generated from Translations/lang-en.json by'
+    '// Tools/GenerateTranslationKeys.ps1. Do not edit.'
+    ''
+    '#pragma once'
+    ''
+    '#include <cstdint>'
+    '#include <string_view>'
+    ''
+    '// One id per key of the default language, in ordinal key order.'
+    'enum class TextId : std::uint16_t {'
+) + $enumLines + @(
+    '    Count'
+    '};'
+    ''
+    '// The key of each TextId.'
+    'inline constexpr std::string_view kTextKeys[] = {'
+) + $keyLines + @(
+    '};'
+)
+$text = ($lines -join "`n") + "`n"
+
+if ((Test-Path -LiteralPath $Output) -and
+    ([System.IO.File]::ReadAllText($Output) -ceq $text)) {
+    exit 0
+}
+[System.IO.File]::WriteAllText($Output, $text,
+    (New-Object System.Text.UTF8Encoding $false))
+Write-Host "Generated $Output with $($keys.Count) keys"
@@ -0,0 +1,292 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Offline analyzer for WinMute's JSON lines logs (WinMute.jsonl and its
+// rotated files). Builds on any platform with a C++20 compiler, see
+// CMakeLists.txt.
+//
+//   LogAnalyzer [--per-file] <file or directory>...
+//
+// Directories are searched recursively for files with ".jsonl" in their name,
+// so a tree of logs collected from many machines can be passed as is. Reports
+// per-trigger counts, mute latency percentiles and error rates; folded repeats
+// count as often as they were repeated. Files are streamed line by line;
+// memory use does not depend on the size of the logs.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "LatencyHistogram.hpp"
+#include "libs/json.hpp"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace {
+
+struct TriggerStats {
+    std::uint64_t starts = 0;
+    std::uint64_t ends = 0;
+    std::uint64_t mutes = 0;
+    LatencyHistogram latency;
+};
+
+struct FileStats {
+    std::string path;
+    std::uint64_t records = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t warnings = 0;
+};
+
+struct Report {
+    std::uint64_t records = 0;
+    std::uint64_t malformed = 0;
+    std::map<std::string, std::uint64_t> levels;
+    std::map<std::string, TriggerStats> triggers;
+    std::map<std::string, std::uint64_t> endpointErrors;
+    std::uint64_t restores = 0;
+    std::vector<FileStats> files;
+};
+
+std::string GetString(const json& record, const char* key)
+{
+    const auto it = record.find(key);
+    if (it == record.end() || !it->is_string()) {
+        return std::string();
+    }
+    return it->get<std::string>();
+}
+
+// How many records `record` stands for: a summary of folded repeats counts
+// as the repeats it replaced.
+std::uint32_t GetCount(const json& record)
+{
+    const auto repeats = record.find("repeats");
+    if (repeats == record.end() || !repeats->is_number_unsigned()) {
+        return 1;
+    }
+    return static_cast<std::uint32_t>(
+        std::min<std::uint64_t>(repeats->get<std::uint64_t>(), UINT32_MAX));
+}
+
+void AnalyzeRecord(const json& record, Report& report, FileStats& file)
+{
+    const auto level = GetString(record, "level");
+    const auto count = GetCount(record);
+    report.records += count;
+    report.levels[level] += count;
+    file.records += count;
+    if (level == "ERROR") {
+        file.errors += count;
+    } else if (level == "WARNING") {
+        file.warnings += count;
+    }
+
+    const auto event = GetString(record, "event");
+    if (event.empty()) {
+        return;
+    }
+    const auto trigger = GetString(record, "trigger");
+    if (event == "trigger_start") {
+        report.triggers[trigger].starts += count;
+    } else if (event == "trigger_end") {
+        report.triggers[trigger].ends += count;
+    } else if (event == "muted") {
+        auto& stats = report.triggers[trigger];
+        stats.mutes += count;
+        const auto duration = record.find("duration_us");
+        if (duration != record.end() && duration->is_number_integer()) {
+            stats.latency.Record(
+                LatencyHistogram::Duration(duration->get<std::int64_t>()),
+                count);
+        }
+    } else if (event == "restore") {
+        report.restores += count;
+    } else if (event == "endpoint_error") {
+        report.endpointErrors[GetString(record, "endpoint")] += count;
+    }
+}
+
+bool AnalyzeFile(const fs::path& path, Report& report)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "Cannot open %s\n", path.string().c_str());
+        return false;
+    }
+    FileStats file;
+    file.path = path.string();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        const auto record = json::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object()) {
+            ++report.malformed;
+            continue;
+        }
+        AnalyzeRecord(record, report, file);
+    }
+    report.files.push_back(std::move(file));
+    return true;
+}
+
+bool IsJsonLog(const fs::path& path)
+{
+    return path.filename().string().find(".jsonl") != std::string::npos;
+}
+
+double Percent(std::uint64_t part, std::uint64_t total)
+{
+    return total == 0 ? 0.0
+                      : 100.0 * static_cast<double>(part) /
+                            static_cast<double>(total);
+}
+
+void PrintReport(const Report& report, bool perFile)
+{
+    std::printf("%llu records in %zu file(s), %llu malformed line(s)\n\n",
+                static_cast<unsigned long long>(report.records),
+                report.files.size(),
+                static_cast<unsigned long long>(report.malformed));
+
+    std::printf("Levels:\n");
+    for (const auto& [level, count] : report.levels) {
+        std::printf("  %-10s %10llu  %6.2f%%\n", level.c_str(),
+                    static_cast<unsigned long long>(count),
+                    Percent(count, report.records));
+    }
+
+    std::printf("\nTriggers:\n");
+    std::printf("  %-36s %8s %8s %8s %10s %10s %10s %10s\n", "trigger",
+                "starts", "ends", "mutes", "p50 us", "p90 us", "p99 us",
+                "max us");
+    for (const auto& [trigger, stats] : report.triggers) {
+        const auto& latency = stats.latency;
+        std::printf("  %-36s %8llu %8llu %8llu %10lld %10lld %10lld %10lld\n",
+                    trigger.empty() ? "(none)" : trigger.c_str(),
+                    static_cast<unsigned long long>(stats.starts),
+                    static_cast<unsigned long long>(stats.ends),
+                    static_cast<unsigned long long>(stats.mutes),
+                    static_cast<long long>(latency.Percentile(50).count()),
+                    static_cast<long long>(latency.Percentile(90).count()),
+                    static_cast<long long>(latency.Percentile(99).count()),
+                    static_cast<long long>(latency.Max().count()));
+    }
+    std::printf("\nRestores: %llu\n",
+                static_cast<unsigned long long>(report.restores));
+
+    if (!report.endpointErrors.empty()) {
+        std::printf("\nEndpoint errors:\n");
+        for (const auto& [endpoint, count] : report.endpointErrors) {
+            std::printf("  %8llu  %s\n", static_cast<unsigned long long>(count),
+                        endpoint.empty() ? "(unknown)" : endpoint.c_str());
+        }
+    }
+
+    std::uint64_t filesWithErrors = 0;
+    for (const auto& file : report.files) {
+        filesWithErrors += file.errors != 0 ? 1 : 0;
+    }
+    std::printf("\nFiles with errors: %llu of %zu\n",
+                static_cast<unsigned long long>(filesWithErrors),
+                report.files.size());
+    if (perFile) {
+        std::printf("  %10s %8s %8s %8s  %s\n", "records", "errors",
+                    "warnings", "error %", "file");
+        for (const auto& file : report.files) {
+            std::printf("  %10llu %8llu %8llu %7.2f%%  %s\n",
+                        static_cast<unsigned long long>(file.records),
+                        static_cast<unsigned long long>(file.errors),
+                        static_cast<unsigned long long>(file.warnings),
+                        Percent(file.errors, file.records), file.path.c_str());
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    bool perFile = false;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--per-file") {
+            perFile = true;
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr,
+                     "Usage: %s [--per-file] <file or directory>...\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<fs::path> files;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            for (fs::recursive_directory_iterator it(input, ec), end;
+                 !ec && it != end; it.increment(ec))
+            {
+                if (it->is_regular_file(ec) && IsJsonLog(it->path())) {
+                    files.push_back(it->path());
+                }
+            }
+        } else {
+            files.push_back(input);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    Report report;
+    bool success = true;
+    for (const auto& file : files) {
+        success = AnalyzeFile(file, report) && success;
+    }
+    PrintReport(report, perFile);
+    return success ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Captured messages must format exactly like a direct std::format call, and
+// strings that do not fit must be cut off with an ellipsis.
+
+#include <cstdint>
+#include <format>
+#include <string>
+#include <string_view>
+
+#include "Check.hpp"
+#include "DeferredFormat.hpp"
+
+namespace {
+
+constexpr wchar_t kEllipsis = L'…';
+
+// Captures, then checks the result against std::format with the same
+// arguments.
+template <std::size_t Bytes = 512, typename... Args>
+bool RoundTrips(std::wformat_string<Args...> fmt, const Args&... args)
+{
+    DeferredFormat<Bytes> deferred;
+    deferred.Capture(fmt, args...);
+    const std::wstring expected = std::vformat(
+        fmt.get(), std::make_wformat_args(args...));
+    return deferred.Format() == expected &&
+           deferred.FormatString() == fmt.get();
+}
+
+void TestRoundTrip()
+{
+    const int negative = -42;
+    const std::uint64_t big = 18446744073709551615ull;
+    const double pi = 3.14159;
+    const bool yes = true;
+    const wchar_t letter = L'x';
+    const std::wstring owned = L"Workstation Lock";
+    const std::wstring_view view = L"Display Standby";
+    const wchar_t* pointer = L"Bluetooth";
+
+    CHECK(RoundTrips(L"no arguments"));
+    CHECK(RoundTrips(L"{} {} {:.2f} {} {}", negative, big, pi, yes, letter));
+    CHECK(RoundTrips(L"Muted {} us after \"{}\" arrived", 412, owned));
+    CHECK(RoundTrips(L"{}/{}/{}", owned, view, pointer));
+    CHECK(RoundTrips(L"{1} before {0}", view, 7));
+    CHECK(RoundTrips(L"{:>8}|{:<5}|{:#x}", view.substr(0, 3), 12, 255));
+    // Values and strings mixed, so the strings follow padding.
+    const char c = 'c';
+    CHECK(RoundTrips(L"{}{}{}{}", c, owned, static_cast<short>(3), pointer));
+}
+
+void TestNullString()
+{
+    const wchar_t* none = nullptr;
+    DeferredFormat<64> deferred;
+    deferred.Capture(L"[{}]", none);
+    CHECK(deferred.Format() == L"[]");
+}
+
+void TestFormatToAppends()
+{
+    DeferredFormat<64> deferred;
+    deferred.Capture(L"{}-{}", 1, 2);
+    std::wstring out = L">";
+    deferred.FormatTo(out);
+    CHECK(out == L">1-2");
+
+    DeferredFormat<64> empty;
+    CHECK(empty.Format().empty());
+}
+
+void TestCaptureText()
+{
+    DeferredFormat<128> deferred;
+    deferred.CaptureText(L"already {formatted}");
+    CHECK(deferred.Format() == L"already {formatted}");
+}
+
+void TestTruncation()
+{
+    // 64 bytes: a length prefix and 31 characters (wchar_t is 2 bytes) or
+    // 15 (4 bytes).
+    constexpr std::size_t kChars =
+        (64 - deferred_format::kLengthBytes) / sizeof(wchar_t);
+    const std::wstring longText(200, L'a');
+
+    DeferredFormat<64> deferred;
+    deferred.Capture(L"{}", longText);
+    const std::wstring out = deferred.Format();
+    CHECK(out.size() == kChars);
+    CHECK(out.back() == kEllipsis);
+    CHECK(out.substr(0, kChars - 1) == std::wstring(kChars - 1, L'a'));
+
+    // Anything that fits is stored whole, up to the exact size.
+    for (std::size_t n = 0; n <= kChars; ++n) {
+        const std::wstring fits(n, L'b');
+        deferred.Capture(L"{}", fits);
+        CHECK(deferred.Format() == fits);
+    }
+
+    deferred.CaptureText(longText);
+    CHECK(deferred.Format().size() == kChars);
+    CHECK(deferred.Format().back() == kEllipsis);
+}
+
+// A short string is kept whole, the long ones share the rest.
+void TestTruncationSharesBudget()
+{
+    constexpr std::size_t kBytes = 256;
+    const std::wstring shortText = L"id";
+    const std::wstring longA(500, L'a');
+    const std::wstring longB(500, L'b');
+
+    DeferredFormat<kBytes> deferred;
+    deferred.Capture(L"{}|{}|{}|{}", 7, longA, shortText, longB);
+    const std::wstring out = deferred.Format();
+
+    const std::size_t first = out.find(L'|');
+    const std::size_t second = out.find(L'|', first + 1);
+    const std::size_t third = out.find(L'|', second + 1);
+    CHECK(out.substr(0, first) == L"7");
+    const std::wstring a = out.substr(first + 1, second - first - 1);
+    const std::wstring b = out.substr(third + 1);
+    CHECK(out.substr(second + 1, third - second - 1) == shortText);
+    CHECK(a.size() == b.size());
+    CHECK(a.back() == kEllipsis && b.back() == kEllipsis);
+
+    const std::size_t budget =
+        (kBytes - sizeof(int) - 3 * deferred_format::kLengthBytes) /
+        sizeof(wchar_t);
+    CHECK(a.size() + b.size() + shortText.size() <= budget);
+    CHECK(a.size() + b.size() + shortText.size() + 2 > budget);
+}
+
+void TestSameAs()
+{
+    const std::wstring name = L"Lid Close";
+    DeferredFormat<128> a;
+    DeferredFormat<128> b;
+    a.Capture(L"Mute Event: {} {}", name, 1);
+    b.Capture(L"Mute Event: {} {}", name, 1);
+    CHECK(a.SameAs(b));
+    b.Capture(L"Mute Event: {} {}", name, 2);
+    CHECK(!a.SameAs(b));
+    b.Capture(L"Mute Event: {} {}", std::wstring(L"Lid Open"), 1);
+    CHECK(!a.SameAs(b));
+    // Same text, different format string: not the same kind of message.
+    b.Capture(L"Mute Event:  {} {}", name, 1);
+    CHECK(!a.SameAs(b));
+}
+
+}  // namespace
+
+int main()
+{
+    TestRoundTrip();
+    TestNullString();
+    TestFormatToAppends();
+    TestCaptureText();
+    TestTruncation();
+    TestTruncationSharesBudget();
+    TestSameAs();
+    return check::Result();
+}
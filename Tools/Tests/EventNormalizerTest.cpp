@@ -0,0 +1,278 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Replays recorded-style notification sequences through EventNormalizer with
+// the rules WinMute uses for its trigger sources.
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "Check.hpp"
+#include "EventNormalizer.hpp"
+
+using namespace std::chrono_literals;
+using Verdict = EventNormalizer::Verdict;
+
+namespace {
+
+enum Source : std::size_t { Display, Lid, Bluetooth, Wlan, Count };
+
+std::vector<EventNormalizer::Rule> GetRules()
+{
+    std::vector<EventNormalizer::Rule> rules(Count);
+    rules[Lid].armedBy = 1;
+    rules[Bluetooth].debounce = 1s;
+    return rules;
+}
+
+struct Step {
+    std::size_t source;
+    int state;
+    int atMs;
+    Verdict expected;
+};
+
+struct Passed {
+    std::size_t source;
+    int state;
+    int atMs;
+
+    bool operator==(const Passed&) const = default;
+};
+
+class Replay {
+   public:
+    Replay() : normalizer_(GetRules(), [this](const auto& e) { Record(e); })
+    {
+    }
+
+    static EventNormalizer::TimePoint At(int ms)
+    {
+        return EventNormalizer::TimePoint{} + std::chrono::milliseconds(ms);
+    }
+
+    void Run(const std::vector<Step>& steps)
+    {
+        for (const auto& step : steps) {
+            const Verdict verdict =
+                normalizer_.Submit(step.source, step.state, At(step.atMs));
+            CHECK(verdict == step.expected);
+        }
+    }
+
+    EventNormalizer normalizer_;
+    std::vector<Passed> passed_;
+
+   private:
+    void Record(const EventNormalizer::Event& e)
+    {
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            e.received.time_since_epoch());
+        passed_.push_back({e.source, e.state, static_cast<int>(ms.count())});
+    }
+};
+
+// Console and session display notifications both report the same transition.
+void TestDuplicatesAreDropped()
+{
+    Replay r;
+    r.Run({
+        {Display, 0, 0, Verdict::Passed},
+        {Display, 0, 2, Verdict::Duplicate},
+        {Display, 1, 500, Verdict::Passed},
+        {Display, 1, 501, Verdict::Duplicate},
+    });
+    CHECK((r.passed_ == std::vector<Passed>{{Display, 0, 0},
+                                             {Display, 1, 500}}));
+    CHECK(r.normalizer_.GetCounters(Display).duplicates == 2);
+}
+
+void TestLateDeliveryIsDropped()
+{
+    Replay r;
+    r.Run({
+        {Display, 0, 100, Verdict::Passed},
+        {Display, 1, 50, Verdict::OutOfOrder},
+        {Display, 1, 150, Verdict::Passed},
+    });
+    CHECK(r.passed_.size() == 2);
+    CHECK(r.normalizer_.GetCounters(Display).outOfOrder == 1);
+}
+
+// A laptop started with its lid closed must not mute on launch.
+void TestLidWaitsUntilOpenedOnce()
+{
+    Replay r;
+    r.Run({
+        {Lid, 0, 0, Verdict::Unarmed},
+        {Lid, 0, 10, Verdict::Unarmed},
+        {Lid, 1, 1000, Verdict::Passed},
+        {Lid, 0, 2000, Verdict::Passed},
+    });
+    CHECK((r.passed_ ==
+           std::vector<Passed>{{Lid, 1, 1000}, {Lid, 0, 2000}}));
+    CHECK(r.normalizer_.GetCounters(Lid).unarmed == 2);
+}
+
+// A flaky headset: the first disconnect passes, the reconnects and
+// disconnects within the window collapse into the final state.
+void TestFlappingIsDebounced()
+{
+    Replay r;
+    r.Run({
+        {Bluetooth, 1, 0, Verdict::Passed},
+        {Bluetooth, 0, 2000, Verdict::Passed},
+        {Bluetooth, 1, 2100, Verdict::Held},
+        {Bluetooth, 0, 2200, Verdict::Held},
+        {Bluetooth, 1, 2300, Verdict::Held},
+    });
+    CHECK(r.passed_.size() == 2);
+    CHECK(r.normalizer_.NextDeadline() == Replay::At(3000));
+
+    r.normalizer_.Poll(Replay::At(2999));
+    CHECK(r.passed_.size() == 2);
+    r.normalizer_.Poll(Replay::At(3000));
+    CHECK((r.passed_.back() == Passed{Bluetooth, 1, 2300}));
+    CHECK(!r.normalizer_.NextDeadline());
+    CHECK(r.normalizer_.GetCounters(Bluetooth).coalesced == 2);
+}
+
+void TestRevertWithinWindowIsNeverPassed()
+{
+    Replay r;
+    r.Run({
+        {Bluetooth, 0, 0, Verdict::Passed},
+        {Bluetooth, 1, 400, Verdict::Held},
+        {Bluetooth, 0, 600, Verdict::Held},
+    });
+    CHECK(!r.normalizer_.NextDeadline());
+    r.normalizer_.Poll(Replay::At(5000));
+    CHECK(r.passed_.size() == 1);
+    // The window has ended: the next change passes right away.
+    r.Run({{Bluetooth, 1, 5000, Verdict::Passed}});
+    CHECK(r.passed_.size() == 2);
+}
+
+// A held-back event is delivered when the next event arrives after its
+// window, even if Poll() was not called in time.
+void TestSubmitFlushesDueEvent()
+{
+    Replay r;
+    r.Run({
+        {Bluetooth, 0, 0, Verdict::Passed},
+        {Bluetooth, 1, 500, Verdict::Held},
+        {Bluetooth, 0, 3000, Verdict::Passed},
+    });
+    CHECK((r.passed_ == std::vector<Passed>{{Bluetooth, 0, 0},
+                                             {Bluetooth, 1, 500},
+                                             {Bluetooth, 0, 3000}}));
+}
+
+// The WLAN detector only reports networks its list applies to. When it is
+// unloaded while connected, no disconnect arrives; without a reset the next
+// connect would be dropped as a repeat.
+void TestResetForgetsUnreportedEnd()
+{
+    Replay r;
+    r.Run({
+        {Wlan, 1, 0, Verdict::Passed},
+        {Wlan, 1, 1000, Verdict::Duplicate},
+    });
+    r.normalizer_.Reset(Wlan);
+    r.Run({{Wlan, 1, 2000, Verdict::Passed}});
+    CHECK((r.passed_ ==
+           std::vector<Passed>{{Wlan, 1, 0}, {Wlan, 1, 2000}}));
+    // Counters survive the reset.
+    CHECK(r.normalizer_.GetCounters(Wlan).passed == 2);
+    CHECK(r.normalizer_.GetCounters(Wlan).duplicates == 1);
+}
+
+void TestResetDropsHeldEvent()
+{
+    Replay r;
+    r.Run({
+        {Bluetooth, 0, 0, Verdict::Passed},
+        {Bluetooth, 1, 100, Verdict::Held},
+    });
+    r.normalizer_.Reset(Bluetooth);
+    CHECK(!r.normalizer_.NextDeadline());
+    r.normalizer_.Poll(Replay::At(5000));
+    CHECK(r.passed_.size() == 1);
+    CHECK(r.normalizer_.GetCounters(Bluetooth).coalesced == 1);
+    // A reset does not re-arm: the earlier timestamps no longer matter.
+    r.Run({{Bluetooth, 0, 50, Verdict::Passed}});
+}
+
+void TestResetRearmsLid()
+{
+    Replay r;
+    r.Run({{Lid, 1, 0, Verdict::Passed}});
+    r.normalizer_.Reset(Lid);
+    r.Run({
+        {Lid, 0, 10, Verdict::Unarmed},
+        {Lid, 1, 20, Verdict::Passed},
+    });
+}
+
+void TestSourcesAreIndependent()
+{
+    Replay r;
+    r.Run({
+        {Bluetooth, 0, 0, Verdict::Passed},
+        {Bluetooth, 1, 10, Verdict::Held},
+        {Display, 0, 20, Verdict::Passed},
+        {Wlan, 1, 30, Verdict::Passed},
+        {Display, 0, 40, Verdict::Duplicate},
+    });
+    r.normalizer_.Reset(Wlan);
+    CHECK(r.normalizer_.NextDeadline() == Replay::At(1000));
+    CHECK(r.normalizer_.GetCounters(Display).passed == 1);
+}
+
+}  // namespace
+
+int main()
+{
+    TestDuplicatesAreDropped();
+    TestLateDeliveryIsDropped();
+    TestLidWaitsUntilOpenedOnce();
+    TestFlappingIsDebounced();
+    TestRevertWithinWindowIsNeverPassed();
+    TestSubmitFlushesDueEvent();
+    TestResetForgetsUnreportedEnd();
+    TestResetDropsHeldEvent();
+    TestResetRearmsLid();
+    TestSourcesAreIndependent();
+    return check::Result();
+}
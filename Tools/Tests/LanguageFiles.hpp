@@ -0,0 +1,110 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "TranslationTable.hpp"
+#include "libs/json.hpp"
+
+// Reads the language files in Translations/ for the translation tests and
+// benchmarks, without WinMute's Win32 string conversion.
+namespace language_files {
+
+using Entries = std::vector<std::pair<std::string, std::wstring>>;
+
+inline std::filesystem::path Directory()
+{
+    return WINMUTE_TRANSLATIONS_DIR;
+}
+
+// UTF-8 to UTF-16 or UTF-32, depending on the size of wchar_t. The files are
+// checked by TranslationChecker, so invalid input is not handled.
+inline std::wstring Widen(std::string_view utf8)
+{
+    std::wstring wide;
+    wide.reserve(utf8.size());
+    for (std::size_t i = 0; i < utf8.size();) {
+        const auto lead = static_cast<unsigned char>(utf8[i]);
+        const int extra = lead < 0x80   ? 0
+                          : lead < 0xE0 ? 1
+                          : lead < 0xF0 ? 2
+                                        : 3;
+        char32_t cp = extra == 0 ? lead : lead & (0x3F >> extra);
+        for (int k = 1; k <= extra && i + k < utf8.size(); ++k) {
+            cp = (cp << 6) | (static_cast<unsigned char>(utf8[i + k]) & 0x3F);
+        }
+        i += 1 + extra;
+        if (sizeof(wchar_t) == 2 && cp >= 0x10000) {
+            cp -= 0x10000;
+            wide += static_cast<wchar_t>(0xD800 + (cp >> 10));
+            wide += static_cast<wchar_t>(0xDC00 + (cp & 0x3FF));
+        } else {
+            wide += static_cast<wchar_t>(cp);
+        }
+    }
+    return wide;
+}
+
+// The key/text pairs of `file`, in file order.
+inline Entries Read(const std::filesystem::path& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    const auto json = nlohmann::json::parse(in);
+    Entries entries;
+    for (auto it = json.begin(); it != json.end(); ++it) {
+        entries.emplace_back(it.key(), Widen(it->get<std::string>()));
+    }
+    return entries;
+}
+
+// The texts of `entries` with a known key, like WMi18n loads them.
+inline TranslationTable ToTable(const Entries& entries)
+{
+    TranslationTable table;
+    for (const auto& [key, text] : entries) {
+        const TextId id = TextKey::Lookup(key);
+        if (id != TextId::Count && !text.empty()) {
+            table.Set(id, text);
+        }
+    }
+    return table;
+}
+
+}  // namespace language_files
@@ -0,0 +1,144 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Cost of the log history: appending to LogRing, compared to the vector of
+// owning strings it replaced (which erased its older half at 500 entries),
+// and visiting the ring in place compared to copying that vector.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <vector>
+
+#include "LogRing.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kAppends = 2'000'000;
+constexpr int kVisits = 20'000;
+
+// The fixed-size part of a history entry, stored in place.
+struct RingEntry {
+    std::uint64_t seq = 0;
+    int level = 0;
+    std::int64_t time = 0;
+    std::array<wchar_t, 256> text{};
+};
+
+// What the history held before.
+struct OwningEntry {
+    int level = 0;
+    std::int64_t time = 0;
+    std::wstring text;
+};
+
+double NsPer(Clock::duration elapsed, int count)
+{
+    return std::chrono::duration<double, std::nano>(elapsed).count() / count;
+}
+
+const std::wstring& SampleText(int i)
+{
+    static const std::wstring texts[] = {
+        L"Mute Event: Workstation Lock start",
+        L"Muted 412 us after \"Workstation Lock\" arrived",
+        L"Skipping restore since mute event \"Display Standby\" is currently "
+        L"active",
+        L"Restoring previous mute state",
+    };
+    return texts[i % 4];
+}
+
+}  // namespace
+
+int main()
+{
+    std::size_t sink = 0;
+
+    LogRing<RingEntry> ring(1024);
+    auto start = Clock::now();
+    for (int i = 0; i < kAppends; ++i) {
+        const std::wstring& text = SampleText(i);
+        std::uint64_t seq = 0;
+        RingEntry& entry = ring.Append(seq);
+        entry.seq = seq;
+        entry.level = 1;
+        entry.time = i;
+        const std::size_t n = std::min(text.size(), entry.text.size() - 1);
+        std::wmemcpy(entry.text.data(), text.data(), n);
+        entry.text[n] = L'\0';
+    }
+    const double ringAppend = NsPer(Clock::now() - start, kAppends);
+
+    std::vector<OwningEntry> history;
+    start = Clock::now();
+    for (int i = 0; i < kAppends; ++i) {
+        if (history.size() >= 500) {
+            history.erase(history.begin(),
+                          history.begin() + history.size() / 2);
+        }
+        history.push_back(OwningEntry{1, i, SampleText(i)});
+    }
+    const double vectorAppend = NsPer(Clock::now() - start, kAppends);
+
+    start = Clock::now();
+    for (int i = 0; i < kVisits; ++i) {
+        ring.ForEach(ring.FirstSeq(), ring.EndSeq(),
+                     [&sink](std::uint64_t, const RingEntry& entry) {
+                         sink += static_cast<std::size_t>(entry.text[0]);
+                     });
+    }
+    const double ringVisit = NsPer(Clock::now() - start, kVisits);
+
+    start = Clock::now();
+    for (int i = 0; i < kVisits; ++i) {
+        const std::vector<OwningEntry> copy = history;
+        sink += copy.size();
+    }
+    const double vectorCopy = NsPer(Clock::now() - start, kVisits);
+
+    std::printf("append:   ring %8.1f ns   vector %8.1f ns\n", ringAppend,
+                vectorAppend);
+    std::printf("snapshot: ring visit of %zu %8.2f us   "
+                "vector copy of %zu %8.2f us\n",
+                ring.Size(), ringVisit / 1000, history.size(),
+                vectorCopy / 1000);
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Sequence numbers, wraparound and the range clamping of LogRing::ForEach.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Check.hpp"
+#include "LogRing.hpp"
+
+namespace {
+
+// Appends `count` entries whose value is their sequence number.
+void Fill(LogRing<std::uint64_t>& ring, std::uint64_t count)
+{
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t seq = 0;
+        std::uint64_t& entry = ring.Append(seq);
+        entry = seq;
+    }
+}
+
+std::vector<std::uint64_t> Collect(const LogRing<std::uint64_t>& ring,
+                                   std::uint64_t from, std::uint64_t to)
+{
+    std::vector<std::uint64_t> seen;
+    ring.ForEach(from, to, [&seen](std::uint64_t seq, std::uint64_t value) {
+        CHECK(seq == value);
+        seen.push_back(seq);
+    });
+    return seen;
+}
+
+void TestEmpty()
+{
+    LogRing<std::uint64_t> ring(4);
+    CHECK(ring.Size() == 0);
+    CHECK(ring.Capacity() == 4);
+    CHECK(ring.FirstSeq() == 0);
+    CHECK(ring.EndSeq() == 0);
+    CHECK(ring.Find(0) == nullptr);
+    CHECK(Collect(ring, 0, 100).empty());
+}
+
+void TestBeforeWraparound()
+{
+    LogRing<std::uint64_t> ring(4);
+    Fill(ring, 3);
+    CHECK(ring.Size() == 3);
+    CHECK(ring.FirstSeq() == 0);
+    CHECK(ring.EndSeq() == 3);
+    CHECK(ring.Find(2) != nullptr && *ring.Find(2) == 2);
+    CHECK(ring.Find(3) == nullptr);
+    CHECK((Collect(ring, 0, 3) == std::vector<std::uint64_t>{0, 1, 2}));
+    CHECK((Collect(ring, 1, 2) == std::vector<std::uint64_t>{1}));
+}
+
+void TestWraparound()
+{
+    LogRing<std::uint64_t> ring(4);
+    Fill(ring, 10);
+    CHECK(ring.Size() == 4);
+    CHECK(ring.FirstSeq() == 6);
+    CHECK(ring.EndSeq() == 10);
+    CHECK(ring.Find(5) == nullptr);
+    CHECK(ring.Find(6) != nullptr && *ring.Find(6) == 6);
+    CHECK(ring.Find(9) != nullptr && *ring.Find(9) == 9);
+    CHECK(ring.Find(10) == nullptr);
+}
+
+// Ranges reaching into overwritten or not yet appended entries are clamped.
+void TestForEachRanges()
+{
+    LogRing<std::uint64_t> ring(4);
+    Fill(ring, 10);
+    using Seqs = std::vector<std::uint64_t>;
+    CHECK((Collect(ring, 0, 100) == Seqs{6, 7, 8, 9}));
+    CHECK((Collect(ring, 0, 8) == Seqs{6, 7}));
+    CHECK((Collect(ring, 7, 9) == Seqs{7, 8}));
+    CHECK((Collect(ring, 9, 100) == Seqs{9}));
+    CHECK(Collect(ring, 10, 100).empty());
+    CHECK(Collect(ring, 0, 6).empty());
+    CHECK(Collect(ring, 8, 8).empty());
+    CHECK(Collect(ring, 9, 7).empty());
+}
+
+// A reader catching up with "everything after what I have seen" gets every
+// entry exactly once, as long as it does not fall behind by a full ring.
+void TestIncrementalReader()
+{
+    LogRing<std::uint64_t> ring(8);
+    std::uint64_t next = 0;
+    std::uint64_t expected = 0;
+    for (std::uint64_t batch = 1; batch <= 8; ++batch) {
+        Fill(ring, batch);
+        ring.ForEach(next, ring.EndSeq(), [&](std::uint64_t seq, auto) {
+            CHECK(seq == expected);
+            ++expected;
+        });
+        next = ring.EndSeq();
+    }
+    CHECK(expected == 36);
+
+    // Falling behind: the gap shows as FirstSeq() beyond what was seen.
+    Fill(ring, 20);
+    CHECK(ring.FirstSeq() > next);
+    CHECK(Collect(ring, next, ring.EndSeq()).front() == ring.FirstSeq());
+}
+
+}  // namespace
+
+int main()
+{
+    TestEmpty();
+    TestBeforeWraparound();
+    TestWraparound();
+    TestForEachRanges();
+    TestIncrementalReader();
+    return check::Result();
+}
@@ -0,0 +1,171 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Producer-side cost of handing a log message to the writer thread: pushes
+// onto MpscQueue as WMLog does (dropping when full) compared to a mutex
+// protected deque, with a consumer draining concurrently. Reports the
+// latency percentiles of a single push and the overall throughput.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MpscQueue.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kProducers = 4;
+constexpr int kPushesPerProducer = 200000;
+
+// Roughly what WMLog queues: a preformatted line and a few fields.
+struct Message {
+    std::wstring text;
+    int level = 0;
+    std::uint64_t time = 0;
+};
+
+class LockedQueue {
+   public:
+    bool TryPush(Message&& message)
+    {
+        const std::lock_guard lock(mutex_);
+        if (queue_.size() >= 1024) {
+            return false;
+        }
+        queue_.push_back(std::move(message));
+        return true;
+    }
+
+    bool TryPop(Message& message)
+    {
+        const std::lock_guard lock(mutex_);
+        if (queue_.empty()) {
+            return false;
+        }
+        message = std::move(queue_.front());
+        queue_.pop_front();
+        return true;
+    }
+
+   private:
+    std::mutex mutex_;
+    std::deque<Message> queue_;
+};
+
+template <typename Queue>
+void Run(const char* name)
+{
+    Queue queue;
+    std::atomic<bool> done{false};
+    std::atomic<int> dropped{0};
+    std::vector<std::vector<std::int64_t>> samples(kProducers);
+
+    std::thread consumer([&] {
+        Message message;
+        while (!done.load(std::memory_order_acquire)) {
+            while (queue.TryPop(message)) {
+            }
+            std::this_thread::yield();
+        }
+        while (queue.TryPop(message)) {
+        }
+    });
+
+    const auto start = Clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            auto& mine = samples[p];
+            mine.reserve(kPushesPerProducer);
+            const std::wstring text(80, L'x');
+            for (int i = 0; i < kPushesPerProducer; ++i) {
+                Message message{text, 1, static_cast<std::uint64_t>(i)};
+                const auto before = Clock::now();
+                const bool pushed = queue.TryPush(std::move(message));
+                const auto after = Clock::now();
+                if (!pushed) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                mine.push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        after - before)
+                        .count());
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    const auto elapsed = Clock::now() - start;
+    done.store(true, std::memory_order_release);
+    consumer.join();
+
+    std::vector<std::int64_t> all;
+    for (const auto& mine : samples) {
+        all.insert(all.end(), mine.begin(), mine.end());
+    }
+    std::sort(all.begin(), all.end());
+    const auto at = [&all](double p) {
+        return all[static_cast<std::size_t>(p * (all.size() - 1))];
+    };
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    std::printf("%-8s p50 %6lld ns  p99 %6lld ns  p99.9 %8lld ns  "
+                "max %9lld ns  %6.2f M/s  dropped %d\n",
+                name, static_cast<long long>(at(0.5)),
+                static_cast<long long>(at(0.99)),
+                static_cast<long long>(at(0.999)),
+                static_cast<long long>(all.back()),
+                static_cast<double>(all.size()) / seconds / 1e6,
+                dropped.load());
+}
+
+}  // namespace
+
+int main()
+{
+    std::printf("%d producers, %d pushes each\n", kProducers,
+                kPushesPerProducer);
+    Run<MpscQueue<Message, 1024>>("mpsc");
+    Run<LockedQueue>("mutex");
+    return 0;
+}
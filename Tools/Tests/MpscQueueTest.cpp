@@ -0,0 +1,141 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Several producers hammer a small queue while one consumer drains it: every
+// value must arrive exactly once and in the order its producer pushed it.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "MpscQueue.hpp"
+
+namespace {
+
+void TestSingleThreaded()
+{
+    MpscQueue<int, 4> queue;
+    int value = 0;
+    CHECK(!queue.TryPop(value));
+    for (int i = 0; i < 4; ++i) {
+        CHECK(queue.TryPush(i));
+    }
+    CHECK(!queue.TryPush(4));
+    CHECK(queue.TryPop(value) && value == 0);
+    CHECK(queue.TryPush(4));
+    for (int i = 1; i <= 4; ++i) {
+        CHECK(queue.TryPop(value) && value == i);
+    }
+    CHECK(!queue.TryPop(value));
+}
+
+// Wraps around the sequence numbers many times.
+void TestWraparound()
+{
+    MpscQueue<std::size_t, 2> queue;
+    for (std::size_t i = 0; i < 100000; ++i) {
+        std::size_t value = 0;
+        CHECK(queue.TryPush(i));
+        CHECK(queue.TryPush(i + 1));
+        CHECK(!queue.TryPush(i + 2));
+        CHECK(queue.TryPop(value) && value == i);
+        CHECK(queue.TryPop(value) && value == i + 1);
+    }
+}
+
+struct Tagged {
+    std::uint32_t producer = 0;
+    std::uint32_t seq = 0;
+};
+
+void TestConcurrentProducers()
+{
+    constexpr std::uint32_t kProducers = 4;
+    constexpr std::uint32_t kPerProducer = 200000;
+    MpscQueue<Tagged, 64> queue;
+    std::atomic<std::uint64_t> fullCount{0};
+    std::vector<std::thread> producers;
+    for (std::uint32_t p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, &fullCount, p] {
+            for (std::uint32_t i = 0; i < kPerProducer; ++i) {
+                while (!queue.TryPush(Tagged{p, i})) {
+                    fullCount.fetch_add(1, std::memory_order_relaxed);
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<std::uint32_t> next(kProducers, 0);
+    std::uint64_t received = 0;
+    bool ordered = true;
+    while (received < std::uint64_t{kProducers} * kPerProducer) {
+        Tagged value;
+        if (!queue.TryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value.producer >= kProducers ||
+            value.seq != next[value.producer]) {
+            ordered = false;
+            break;
+        }
+        ++next[value.producer];
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    CHECK(ordered);
+    for (const std::uint32_t n : next) {
+        CHECK(n == kPerProducer);
+    }
+    Tagged leftover;
+    CHECK(!queue.TryPop(leftover));
+    // With 64 cells and four producers the queue must have been full at
+    // some point, or the test did not exercise the full path.
+    CHECK(fullCount.load() > 0);
+}
+
+}  // namespace
+
+int main()
+{
+    TestSingleThreaded();
+    TestWraparound();
+    TestConcurrentProducers();
+    return check::Result();
+}
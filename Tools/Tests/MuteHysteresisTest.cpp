@@ -0,0 +1,302 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Drives rapid-fire event sequences through MuteHysteresis and RestoreScopes,
+// wired up the way MuteControl does it, against a fake audio backend that
+// counts the calls WinAudio would turn into COM calls.
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "Check.hpp"
+#include "MuteHysteresis.hpp"
+#include "RestoreScopes.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Ms = std::chrono::milliseconds;
+
+enum Event : std::size_t { Lock, Display, Lid, Count };
+
+struct FakeAudio {
+    int saves = 0;
+    int mutes = 0;
+    int restores = 0;
+
+    std::uint32_t SaveMuteStatus()
+    {
+        return static_cast<std::uint32_t>(++saves);
+    }
+
+    void SetMute(bool)
+    {
+        ++mutes;
+    }
+
+    void RestoreMuteStatus(std::uint32_t)
+    {
+        ++restores;
+    }
+
+    int Calls() const
+    {
+        return saves + mutes + restores;
+    }
+};
+
+// MuteControl::NotifyRestoreCondition and MuteDelayed, minus logging,
+// notifications and the snapshots taken ahead of time.
+class Model {
+   public:
+    explicit Model(Ms delay) : delay_(delay) {}
+
+    void Notify(Event event, bool active, Ms now)
+    {
+        Advance(now);
+        if (active) {
+            const auto action = hysteresis_.Start(event, mute_[event],
+                                                  delay_.count() != 0);
+            switch (action) {
+                case MuteHysteresis::StartAction::None:
+                    break;
+                case MuteHysteresis::StartAction::MuteNow:
+                    scopes_.Open(static_cast<Event>(event),
+                             [this] { return Save(); });
+                    audio_.SetMute(true);
+                    break;
+                case MuteHysteresis::StartAction::StartTimer:
+                    scopes_.Join(event);
+                    timer_ = now + delay_;
+                    ++timersStarted_;
+                    break;
+                case MuteHysteresis::StartAction::Join:
+                    scopes_.Join(event);
+                    break;
+            }
+            return;
+        }
+        const auto action = hysteresis_.End(event);
+        if (action == MuteHysteresis::EndAction::Ignored ||
+            action == MuteHysteresis::EndAction::NotMuted)
+        {
+            return;
+        }
+        if (action == MuteHysteresis::EndAction::CancelledPending) {
+            timer_.reset();
+        }
+        if (const auto snapshot = scopes_.Close(event)) {
+            audio_.RestoreMuteStatus(*snapshot);
+        }
+    }
+
+    // Runs the delay timer if it is due by `now`.
+    void Advance(Ms now)
+    {
+        if (timer_ && *timer_ <= now) {
+            timer_.reset();
+            hysteresis_.TakePending([this](std::size_t event) {
+                scopes_.Open(static_cast<Event>(event),
+                             [this] { return Save(); });
+            });
+            audio_.SetMute(true);
+        }
+    }
+
+    FakeAudio audio_;
+    bool mute_[Count] = {true, true, true};
+    int timersStarted_ = 0;
+    std::optional<Ms> timer_;
+    MuteHysteresis hysteresis_{Count};
+    RestoreScopes<Event, std::uint32_t> scopes_;
+
+   private:
+    std::uint32_t Save()
+    {
+        return audio_.SaveMuteStatus();
+    }
+
+    Ms delay_;
+};
+
+// Win+L and an immediate unlock.
+void TestBlipCostsNothing()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Notify(Lock, false, 200ms);
+    m.Advance(10s);
+    CHECK(m.audio_.Calls() == 0);
+    CHECK(!m.timer_);
+    CHECK(!m.hysteresis_.AnyMuted());
+    CHECK(m.scopes_.Empty());
+}
+
+void TestRapidFireCostsNothing()
+{
+    Model m(500ms);
+    Ms now = 0ms;
+    for (int i = 0; i < 1000; ++i) {
+        m.Notify(Lock, true, now);
+        m.Notify(Lock, false, now + 50ms);
+        now += 100ms;
+    }
+    m.Advance(now + 10s);
+    CHECK(m.audio_.Calls() == 0);
+    CHECK(m.timersStarted_ == 1000);
+}
+
+// A monitor flickering into standby while the workstation is locked and
+// unlocked again, all within the grace period.
+void TestOverlappingBlipsCostNothing()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Notify(Display, true, 100ms);
+    m.Notify(Lock, false, 200ms);
+    CHECK(m.timer_ == Ms(500));  // the display is still pending
+    m.Notify(Display, false, 300ms);
+    CHECK(!m.timer_);
+    m.Notify(Display, true, 400ms);
+    m.Notify(Display, false, 450ms);
+    m.Advance(10s);
+    CHECK(m.audio_.Calls() == 0);
+    CHECK(m.timersStarted_ == 2);
+}
+
+void TestLongEventMutesOnce()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Advance(499ms);
+    CHECK(m.audio_.Calls() == 0);
+    m.Advance(500ms);
+    CHECK(m.audio_.saves == 1);
+    CHECK(m.audio_.mutes == 1);
+    m.Notify(Lock, false, 5s);
+    CHECK(m.audio_.restores == 1);
+}
+
+// Events joining a pending mute do not restart the delay, and are muted and
+// restored together: one save, one mute, one restore.
+void TestOverlappingEventsMerge()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Notify(Display, true, 300ms);
+    m.Notify(Lid, true, 450ms);
+    CHECK(m.timersStarted_ == 1);
+    m.Advance(500ms);
+    CHECK(m.audio_.saves == 1);
+    CHECK(m.audio_.mutes == 1);
+    CHECK(m.scopes_.OpenScopes().size() == 3);
+
+    m.Notify(Lock, false, 1s);
+    m.Notify(Lid, false, 2s);
+    CHECK(m.audio_.restores == 0);
+    m.Notify(Display, false, 3s);
+    CHECK(m.audio_.restores == 1);
+    CHECK(m.audio_.Calls() == 3);
+}
+
+// An event that started later keeps the mute alive once the first one ended.
+void TestLaterEventKeepsTimer()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Notify(Display, true, 100ms);
+    m.Notify(Lock, false, 200ms);
+    m.Advance(500ms);
+    CHECK(m.audio_.saves == 1);
+    CHECK(m.audio_.mutes == 1);
+    CHECK(m.scopes_.IsOpen(Display));
+    CHECK(!m.scopes_.IsOpen(Lock));
+    m.Notify(Display, false, 1s);
+    CHECK(m.audio_.restores == 1);
+}
+
+// A blip while already muted joins the open scope and restores nothing.
+void TestBlipDuringMute()
+{
+    Model m(500ms);
+    m.Notify(Lock, true, 0ms);
+    m.Advance(500ms);
+    const int calls = m.audio_.Calls();
+    m.Notify(Display, true, 1s);
+    m.Notify(Display, false, 1100ms);
+    m.Advance(5s);
+    CHECK(m.audio_.Calls() == calls);
+    CHECK(m.scopes_.IsOpen(Lock));
+}
+
+void TestWithoutDelay()
+{
+    Model m(0ms);
+    m.Notify(Lock, true, 0ms);
+    CHECK(m.audio_.saves == 1);
+    CHECK(m.audio_.mutes == 1);
+    m.Notify(Lock, false, 10ms);
+    CHECK(m.audio_.restores == 1);
+    CHECK(m.timersStarted_ == 0);
+}
+
+void TestEventsThatDoNotMute()
+{
+    Model m(500ms);
+    m.mute_[Display] = false;
+    CHECK(m.hysteresis_.End(Lock) == MuteHysteresis::EndAction::Ignored);
+    m.Notify(Display, true, 0ms);
+    CHECK(m.hysteresis_.End(Display) == MuteHysteresis::EndAction::NotMuted);
+    m.Advance(10s);
+    CHECK(m.audio_.Calls() == 0);
+    CHECK(m.timersStarted_ == 0);
+}
+
+}  // namespace
+
+int main()
+{
+    TestBlipCostsNothing();
+    TestRapidFireCostsNothing();
+    TestOverlappingBlipsCostNothing();
+    TestLongEventMutesOnce();
+    TestOverlappingEventsMerge();
+    TestLaterEventKeepsTimer();
+    TestBlipDuringMute();
+    TestWithoutDelay();
+    TestEventsThatDoNotMute();
+    return check::Result();
+}
@@ -0,0 +1,147 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Time per mute decision with the compiled bitmaps, compared to evaluating
+// the rules one by one, for growing rule lists. Also times compiling them.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MuteRules.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr unsigned kConditionCount =
+    static_cast<unsigned>(MuteCondition::Count);
+constexpr int kLookups = 20'000'000;
+
+bool Evaluate(const std::vector<MuteRuleSet::Rule>& rules,
+              MuteCondition trigger, ConditionSet conditions)
+{
+    for (const auto& rule : rules) {
+        if (rule.trigger == trigger &&
+            (conditions & rule.required) == rule.required &&
+            (conditions & rule.forbidden) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::wstring RandomRules(std::size_t count, std::mt19937& rng)
+{
+    const wchar_t* triggers[] = {L"lock", L"remote", L"display", L"lid",
+                                 L"bluetooth"};
+    const wchar_t* conditions[] = {L"lock",      L"remote", L"display",
+                                   L"lid",       L"bluetooth", L"wlan",
+                                   L"quiethours"};
+    std::wstring text;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto t = rng() % 5;
+        text += triggers[t];
+        const auto c = rng() % kConditionCount;
+        if (c != t) {
+            text += (rng() % 2) ? L" & !" : L" & ";
+            text += conditions[c];
+        }
+        text += L";";
+    }
+    return text;
+}
+
+template <typename Decide>
+double NsPerLookup(const std::vector<std::uint32_t>& inputs, Decide decide)
+{
+    std::size_t muted = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < kLookups; ++i) {
+        const std::uint32_t input = inputs[i % inputs.size()];
+        const auto trigger = static_cast<MuteCondition>(input % 5);
+        const ConditionSet state = (input >> 8) | ConditionBit(trigger);
+        muted += decide(trigger, state) ? 1 : 0;
+    }
+    const auto elapsed = Clock::now() - start;
+    // Keeps the loop from being optimized away.
+    if (muted == static_cast<std::size_t>(-1)) {
+        std::puts("");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           kLookups;
+}
+
+}  // namespace
+
+int main()
+{
+    std::mt19937 rng(42);
+    std::vector<std::uint32_t> inputs(4096);
+    for (auto& input : inputs) {
+        input = static_cast<std::uint32_t>(rng() % 5) |
+                (static_cast<std::uint32_t>(rng() % (1u << kConditionCount))
+                 << 8);
+    }
+
+    std::printf("%6s %12s %12s %12s\n", "rules", "compile us", "bitmap ns",
+                "linear ns");
+    for (std::size_t count : {1, 4, 16, 64, 256}) {
+        const std::wstring text = RandomRules(count, rng);
+        std::wstring error;
+        const auto compileStart = Clock::now();
+        const auto set = MuteRuleSet::Compile(text, error);
+        const auto compileTime = Clock::now() - compileStart;
+        if (!set) {
+            std::fprintf(stderr, "Compile failed: %ls\n", error.c_str());
+            return 1;
+        }
+        const double bitmap =
+            NsPerLookup(inputs, [&](MuteCondition t, ConditionSet s) {
+                return set->ShouldMute(t, s);
+            });
+        const double linear =
+            NsPerLookup(inputs, [&](MuteCondition t, ConditionSet s) {
+                return Evaluate(set->GetRules(), t, s);
+            });
+        std::printf(
+            "%6zu %12.1f %12.2f %12.2f\n", count,
+            std::chrono::duration<double, std::micro>(compileTime).count(),
+            bitmap, linear);
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Checks the compiled rule bitmaps against a direct evaluation of the rules
+// for every condition set.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "MuteRules.hpp"
+
+namespace {
+
+constexpr ConditionSet kStateCount =
+    ConditionSet{1} << static_cast<unsigned>(MuteCondition::Count);
+
+constexpr ConditionSet Bit(MuteCondition c)
+{
+    return ConditionBit(c);
+}
+
+// What the compiled bitmaps must agree with: any rule of the trigger whose
+// required conditions are all set and forbidden ones all clear.
+bool Evaluate(const std::vector<MuteRuleSet::Rule>& rules,
+              MuteCondition trigger, ConditionSet conditions)
+{
+    for (const auto& rule : rules) {
+        if (rule.trigger == trigger &&
+            (conditions & rule.required) == rule.required &&
+            (conditions & rule.forbidden) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CheckAgainstEvaluate(const MuteRuleSet& set)
+{
+    for (std::size_t t = 0; t < static_cast<std::size_t>(MuteCondition::Count);
+         ++t) {
+        const auto trigger = static_cast<MuteCondition>(t);
+        for (ConditionSet state = 0; state < kStateCount; ++state) {
+            CHECK(set.ShouldMute(trigger, state) ==
+                  Evaluate(set.GetRules(), trigger, state));
+        }
+    }
+}
+
+void TestParse()
+{
+    std::wstring error;
+    const auto rule = MuteRuleSet::Parse(L" lock &!wlan & quiethours ", error);
+    CHECK(rule.has_value());
+    CHECK(rule->trigger == MuteCondition::WorkstationLocked);
+    CHECK(rule->required == (Bit(MuteCondition::WorkstationLocked) |
+                             Bit(MuteCondition::QuietHours)));
+    CHECK(rule->forbidden == Bit(MuteCondition::WlanConnected));
+    CHECK(MuteRuleSet::ToString(*rule) == L"lock & !wlan & quiethours");
+}
+
+void TestParseErrors()
+{
+    const wchar_t* invalid[] = {
+        L"",              // no trigger
+        L"lok",           // unknown name
+        L"!lock",         // negated trigger
+        L"wlan & lock",   // state, not an event
+        L"lock &",        // dangling '&'
+        L"lock & & lid",  // empty term
+        L"lock & lid & !lid",
+    };
+    for (const wchar_t* text : invalid) {
+        std::wstring error;
+        CHECK(!MuteRuleSet::Parse(text, error).has_value());
+        CHECK(!error.empty());
+    }
+}
+
+void TestCompile()
+{
+    std::wstring error;
+    const auto set = MuteRuleSet::Compile(
+        L"lock & !wlan; ; display & quiethours;lid", error);
+    CHECK(set.has_value());
+    CHECK(set->GetRules().size() == 3);
+    CHECK(set->HasRules(MuteCondition::WorkstationLocked));
+    CHECK(set->HasRules(MuteCondition::DisplayOff));
+    CHECK(set->HasRules(MuteCondition::LidClosed));
+    CHECK(!set->HasRules(MuteCondition::RemoteSession));
+    CHECK(set->GetUsedConditions() ==
+          (Bit(MuteCondition::WorkstationLocked) |
+           Bit(MuteCondition::WlanConnected) |
+           Bit(MuteCondition::DisplayOff) | Bit(MuteCondition::QuietHours) |
+           Bit(MuteCondition::LidClosed)));
+    CheckAgainstEvaluate(*set);
+
+    const ConditionSet lock = Bit(MuteCondition::WorkstationLocked);
+    const ConditionSet wlan = Bit(MuteCondition::WlanConnected);
+    CHECK(set->ShouldMute(MuteCondition::WorkstationLocked, lock));
+    CHECK(!set->ShouldMute(MuteCondition::WorkstationLocked, lock | wlan));
+
+    CHECK(!MuteRuleSet::Compile(L"lock; bogus", error).has_value());
+    CHECK(error.find(L"bogus") != std::wstring::npos);
+}
+
+void TestEmpty()
+{
+    std::wstring error;
+    const auto set = MuteRuleSet::Compile(L" ; ", error);
+    CHECK(set.has_value());
+    CHECK(set->GetRules().empty());
+    CHECK(set->GetUsedConditions() == 0);
+    CheckAgainstEvaluate(*set);
+}
+
+// Every rule one trigger can have with up to two further conditions, each
+// required or forbidden, compiled together and one by one.
+void TestAllSmallRules()
+{
+    const auto count = static_cast<std::size_t>(MuteCondition::Count);
+    MuteRuleSet all;
+    for (std::size_t t = 0; t < count; ++t) {
+        const auto trigger = static_cast<MuteCondition>(t);
+        if (!MuteRuleSet::IsTrigger(trigger)) {
+            continue;
+        }
+        for (std::size_t a = 0; a < count; ++a) {
+            for (std::size_t b = a; b < count; ++b) {
+                for (unsigned signs = 0; signs < 4; ++signs) {
+                    MuteRuleSet::Rule rule;
+                    rule.trigger = trigger;
+                    rule.required = Bit(trigger);
+                    const ConditionSet bitA =
+                        Bit(static_cast<MuteCondition>(a));
+                    const ConditionSet bitB =
+                        Bit(static_cast<MuteCondition>(b));
+                    ((signs & 1) ? rule.forbidden : rule.required) |= bitA;
+                    ((signs & 2) ? rule.forbidden : rule.required) |= bitB;
+                    if ((rule.required & rule.forbidden) != 0) {
+                        continue;
+                    }
+                    std::wstring error;
+                    const auto parsed = MuteRuleSet::Parse(
+                        MuteRuleSet::ToString(rule), error);
+                    CHECK(parsed.has_value());
+                    CHECK(parsed && parsed->required == rule.required &&
+                          parsed->forbidden == rule.forbidden);
+                    MuteRuleSet single;
+                    single.Add(rule);
+                    CheckAgainstEvaluate(single);
+                    all.Add(rule);
+                }
+            }
+        }
+    }
+    CheckAgainstEvaluate(all);
+}
+
+}  // namespace
+
+int main()
+{
+    TestParse();
+    TestParseErrors();
+    TestCompile();
+    TestEmpty();
+    TestAllSmallRules();
+    return check::Result();
+}
@@ -0,0 +1,327 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Enumerates every interleaving of workstation lock (immediate restore),
+// Bluetooth (delayed restore) and quiet hours (optionally forcing an unmute)
+// up to a fixed length, using RestoreScopes the way MuteControl does, and
+// checks the endpoints end up where they should after every step.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Check.hpp"
+#include "RestoreScopes.hpp"
+
+namespace {
+
+enum class Trigger { Lock, Bluetooth, QuietHours };
+
+struct Snapshot {
+    std::uint32_t generation = 0;
+    bool unmuteAll = false;
+};
+
+using Scopes = RestoreScopes<Trigger, Snapshot>;
+
+enum class Step {
+    LockStart,
+    LockEnd,
+    BluetoothDisconnect,
+    BluetoothReconnect,
+    BluetoothDelayElapsed,
+    QuietHoursStart,
+    QuietHoursEnd,
+    QuietHoursEndForceUnmute,
+    Count
+};
+
+// The parts of MuteControl that deal with scopes, and the endpoints as a
+// single mute flag.
+class World {
+   public:
+    explicit World(bool muted) : muted_(muted) {}
+
+    bool CanRun(Step step) const
+    {
+        switch (step) {
+            case Step::LockStart:
+                return !scopes_.IsOpen(Trigger::Lock);
+            case Step::LockEnd:
+                return scopes_.IsOpen(Trigger::Lock);
+            case Step::BluetoothDisconnect:
+                return !scopes_.IsOpen(Trigger::Bluetooth);
+            case Step::BluetoothReconnect:
+                return scopes_.IsOpen(Trigger::Bluetooth);
+            case Step::BluetoothDelayElapsed:
+                return pendingRestore_ != nullptr;
+            case Step::QuietHoursStart:
+                return !scopes_.IsOpen(Trigger::QuietHours);
+            case Step::QuietHoursEnd:
+            case Step::QuietHoursEndForceUnmute:
+                return scopes_.IsOpen(Trigger::QuietHours);
+            default:
+                return false;
+        }
+    }
+
+    // Runs `step` and checks the invariants. Returns false on a violation.
+    bool Run(Step step)
+    {
+        const bool wasIdle = Idle();
+        const bool mutedBefore = muted_;
+        switch (step) {
+            case Step::LockStart:
+                Open(Trigger::Lock);
+                break;
+            case Step::LockEnd:
+                Close(Trigger::Lock, false);
+                break;
+            case Step::BluetoothDisconnect:
+                Open(Trigger::Bluetooth);
+                break;
+            case Step::BluetoothReconnect:
+                Close(Trigger::Bluetooth, true);
+                break;
+            case Step::BluetoothDelayElapsed:
+                Restore(*std::exchange(pendingRestore_, nullptr));
+                break;
+            case Step::QuietHoursStart:
+                Open(Trigger::QuietHours);
+                break;
+            case Step::QuietHoursEnd:
+            case Step::QuietHoursEndForceUnmute:
+                Close(Trigger::QuietHours, false);
+                if (step == Step::QuietHoursEndForceUnmute) {
+                    forced_ = true;
+                    if (!scopes_.Amend([](Snapshot& s) { s.unmuteAll = true; }))
+                    {
+                        muted_ = false;
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+
+        if (wasIdle && !Idle()) {
+            userMuted_ = mutedBefore;
+            forced_ = step == Step::QuietHoursEndForceUnmute;
+            ++periodsStarted_;
+        } else if (!wasIdle && Idle()) {
+            ++periodsEnded_;
+            // Back to what the user had, unless quiet hours forced an unmute.
+            if (!CHECK(muted_ == (forced_ ? false : userMuted_))) {
+                return false;
+            }
+        }
+        // Muted for as long as any event is active.
+        if (!scopes_.Empty() && !CHECK(muted_)) {
+            return false;
+        }
+        // One save and one restore per period, never in between.
+        return CHECK(saves_ == periodsStarted_) &&
+               CHECK(restores_ == periodsEnded_);
+    }
+
+   private:
+    bool Idle() const
+    {
+        return scopes_.Empty() && pendingRestore_ == nullptr;
+    }
+
+    // MuteControl::TakeInheritableSnapshot: a new event cancels a pending
+    // Bluetooth restore and takes its snapshot over.
+    void Open(Trigger trigger)
+    {
+        scopes_.Open(
+            trigger, [this] { return Save(); },
+            std::exchange(pendingRestore_, nullptr));
+        muted_ = true;
+    }
+
+    void Close(Trigger trigger, bool withDelay)
+    {
+        auto snapshot = scopes_.Close(trigger);
+        if (snapshot == nullptr) {
+            return;
+        }
+        if (withDelay) {
+            pendingRestore_ = std::move(snapshot);
+        } else {
+            Restore(*snapshot);
+        }
+    }
+
+    Snapshot Save()
+    {
+        ++saves_;
+        saved_.push_back(muted_);
+        return Snapshot{static_cast<std::uint32_t>(saved_.size() - 1)};
+    }
+
+    void Restore(const Snapshot& snapshot)
+    {
+        ++restores_;
+        muted_ = snapshot.unmuteAll ? false : saved_.at(snapshot.generation);
+    }
+
+    bool muted_;
+    std::vector<bool> saved_;
+    Scopes scopes_;
+    Scopes::SnapshotPtr pendingRestore_;
+
+    bool userMuted_ = false;
+    bool forced_ = false;
+    int saves_ = 0;
+    int restores_ = 0;
+    int periodsStarted_ = 0;
+    int periodsEnded_ = 0;
+};
+
+constexpr int kMaxSteps = 12;
+
+std::size_t Explore(const World& world, int depth, std::vector<Step>& path)
+{
+    std::size_t sequences = 1;
+    if (depth == kMaxSteps) {
+        return sequences;
+    }
+    for (int s = 0; s < static_cast<int>(Step::Count); ++s) {
+        const auto step = static_cast<Step>(s);
+        if (!world.CanRun(step)) {
+            continue;
+        }
+        World next = world;
+        path.push_back(step);
+        if (!next.Run(step)) {
+            std::fprintf(stderr, "  after steps:");
+            for (const Step p : path) {
+                std::fprintf(stderr, " %d", static_cast<int>(p));
+            }
+            std::fprintf(stderr, "\n");
+            path.pop_back();
+            continue;
+        }
+        sequences += Explore(next, depth + 1, path);
+        path.pop_back();
+    }
+    return sequences;
+}
+
+void TestAllInterleavings()
+{
+    for (const bool userMuted : {false, true}) {
+        std::vector<Step> path;
+        const std::size_t sequences = Explore(World(userMuted), 0, path);
+        std::printf("%zu sequences of up to %d steps, user %s\n", sequences,
+                    kMaxSteps, userMuted ? "muted" : "unmuted");
+    }
+}
+
+void TestOpenClose()
+{
+    RestoreScopes<int, int> scopes;
+    int takes = 0;
+    const auto take = [&takes] { return ++takes; };
+    using Result = RestoreScopes<int, int>::OpenResult;
+
+    CHECK(!scopes.Join(1));
+    CHECK(scopes.Empty());
+    CHECK(scopes.Open(1, take) == Result::Taken);
+    CHECK(scopes.Open(1, take) == Result::AlreadyOpen);
+    CHECK(scopes.Open(2, take) == Result::Joined);
+    CHECK(scopes.Join(3));
+    CHECK(takes == 1);
+    CHECK((scopes.OpenScopes() == std::vector<int>{1, 2, 3}));
+
+    CHECK(scopes.Close(4) == nullptr);
+    CHECK(scopes.Close(1) == nullptr);
+    CHECK(scopes.Close(1) == nullptr);
+    CHECK(scopes.Close(3) == nullptr);
+    const auto snapshot = scopes.Close(2);
+    CHECK(snapshot != nullptr && *snapshot == 1);
+    CHECK(scopes.Empty());
+    CHECK(scopes.Current() == nullptr);
+}
+
+void TestInherit()
+{
+    RestoreScopes<int, int> scopes;
+    const auto never = [] {
+        CHECK(false);
+        return 0;
+    };
+    using Result = RestoreScopes<int, int>::OpenResult;
+    auto saved = std::make_shared<const int>(7);
+
+    CHECK(scopes.Open(1, never, saved) == Result::Inherited);
+    // Only the first scope inherits; later ones join.
+    CHECK(scopes.Open(2, never, std::make_shared<const int>(8)) ==
+          Result::Joined);
+    CHECK(scopes.Close(1) == nullptr);
+    CHECK(scopes.Close(2) == saved);
+
+    CHECK(scopes.Join(3, std::make_shared<const int>(9)));
+    CHECK(*scopes.Current() == 9);
+}
+
+void TestAmendIsCopyOnWrite()
+{
+    RestoreScopes<int, int> scopes;
+    CHECK(!scopes.Amend([](int& s) { s = 1; }));
+
+    scopes.Open(1, [] { return 10; });
+    const auto before = scopes.Current();
+    CHECK(scopes.Amend([](int& s) { s += 5; }));
+    CHECK(*before == 10);
+    CHECK(*scopes.Current() == 15);
+    scopes.Open(2, [] { return 0; });
+    CHECK(scopes.Close(1) == nullptr);
+    const auto snapshot = scopes.Close(2);
+    CHECK(snapshot != nullptr && *snapshot == 15);
+}
+
+}  // namespace
+
+int main()
+{
+    TestOpenClose();
+    TestInherit();
+    TestAmendIsCopyOnWrite();
+    TestAllInterleavings();
+    return check::Result();
+}
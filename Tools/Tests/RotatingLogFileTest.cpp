@@ -0,0 +1,325 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Batching and rotation policy of RotatingLogFile, driven by a fake clock
+// against a scratch directory.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "Check.hpp"
+#include "RotatingLogFile.hpp"
+
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace {
+
+using Clock = RotatingLogFile::Clock;
+
+const Clock::time_point kStart{};
+
+class ScratchDir {
+   public:
+    ScratchDir() : dir_(fs::temp_directory_path() / "winmute-rotating-log-")
+    {
+        dir_ += std::to_string(Clock::now().time_since_epoch().count());
+        fs::create_directories(dir_);
+    }
+    ~ScratchDir()
+    {
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+    }
+
+    fs::path Log() const
+    {
+        return dir_ / "test.log";
+    }
+
+    fs::path Rotated(int index) const
+    {
+        fs::path path = dir_ / "test.log.";
+        path += std::to_string(index);
+        return path;
+    }
+
+    std::string Read(const fs::path& path) const
+    {
+        std::ifstream in(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>()};
+    }
+
+    std::size_t FileCount() const
+    {
+        return static_cast<std::size_t>(
+            std::distance(fs::directory_iterator(dir_),
+                          fs::directory_iterator()));
+    }
+
+   private:
+    fs::path dir_;
+};
+
+// `length` bytes including the line break.
+std::string Line(std::size_t length, char c = 'x')
+{
+    std::string line(length, c);
+    line.back() = '\n';
+    return line;
+}
+
+RotatingLogFile::Policy SmallPolicy()
+{
+    RotatingLogFile::Policy policy;
+    policy.maxFileBytes = 100;
+    policy.maxFileAge = std::chrono::hours(1);
+    policy.retainedFiles = 2;
+    policy.bufferBytes = 40;
+    policy.commitInterval = 250ms;
+    return policy;
+}
+
+void TestCommitsAfterInterval()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    CHECK(file.Open(dir.Log(), kStart));
+    file.Append("a\n", false, kStart);
+    file.Append("b\n", false, kStart + 100ms);
+    CHECK(dir.Read(dir.Log()).empty());
+    CHECK(file.CommitDeadline() == kStart + 250ms);
+
+    file.CommitIfDue(kStart + 249ms);
+    CHECK(dir.Read(dir.Log()).empty());
+    file.CommitIfDue(kStart + 250ms);
+    CHECK(dir.Read(dir.Log()) == "a\nb\n");
+    CHECK(file.CommitDeadline() == Clock::time_point::max());
+    CHECK(file.GetCounters().commits == 1);
+    CHECK(file.GetCounters().records == 2);
+
+    // An append after the interval commits by itself.
+    file.Append("c\n", false, kStart + 1s);
+    file.Append("d\n", false, kStart + 1s + 300ms);
+    CHECK(dir.Read(dir.Log()) == "a\nb\nc\nd\n");
+}
+
+void TestCommitNowAndBufferFull()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    file.Open(dir.Log(), kStart);
+    file.Append("info\n", false, kStart);
+    file.Append("error\n", true, kStart);
+    CHECK(dir.Read(dir.Log()) == "info\nerror\n");
+
+    // 40 byte buffer: the third 15 byte record does not fit any more.
+    const std::string record = Line(15);
+    file.Append(record, false, kStart + 1ms);
+    file.Append(record, false, kStart + 2ms);
+    CHECK(dir.Read(dir.Log()).size() == 11);
+    file.Append(record, false, kStart + 3ms);
+    CHECK(dir.Read(dir.Log()).size() == 11 + 2 * record.size());
+
+    file.Close();
+    CHECK(dir.Read(dir.Log()).size() == 11 + 3 * record.size());
+    CHECK(file.GetCounters().failedWrites == 0);
+}
+
+void TestRotatesBySize()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    file.Open(dir.Log(), kStart);
+    const std::string record = Line(31);
+    for (int i = 0; i < 4; ++i) {
+        file.Append(record, true, kStart);
+    }
+    // 3 x 31 bytes fit into 100, the fourth starts a new file.
+    CHECK(dir.Read(dir.Rotated(1)).size() == 93);
+    CHECK(dir.Read(dir.Log()).size() == 31);
+    CHECK(file.GetCounters().rotations == 1);
+
+    // Records never straddle files, also when buffered.
+    for (int i = 0; i < 6; ++i) {
+        file.Append(record, false, kStart);
+    }
+    file.Commit();
+    for (const fs::path& path : {dir.Log(), dir.Rotated(1), dir.Rotated(2)}) {
+        CHECK(dir.Read(path).size() % 31 == 0);
+        CHECK(dir.Read(path).size() <= 100);
+    }
+}
+
+void TestRotatesByAge()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    file.Open(dir.Log(), kStart);
+    file.Append("old\n", true, kStart);
+    file.Append("new\n", true, kStart + 1h);
+    CHECK(dir.Read(dir.Rotated(1)) == "old\n");
+    CHECK(dir.Read(dir.Log()) == "new\n");
+}
+
+void TestRetention()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    file.Open(dir.Log(), kStart);
+    for (int i = 0; i < 10; ++i) {
+        file.Append(Line(61, static_cast<char>('0' + i)), true, kStart);
+    }
+    // The current file and two rotated ones, newest first.
+    CHECK(dir.FileCount() == 3);
+    CHECK(dir.Read(dir.Log()).front() == '9');
+    CHECK(dir.Read(dir.Rotated(1)).front() == '8');
+    CHECK(dir.Read(dir.Rotated(2)).front() == '7');
+    CHECK(file.GetCounters().rotations == 9);
+}
+
+void TestReopen()
+{
+    ScratchDir dir;
+    {
+        RotatingLogFile file;
+        file.SetPolicy(SmallPolicy());
+        file.Open(dir.Log(), kStart);
+        file.Append("first run\n", false, kStart);
+    }
+    RotatingLogFile file;
+    file.SetPolicy(SmallPolicy());
+    file.Open(dir.Log(), kStart);
+    file.Append("second run\n", true, kStart);
+    CHECK(dir.Read(dir.Log()) == "first run\nsecond run\n");
+    file.Close();
+
+    // A file already over the limit is rotated before it is used.
+    std::ofstream(dir.Log(), std::ios::app) << std::string(120, 'x');
+    file.Open(dir.Log(), kStart);
+    file.Append("fresh\n", true, kStart);
+    CHECK(dir.Read(dir.Log()) == "fresh\n");
+    CHECK(dir.Read(dir.Rotated(1)).size() == 141);
+}
+
+void TestRemove()
+{
+    ScratchDir dir;
+    {
+        RotatingLogFile file;
+        file.SetPolicy(SmallPolicy());
+        file.Open(dir.Log(), kStart);
+        for (int i = 0; i < 3; ++i) {
+            file.Append(Line(61), true, kStart);
+        }
+        CHECK(dir.FileCount() == 3);
+        file.Remove(dir.Log());
+        CHECK(!file.IsOpen());
+        CHECK(dir.FileCount() == 0);
+    }
+
+    // Left behind by an earlier run with more retained files, with a gap.
+    for (const int index : {2, 3, 7}) {
+        std::ofstream(dir.Rotated(index)) << "stale\n";
+    }
+    std::ofstream(dir.Log()) << "stale\n";
+    RotatingLogFile file;
+    file.Remove(dir.Log());
+    CHECK(dir.FileCount() == 0);
+
+    // Removing what does not exist creates nothing.
+    file.Remove(dir.Log());
+    CHECK(dir.FileCount() == 0);
+}
+
+// 100k records at 500 per second: the writes are batched and the disk use
+// stays bounded.
+void TestBurst()
+{
+    ScratchDir dir;
+    RotatingLogFile file;
+    RotatingLogFile::Policy policy;  // the defaults WMLog uses
+    file.SetPolicy(policy);
+    file.Open(dir.Log(), kStart);
+    const std::string record =
+        "2024-05-01 13:37:00.042+02:00  Info:  Mute Event: Workstation "
+        "Lock start\r\n";
+    auto now = kStart;
+    for (int i = 0; i < 100000; ++i) {
+        file.Append(record, false, now);
+        now += 2ms;
+    }
+    file.Close();
+    const auto& counters = file.GetCounters();
+    std::uintmax_t bytes = 0;
+    for (const auto& entry : fs::directory_iterator(dir.Log().parent_path())) {
+        bytes += entry.file_size();
+    }
+    std::printf("burst: %llu records in %llu writes (%.0f per write), "
+                "%llu rotations, %llu bytes on disk\n",
+                static_cast<unsigned long long>(counters.records),
+                static_cast<unsigned long long>(counters.commits),
+                static_cast<double>(counters.records) /
+                    static_cast<double>(counters.commits),
+                static_cast<unsigned long long>(counters.rotations),
+                static_cast<unsigned long long>(bytes));
+    CHECK(counters.records == 100000);
+    CHECK(counters.commits < counters.records / 100);
+    CHECK(bytes <= (policy.retainedFiles + 1) * policy.maxFileBytes);
+}
+
+}  // namespace
+
+int main()
+{
+    TestCommitsAfterInterval();
+    TestCommitNowAndBufferFull();
+    TestRotatesBySize();
+    TestRotatesByAge();
+    TestRetention();
+    TestReopen();
+    TestRemove();
+    TestBurst();
+    return check::Result();
+}
@@ -0,0 +1,210 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Formatting and the offset cache of TimestampFormatter, with a scripted
+// time zone in place of the system's.
+
+#include <chrono>
+#include <string>
+
+#include "Check.hpp"
+#include "TimestampFormatter.hpp"
+
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Formatter = TimestampFormatter;
+using TimePoint = Formatter::Clock::time_point;
+
+TimePoint Utc(year_month_day date, milliseconds timeOfDay = 0ms)
+{
+    return sys_days{date} + timeOfDay;
+}
+
+// Central European Time with the 2024 transitions, counting the lookups.
+struct Berlin {
+    static constexpr auto kSpring = 2024y / March / 31;
+    static constexpr auto kAutumn = 2024y / October / 27;
+
+    int lookups = 0;
+
+    Formatter::ZoneOffset operator()(TimePoint time)
+    {
+        ++lookups;
+        const TimePoint spring = Utc(kSpring, 1h);
+        const TimePoint autumn = Utc(kAutumn, 1h);
+        if (time < spring) {
+            return {1h, TimePoint::min(), spring};
+        } else if (time < autumn) {
+            return {2h, spring, autumn};
+        }
+        return {1h, autumn, TimePoint::max()};
+    }
+};
+
+// A fixed offset that is valid forever.
+struct Fixed {
+    seconds offset;
+    int lookups = 0;
+
+    Formatter::ZoneOffset operator()(TimePoint)
+    {
+        ++lookups;
+        return {offset};
+    }
+};
+
+std::wstring Format(Formatter& formatter, TimePoint time)
+{
+    std::wstring out;
+    formatter.FormatTo(out, time);
+    return out;
+}
+
+void TestFormat()
+{
+    Fixed zone{0s};
+    Formatter formatter(std::ref(zone));
+    std::wstring out = L"> ";
+    formatter.FormatTo(out, Utc(2024y / February / 29, 13h + 37min + 42ms));
+    CHECK(out == L"> 2024-02-29 13:37:00.042+00:00");
+    const auto lastMs = 23h + 59min + 59s + 999ms;
+    CHECK(Format(formatter, Utc(1999y / December / 31, lastMs)) ==
+          L"1999-12-31 23:59:59.999+00:00");
+    // Sub-millisecond parts are cut, not rounded.
+    CHECK(Format(formatter, Utc(2024y / May / 1) + 1999us) ==
+          L"2024-05-01 00:00:00.001+00:00");
+}
+
+void TestSpringForward()
+{
+    Berlin zone;
+    Formatter formatter(std::ref(zone));
+    const TimePoint change = Utc(Berlin::kSpring, 1h);
+    CHECK(Format(formatter, change - 1ms) == L"2024-03-31 01:59:59.999+01:00");
+    CHECK(Format(formatter, change) == L"2024-03-31 03:00:00.000+02:00");
+    CHECK(Format(formatter, change + 1ms) == L"2024-03-31 03:00:00.001+02:00");
+    CHECK(zone.lookups == 2);
+}
+
+// Local 02:00-03:00 happens twice; the cached second must not carry over
+// the earlier offset.
+void TestFallBack()
+{
+    Berlin zone;
+    Formatter formatter(std::ref(zone));
+    const TimePoint change = Utc(Berlin::kAutumn, 1h);
+    CHECK(Format(formatter, change - 30min) ==
+          L"2024-10-27 02:30:00.000+02:00");
+    CHECK(Format(formatter, change - 1ms) == L"2024-10-27 02:59:59.999+02:00");
+    CHECK(Format(formatter, change) == L"2024-10-27 02:00:00.000+01:00");
+    CHECK(Format(formatter, change + 30min) ==
+          L"2024-10-27 02:30:00.000+01:00");
+    CHECK(zone.lookups == 2);
+}
+
+void TestOffsetIsCached()
+{
+    Berlin zone;
+    Formatter formatter(std::ref(zone));
+    const TimePoint start = Utc(2024y / June / 1, 8h);
+    for (int i = 0; i < 3600; ++i) {
+        Format(formatter, start + seconds(i));
+    }
+    CHECK(zone.lookups == 1);
+    // Even a long-valid offset is looked up again after an hour, in case
+    // the time zone rules changed underneath.
+    Format(formatter, start + 1h);
+    CHECK(zone.lookups == 2);
+
+    // Going back before the cached range looks up again as well.
+    Format(formatter, Utc(2024y / January / 1));
+    CHECK(zone.lookups == 3);
+}
+
+void TestInvalidate()
+{
+    Fixed zone{1h};
+    Formatter formatter(std::ref(zone));
+    const TimePoint time = Utc(2024y / July / 1, 12h);
+    CHECK(Format(formatter, time) == L"2024-07-01 13:00:00.000+01:00");
+    // The user moved to another time zone.
+    zone.offset = -4h;
+    CHECK(Format(formatter, time) == L"2024-07-01 13:00:00.000+01:00");
+    formatter.Invalidate();
+    CHECK(Format(formatter, time) == L"2024-07-01 08:00:00.000-04:00");
+    CHECK(zone.lookups == 2);
+}
+
+void TestOffsets()
+{
+    struct Case {
+        seconds offset;
+        const wchar_t* expected;
+    };
+    const Case cases[] = {
+        {-5h, L"2024-01-01 07:00:00.000-05:00"},
+        {-(3h + 30min), L"2024-01-01 08:30:00.000-03:30"},
+        {-30min, L"2024-01-01 11:30:00.000-00:30"},
+        {5h + 30min, L"2024-01-01 17:30:00.000+05:30"},
+        {5h + 45min, L"2024-01-01 17:45:00.000+05:45"},
+        {14h, L"2024-01-02 02:00:00.000+14:00"},
+        {-12h, L"2024-01-01 00:00:00.000-12:00"},
+    };
+    for (const auto& c : cases) {
+        Fixed zone{c.offset};
+        Formatter formatter(std::ref(zone));
+        CHECK(Format(formatter, Utc(2024y / January / 1, 12h)) == c.expected);
+    }
+
+    // The local date rolls over with the offset.
+    Fixed zone{-(9h + 30min)};
+    Formatter formatter(std::ref(zone));
+    CHECK(Format(formatter, Utc(2024y / March / 1, 5h)) ==
+          L"2024-02-29 19:30:00.000-09:30");
+}
+
+}  // namespace
+
+int main()
+{
+    TestFormat();
+    TestSpringForward();
+    TestFallBack();
+    TestOffsetIsCached();
+    TestInvalidate();
+    TestOffsets();
+    return check::Result();
+}
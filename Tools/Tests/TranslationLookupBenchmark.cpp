@@ -0,0 +1,162 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Time per translation lookup, German loaded over English: by string key in
+// two std::maps (contains + find, fallback, copy under the language lock) as
+// GetTranslationW used to, by generated id with the copy under the lock, and
+// by id through the published table as it is now.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LanguageFiles.hpp"
+#include "TranslationTable.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kLookups = 10'000'000;
+
+using TranslationMap = std::map<std::string, std::wstring>;
+
+TranslationMap ToMap(const language_files::Entries& entries)
+{
+    TranslationMap map;
+    for (const auto& [key, text] : entries) {
+        map[key] = text;
+    }
+    return map;
+}
+
+// The lookup before texts had ids.
+std::wstring ByString(std::mutex& mutex, const TranslationMap& loaded,
+                      const TranslationMap& fallback, const std::string& key)
+{
+    std::wstring text;
+    const std::lock_guard lock(mutex);
+    if (!loaded.empty() && loaded.contains(key)) {
+        auto it = loaded.find(key);
+        if (it != loaded.end() && !it->second.empty()) {
+            text = it->second;
+        }
+    }
+    if (text.empty() && fallback.contains(key)) {
+        auto it = fallback.find(key);
+        if (it != fallback.cend() && !it->second.empty()) {
+            text = it->second;
+        }
+    }
+    return text;
+}
+
+template <typename Lookup>
+double NsPerLookup(const std::vector<std::size_t>& order, Lookup lookup)
+{
+    std::size_t chars = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < kLookups; ++i) {
+        chars += lookup(order[static_cast<std::size_t>(i) % order.size()]);
+    }
+    const auto elapsed = Clock::now() - start;
+    // Keeps the loop from being optimized away.
+    if (chars == 0) {
+        std::puts("no text");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           kLookups;
+}
+
+}  // namespace
+
+int main()
+{
+    const auto dir = language_files::Directory();
+    const auto english = language_files::Read(dir / "lang-en.json");
+    const auto german = language_files::Read(dir / "lang-de.json");
+
+    const TranslationMap englishMap = ToMap(english);
+    const TranslationMap germanMap = ToMap(german);
+
+    const TranslationTable englishTable = language_files::ToTable(english);
+    const TranslationTable germanTable = language_files::ToTable(german);
+    TranslationTable resolved;
+    std::array<std::wstring, static_cast<std::size_t>(TextId::Count)> copies;
+    for (std::size_t i = 0; i < copies.size(); ++i) {
+        const auto id = static_cast<TextId>(i);
+        const auto text = germanTable.Get(id).empty() ? englishTable.Get(id)
+                                                      : germanTable.Get(id);
+        resolved.Set(id, text);
+        copies[i] = text;
+    }
+    std::atomic<const TranslationTable*> published{&resolved};
+
+    // Every key in a fixed random order, as the dialogs ask for them.
+    std::vector<std::size_t> order(std::size(kTextKeys));
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    std::vector<std::string> keys;
+    for (const auto key : kTextKeys) {
+        keys.emplace_back(key);
+    }
+
+    std::mutex mutex;
+    const double byString = NsPerLookup(order, [&](std::size_t i) {
+        return ByString(mutex, germanMap, englishMap, keys[i]).size();
+    });
+    const double byIdCopy = NsPerLookup(order, [&](std::size_t i) {
+        const std::lock_guard lock(mutex);
+        return std::wstring(copies[i]).size();
+    });
+    const double byIdView = NsPerLookup(order, [&](std::size_t i) {
+        return published.load(std::memory_order_acquire)
+            ->Get(static_cast<TextId>(i))
+            .size();
+    });
+
+    std::printf("%zu keys, %d lookups each\n", order.size(), kLookups);
+    std::printf("  string key, two maps, copy:   %8.2f ns\n", byString);
+    std::printf("  id, locked copy:              %8.2f ns\n", byIdCopy);
+    std::printf("  id, published table, view:    %8.2f ns\n", byIdView);
+    return 0;
+}
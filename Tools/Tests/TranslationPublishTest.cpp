@@ -0,0 +1,215 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Translation tables, resolving and publishing them with concurrent readers:
+// threads look texts up without a lock while the language is switched, and
+// every text they see must belong to one of the languages, also when they
+// hold on to it across switches.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.hpp"
+#include "LanguageFiles.hpp"
+#include "TranslationTable.hpp"
+
+namespace {
+
+constexpr std::size_t kTextCount = static_cast<std::size_t>(TextId::Count);
+
+std::wstring Missing(std::string_view key)
+{
+    return L"missing " + language_files::Widen(key);
+}
+
+void TestResolve()
+{
+    TranslationTable defaults;
+    defaults.Set(TextId::log_title, L"Log");
+    defaults.Set(TextId::meta_lang_name, L"English");
+    TranslationTable strings;
+    strings.Set(TextId::meta_lang_name, L"Deutsch");
+
+    const auto texts = ResolveTranslations(strings, defaults, Missing);
+    CHECK(texts.Get(TextId::meta_lang_name) == L"Deutsch");
+    CHECK(texts.Get(TextId::log_title) == L"Log");
+    CHECK(texts.Get(TextId::log_column_time) == L"missing log.column.time");
+    for (std::size_t i = 0; i < kTextCount; ++i) {
+        CHECK(!texts.Get(static_cast<TextId>(i)).empty());
+    }
+}
+
+// Texts referenced in place, as from a mapped language pack, are never
+// copied on their way to the published table.
+void TestReferencedTexts()
+{
+    static const wchar_t kPack[] = L"Protokoll\0Deutsch";
+    const std::wstring_view title(kPack, 9);
+    TranslationTable strings;
+    CHECK(strings.Refer(TextId::log_title, title));
+    CHECK(strings.Refer(TextId::meta_lang_name, kPack + 10));
+    CHECK(!strings.Refer(TextId::log_title, title));
+    CHECK(!strings.Set(TextId::log_title, L"Log"));
+    CHECK(strings.GetChars() == 0);
+
+    TranslationTable defaults;
+    defaults.Set(TextId::log_title, L"Log");
+    defaults.Set(TextId::log_column_time, L"Time");
+    const auto texts = ResolveTranslations(strings, defaults, Missing);
+    CHECK(texts.Get(TextId::log_title).data() == kPack);
+    CHECK(texts.Get(TextId::meta_lang_name) == L"Deutsch");
+    CHECK(texts.Get(TextId::log_column_time) == L"Time");
+    CHECK(texts.Get(TextId::log_column_time).data() !=
+          defaults.Get(TextId::log_column_time).data());
+
+    // Equal texts are equal tables, wherever they are stored.
+    TranslationTable copied;
+    copied.Set(TextId::meta_lang_name, L"Deutsch");
+    copied.Set(TextId::log_title, L"Protokoll");
+    CHECK(copied == strings);
+    copied.Set(TextId::log_column_time, L"Zeit");
+    CHECK(!(copied == strings));
+}
+
+void TestPublishReusesTables()
+{
+    TranslationTable english;
+    english.Set(TextId::log_title, L"Log");
+    TranslationTable german;
+    german.Set(TextId::log_title, L"Protokoll");
+
+    PublishedTranslations published;
+    published.Publish(english);
+    const auto first = published.Get(TextId::log_title);
+    published.Publish(german);
+    CHECK(published.Get(TextId::log_title) == L"Protokoll");
+    for (int i = 0; i < 10; ++i) {
+        published.Publish(english);
+        published.Publish(german);
+    }
+    CHECK(published.GetTableCount() == 2);
+    published.Publish(english);
+    // The very same text, not just an equal one.
+    CHECK(published.Get(TextId::log_title).data() == first.data());
+    CHECK(first.data()[first.size()] == L'\0');
+}
+
+// Readers check every text against the languages the writer switches
+// between, and texts taken at the start again at the end.
+void TestConcurrentSwitches()
+{
+    const auto dir = language_files::Directory();
+    const auto defaults =
+        language_files::ToTable(language_files::Read(dir / "lang-en.json"));
+    std::vector<TranslationTable> languages;
+    languages.push_back(TranslationTable{});
+    for (const char* file : {"lang-de.json", "lang-fr.json", "lang-ru.json",
+                             "lang-zh_Hans.json"}) {
+        languages.push_back(ResolveTranslations(
+            language_files::ToTable(language_files::Read(dir / file)),
+            defaults, Missing));
+    }
+    languages[0] = ResolveTranslations(languages[0], defaults, Missing);
+
+    PublishedTranslations published;
+    published.Publish(languages[0]);
+
+    const unsigned readerCount =
+        std::max(2u, std::min(8u, std::thread::hardware_concurrency()));
+    std::atomic<bool> done{false};
+    std::atomic<std::uint64_t> lookups{0};
+    std::atomic<std::uint64_t> wrong{0};
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&, r] {
+            std::mt19937 rng(r);
+            std::vector<std::wstring_view> held;
+            for (std::size_t i = 0; i < kTextCount; ++i) {
+                held.push_back(published.Get(static_cast<TextId>(i)));
+            }
+            const std::vector<std::wstring> copies(held.begin(), held.end());
+            std::uint64_t count = 0;
+            std::uint64_t bad = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                const auto id = static_cast<TextId>(rng() % kTextCount);
+                const auto text = published.Get(id);
+                bool known = false;
+                for (const auto& language : languages) {
+                    known = known || language.Get(id) == text;
+                }
+                bad += known && text.data()[text.size()] == L'\0' ? 0 : 1;
+                ++count;
+            }
+            for (std::size_t i = 0; i < kTextCount; ++i) {
+                bad += held[i] == copies[i] ? 0 : 1;
+            }
+            lookups += count;
+            wrong += bad;
+        });
+    }
+
+    std::uint64_t switches = 0;
+    const auto end =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (std::chrono::steady_clock::now() < end) {
+        published.Publish(languages[switches % languages.size()]);
+        ++switches;
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::printf("%u readers, %llu switches, %llu lookups\n", readerCount,
+                static_cast<unsigned long long>(switches),
+                static_cast<unsigned long long>(lookups.load()));
+    CHECK(wrong == 0);
+    CHECK(lookups > 0);
+    CHECK(published.GetTableCount() == languages.size());
+}
+
+}  // namespace
+
+int main()
+{
+    TestResolve();
+    TestReferencedTexts();
+    TestPublishReusesTables();
+    TestConcurrentSwitches();
+    return check::Result();
+}
@@ -0,0 +1,275 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Heap allocations and lookup time of a translation table: English loaded as
+// the default, German on top, resolved into the table that is published.
+// Compares the array of one std::wstring per text that TranslationTable
+// replaced, the arena with its texts copied, and texts referenced in place
+// as from a mapped language pack. operator new is replaced to count.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "LanguageFiles.hpp"
+#include "TranslationTable.hpp"
+
+namespace {
+
+std::atomic<bool> counting{false};
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocatedBytes{0};
+
+}  // namespace
+
+// GCC sees the free() of memory from this operator new once it is inlined,
+// but not that both are replaced together.
+#if defined(__GNUC__) && !defined(__clang__)
+#    pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    if (counting.load(std::memory_order_relaxed)) {
+        ++allocations;
+        allocatedBytes += size;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kTextCount = static_cast<std::size_t>(TextId::Count);
+constexpr int kLookups = 20'000'000;
+
+using StringArray = std::array<std::wstring, kTextCount>;
+
+struct Allocations {
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+};
+
+template <typename Build>
+Allocations CountAllocations(Build build)
+{
+    allocations = 0;
+    allocatedBytes = 0;
+    counting = true;
+    build();
+    counting = false;
+    return {allocations.load(), allocatedBytes.load()};
+}
+
+std::wstring Missing(std::string_view key)
+{
+    return L"Translation for " + language_files::Widen(key) + L" not found";
+}
+
+// How WMi18n loaded and resolved languages before TranslationTable.
+StringArray LoadArray(const language_files::Entries& entries)
+{
+    StringArray texts;
+    for (const auto& [key, text] : entries) {
+        const TextId id = TextKey::Lookup(key);
+        if (id != TextId::Count) {
+            texts[static_cast<std::size_t>(id)] = text;
+        }
+    }
+    return texts;
+}
+
+StringArray ResolveArray(const StringArray& strings,
+                         const StringArray& defaults)
+{
+    StringArray texts;
+    for (std::size_t i = 0; i < kTextCount; ++i) {
+        if (!strings[i].empty()) {
+            texts[i] = strings[i];
+        } else if (!defaults[i].empty()) {
+            texts[i] = defaults[i];
+        } else {
+            texts[i] = Missing(kTextKeys[i]);
+        }
+    }
+    return texts;
+}
+
+// Like ReadLanguageFile, which reserves the size of the JSON file.
+TranslationTable LoadArena(const language_files::Entries& entries,
+                           std::size_t reserve)
+{
+    TranslationTable table;
+    table.Reserve(reserve);
+    for (const auto& [key, text] : entries) {
+        const TextId id = TextKey::Lookup(key);
+        if (id != TextId::Count && !text.empty()) {
+            table.Set(id, text);
+        }
+    }
+    return table;
+}
+
+// Where each text starts in a pack.
+using PackIndex = std::vector<std::pair<TextId, std::size_t>>;
+
+// The texts one after the other, each followed by a 0, as in a language
+// pack; `ids` receives the id of each text.
+std::wstring PackTexts(const language_files::Entries& entries, PackIndex& ids)
+{
+    std::wstring pack;
+    for (const auto& [key, text] : entries) {
+        const TextId id = TextKey::Lookup(key);
+        if (id != TextId::Count && !text.empty()) {
+            ids.emplace_back(id, pack.size());
+            pack += text;
+            pack += L'\0';
+        }
+    }
+    return pack;
+}
+
+TranslationTable ReferPack(const std::wstring& pack, const PackIndex& ids)
+{
+    TranslationTable table;
+    for (const auto& [id, offset] : ids) {
+        table.Refer(id, pack.data() + offset);
+    }
+    return table;
+}
+
+template <typename Get>
+double NsPerLookup(const std::vector<TextId>& order, Get get)
+{
+    std::size_t chars = 0;
+    const auto start = Clock::now();
+    for (int i = 0; i < kLookups; ++i) {
+        chars += get(order[static_cast<std::size_t>(i) % order.size()]).size();
+    }
+    const auto elapsed = Clock::now() - start;
+    // Keeps the loop from being optimized away.
+    if (chars == 0) {
+        std::puts("no text");
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           kLookups;
+}
+
+}  // namespace
+
+int main()
+{
+    const auto dir = language_files::Directory();
+    const auto english = language_files::Read(dir / "lang-en.json");
+    const auto german = language_files::Read(dir / "lang-de.json");
+    const auto englishSize = std::filesystem::file_size(dir / "lang-en.json");
+    const auto germanSize = std::filesystem::file_size(dir / "lang-de.json");
+
+    PackIndex englishIds;
+    PackIndex germanIds;
+    const std::wstring englishPack = PackTexts(english, englishIds);
+    const std::wstring germanPack = PackTexts(german, germanIds);
+
+    StringArray array;
+    TranslationTable arena;
+    TranslationTable referenced;
+    const auto arrayCost = CountAllocations([&] {
+        const auto defaults = LoadArray(english);
+        array = ResolveArray(LoadArray(german), defaults);
+    });
+    const auto arenaCost = CountAllocations([&] {
+        const auto defaults = LoadArena(english, englishSize);
+        arena = ResolveTranslations(LoadArena(german, germanSize), defaults,
+                                    Missing);
+    });
+    const auto referencedCost = CountAllocations([&] {
+        const auto defaults = ReferPack(englishPack, englishIds);
+        referenced = ResolveTranslations(ReferPack(germanPack, germanIds),
+                                         defaults, Missing);
+    });
+
+    bool same = arena == referenced;
+    for (std::size_t i = 0; i < kTextCount; ++i) {
+        same = same && arena.Get(static_cast<TextId>(i)) == array[i];
+    }
+
+    std::vector<TextId> order(kTextCount);
+    for (std::size_t i = 0; i < kTextCount; ++i) {
+        order[i] = static_cast<TextId>(i);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    const double arrayNs = NsPerLookup(order, [&](TextId id) {
+        return std::wstring_view(array[static_cast<std::size_t>(id)]);
+    });
+    const double arenaNs =
+        NsPerLookup(order, [&](TextId id) { return arena.Get(id); });
+    const double referencedNs =
+        NsPerLookup(order, [&](TextId id) { return referenced.Get(id); });
+
+    std::printf("%zu texts, lang-de over lang-en, loaded and resolved\n",
+                kTextCount);
+    std::printf("  %-22s %12s %12s %12s\n", "table", "allocations", "bytes",
+                "lookup ns");
+    std::printf("  %-22s %12zu %12zu %12.2f\n", "array of wstrings",
+                arrayCost.count, arrayCost.bytes, arrayNs);
+    std::printf("  %-22s %12zu %12zu %12.2f\n", "arena, copied",
+                arenaCost.count, arenaCost.bytes, arenaNs);
+    std::printf("  %-22s %12zu %12zu %12.2f\n", "arena, referenced",
+                referencedCost.count, referencedCost.bytes, referencedNs);
+    if (!same) {
+        std::printf("The tables differ\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,686 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+// Checks WinMute's language files against the default language file,
+// lang-en.json. Builds on any platform with a C++20 compiler, see
+// CMakeLists.txt.
+//
+//   TranslationChecker [--strict] [--jobs N] [--reference <file>]
+//                      <file or directory>...
+//
+// Directories are searched for lang-*.json files; the reference defaults to
+// the lang-en.json among them. The files are read, parsed and converted to
+// UTF-16 on several threads, and the time each step took is reported per file.
+//
+// Errors are what breaks a language at runtime or at build time: duplicate
+// keys, nested elements, values that are not strings, keys not of the form
+// a.b-c, invalid format strings and texts that take more format arguments than
+// the reference text (SafeVFormat then shows the unformatted text). Warnings
+// are what falls back to English or loses information: missing or empty
+// texts, keys the reference does not have and texts that take fewer format
+// arguments. Exits with 1 if there are errors, with --strict also on warnings.
+//
+//   TranslationChecker --benchmark-scan [--runs N] <directory>
+//
+// Times how WinMute's GetAvailableLanguages finds the language names in a
+// directory instead: parsing every file into a DOM, as it used to, reading
+// each file only up to its name, and the rescan of unchanged files that the
+// name cache answers without opening them.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "LanguageNameReader.hpp"
+#include "libs/json.hpp"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Entry {
+    std::string key;
+    std::string text;
+};
+
+struct LangFile {
+    fs::path path;
+    // Top level string entries in file order, duplicates included.
+    std::vector<Entry> entries;
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+    // False if the file could not be read to the end.
+    bool complete = false;
+    std::size_t utf16Units = 0;
+    Clock::duration readTime{};
+    Clock::duration parseTime{};
+    Clock::duration convertTime{};
+};
+
+// Collects the top level entries. Unlike a DOM parse this sees duplicate keys,
+// and it does not stop at the first nested element or non-string value.
+class EntryReader : public nlohmann::json_sax<json> {
+   public:
+    explicit EntryReader(LangFile& file) : file_(file)
+    {
+    }
+
+    bool null() override
+    {
+        return Value("null");
+    }
+    bool boolean(bool) override
+    {
+        return Value("a boolean");
+    }
+    bool number_integer(number_integer_t) override
+    {
+        return Value("a number");
+    }
+    bool number_unsigned(number_unsigned_t) override
+    {
+        return Value("a number");
+    }
+    bool number_float(number_float_t, const string_t&) override
+    {
+        return Value("a number");
+    }
+    bool string(string_t& val) override
+    {
+        if (depth_ == 0) {
+            return NotAnObject();
+        }
+        if (depth_ == 1) {
+            file_.entries.push_back({key_, std::move(val)});
+        }
+        return true;
+    }
+    bool binary(binary_t&) override
+    {
+        return Value("binary");
+    }
+    bool start_object(std::size_t) override
+    {
+        Nest("a nested object");
+        return true;
+    }
+    bool end_object() override
+    {
+        --depth_;
+        return true;
+    }
+    bool start_array(std::size_t) override
+    {
+        if (depth_ == 0) {
+            return NotAnObject();
+        }
+        Nest("an array");
+        return true;
+    }
+    bool end_array() override
+    {
+        --depth_;
+        return true;
+    }
+    bool key(string_t& val) override
+    {
+        if (depth_ == 1) {
+            key_ = val;
+        }
+        return true;
+    }
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& ex) override
+    {
+        file_.errors.push_back(ex.what());
+        return false;
+    }
+
+   private:
+    bool NotAnObject()
+    {
+        file_.errors.push_back("The file is not a JSON object");
+        return false;
+    }
+
+    bool Value(const char* what)
+    {
+        if (depth_ == 0) {
+            return NotAnObject();
+        }
+        if (depth_ == 1) {
+            file_.errors.push_back("\"" + key_ + "\" is " + what +
+                                   ", not a string");
+        }
+        return true;
+    }
+
+    void Nest(const char* what)
+    {
+        if (depth_ == 1) {
+            file_.errors.push_back("\"" + key_ + "\" is " + what);
+        }
+        ++depth_;
+    }
+
+    LangFile& file_;
+    std::string key_;
+    int depth_ = 0;
+};
+
+// Like ConvertStringToWideString in WinMute. The parser has already rejected
+// invalid UTF-8.
+std::u16string ToUtf16(const std::string& text)
+{
+    std::u16string result;
+    result.reserve(text.size());
+    for (std::size_t i = 0; i < text.size();) {
+        const auto lead = static_cast<unsigned char>(text[i]);
+        const int length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3
+                                                                          : 4;
+        char32_t cp = length == 1   ? lead
+                      : length == 2 ? lead & 0x1F
+                      : length == 3 ? lead & 0x0F
+                                    : lead & 0x07;
+        for (int j = 1; j < length && i + j < text.size(); ++j) {
+            cp = (cp << 6) | (static_cast<unsigned char>(text[i + j]) & 0x3F);
+        }
+        i += length;
+        if (cp < 0x10000) {
+            result.push_back(static_cast<char16_t>(cp));
+        } else {
+            cp -= 0x10000;
+            result.push_back(static_cast<char16_t>(0xD800 + (cp >> 10)));
+            result.push_back(static_cast<char16_t>(0xDC00 + (cp & 0x3FF)));
+        }
+    }
+    return result;
+}
+
+void LoadFile(LangFile& file)
+{
+    auto start = Clock::now();
+    std::string content;
+    {
+        std::ifstream in(file.path, std::ios::binary);
+        if (!in) {
+            file.errors.push_back("Cannot open the file");
+            return;
+        }
+        content.assign(std::istreambuf_iterator<char>(in),
+                       std::istreambuf_iterator<char>());
+    }
+    auto end = Clock::now();
+    file.readTime = end - start;
+
+    start = end;
+    EntryReader reader(file);
+    file.complete = json::sax_parse(content, &reader);
+    end = Clock::now();
+    file.parseTime = end - start;
+
+    start = end;
+    for (const auto& entry : file.entries) {
+        file.utf16Units += ToUtf16(entry.text).size();
+    }
+    file.convertTime = Clock::now() - start;
+}
+
+// Whether WinMute and BuildLanguagePacks.ps1 accept `key`: [a-z][a-z0-9._-]*
+bool IsValidKey(const std::string& key)
+{
+    if (key.empty() || key[0] < 'a' || key[0] > 'z') {
+        return false;
+    }
+    return std::all_of(key.begin(), key.end(), [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' ||
+               c == '_' || c == '-';
+    });
+}
+
+// Returns how many arguments std::format needs for `text`, or nothing if
+// `text` is not a valid format string.
+std::optional<std::size_t> CountFormatArgs(std::string_view text)
+{
+    std::size_t autoArgs = 0;
+    std::size_t manualArgs = 0;
+    const auto useArg = [&](std::string_view id) {
+        if (id.empty()) {
+            ++autoArgs;
+            return manualArgs == 0;
+        }
+        if (id.size() > 3 || (id.size() > 1 && id[0] == '0') ||
+            id.find_first_not_of("0123456789") != std::string_view::npos)
+        {
+            return false;
+        }
+        const std::size_t index = std::stoul(std::string(id));
+        manualArgs = std::max(manualArgs, index + 1);
+        return autoArgs == 0;
+    };
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '}') {
+            if (i + 1 < text.size() && text[i + 1] == '}') {
+                ++i;
+                continue;
+            }
+            return std::nullopt;
+        }
+        if (text[i] != '{') {
+            continue;
+        }
+        if (i + 1 < text.size() && text[i + 1] == '{') {
+            ++i;
+            continue;
+        }
+        // {arg-id:format-spec}, where the spec may take a width or precision
+        // from a nested {arg-id}.
+        const auto idEnd = text.find_first_of(":}", i + 1);
+        if (idEnd == std::string_view::npos ||
+            !useArg(text.substr(i + 1, idEnd - i - 1)))
+        {
+            return std::nullopt;
+        }
+        i = idEnd;
+        if (text[i] == ':') {
+            for (++i; i < text.size() && text[i] != '}'; ++i) {
+                if (text[i] == '{') {
+                    const auto nestedEnd = text.find('}', i + 1);
+                    if (nestedEnd == std::string_view::npos ||
+                        !useArg(text.substr(i + 1, nestedEnd - i - 1)))
+                    {
+                        return std::nullopt;
+                    }
+                    i = nestedEnd;
+                }
+            }
+            if (i == text.size()) {
+                return std::nullopt;
+            }
+        }
+    }
+    return manualArgs != 0 ? manualArgs : autoArgs;
+}
+
+// Checks what does not need the reference. Returns the first text of every
+// key, for looking them up.
+std::map<std::string, const std::string*> CheckEntries(LangFile& file)
+{
+    std::map<std::string, const std::string*> texts;
+    for (const auto& entry : file.entries) {
+        if (!IsValidKey(entry.key)) {
+            file.errors.push_back("\"" + entry.key +
+                                  "\" is not of the form a.b-c");
+        }
+        if (!texts.emplace(entry.key, &entry.text).second) {
+            file.errors.push_back("\"" + entry.key + "\" is defined twice");
+        }
+    }
+    return texts;
+}
+
+// Returns the number of format arguments of every text of the reference.
+std::map<std::string, std::size_t> CheckReference(LangFile& file)
+{
+    std::map<std::string, std::size_t> args;
+    for (const auto& [key, text] : CheckEntries(file)) {
+        if (text->empty()) {
+            file.errors.push_back("\"" + key + "\" is empty");
+        }
+        const auto count = CountFormatArgs(*text);
+        if (!count) {
+            file.errors.push_back("\"" + key +
+                                  "\" is not a valid format string");
+        }
+        args.emplace(key, count.value_or(0));
+    }
+    return args;
+}
+
+void CheckTranslation(LangFile& file,
+                      const std::map<std::string, std::size_t>& referenceArgs)
+{
+    const auto texts = CheckEntries(file);
+    if (!file.complete) {
+        return;
+    }
+    for (const auto& [key, args] : referenceArgs) {
+        const auto it = texts.find(key);
+        if (it == texts.end()) {
+            file.warnings.push_back("\"" + key + "\" is missing");
+            continue;
+        }
+        const std::string& text = *it->second;
+        if (text.empty()) {
+            file.warnings.push_back("\"" + key + "\" is empty");
+            continue;
+        }
+        // Surplus arguments are ignored by std::format, missing ones make
+        // SafeVFormat fall back to the unformatted text.
+        const auto count = CountFormatArgs(text);
+        if (!count) {
+            file.errors.push_back("\"" + key +
+                                  "\" is not a valid format string");
+        } else if (*count > args) {
+            file.errors.push_back(
+                "\"" + key + "\" takes " + std::to_string(*count) +
+                " argument(s), the reference only " + std::to_string(args));
+        } else if (*count < args) {
+            file.warnings.push_back(
+                "\"" + key + "\" takes " + std::to_string(*count) +
+                " argument(s), the reference " + std::to_string(args));
+        }
+    }
+    for (const auto& [key, text] : texts) {
+        if (IsValidKey(key) && referenceArgs.count(key) == 0) {
+            file.warnings.push_back("\"" + key +
+                                    "\" is unknown and will be ignored");
+        }
+    }
+}
+
+long long Micros(Clock::duration d)
+{
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+void PrintFile(const LangFile& file)
+{
+    if (file.errors.empty() && file.warnings.empty()) {
+        return;
+    }
+    std::printf("%s: %zu error(s), %zu warning(s)\n",
+                file.path.filename().string().c_str(), file.errors.size(),
+                file.warnings.size());
+    for (const auto& error : file.errors) {
+        std::printf("  error: %s\n", error.c_str());
+    }
+    for (const auto& warning : file.warnings) {
+        std::printf("  warning: %s\n", warning.c_str());
+    }
+}
+
+bool IsLanguageFile(const fs::path& path)
+{
+    return path.extension() == ".json" &&
+           path.filename().string().rfind("lang-", 0) == 0;
+}
+
+// The language names in `dir` as GetAvailableLanguages finds them, by file
+// name. Like FindFirstFileExW with "*.json", this lists every JSON file.
+class LanguageScanner {
+   public:
+    enum class Mode { Dom, NameOnly, Cached };
+
+    explicit LanguageScanner(Mode mode) : mode_(mode) {}
+
+    std::map<std::string, std::string> Scan(const fs::path& dir)
+    {
+        std::map<std::string, std::string> names;
+        std::map<std::string, Scanned> scanned;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end;
+             it.increment(ec))
+        {
+            if (it->path().extension() != ".json") {
+                continue;
+            }
+            const auto fileName = it->path().filename().string();
+            Scanned file;
+            file.size = it->file_size(ec);
+            file.writeTime = it->last_write_time(ec);
+            const auto known = scanned_.find(fileName);
+            if (mode_ == Mode::Cached && known != scanned_.end() &&
+                known->second.size == file.size &&
+                known->second.writeTime == file.writeTime)
+            {
+                file.name = known->second.name;
+            } else {
+                file.name = ReadName(it->path());
+            }
+            if (!file.name.empty()) {
+                names.emplace(fileName, file.name);
+            }
+            scanned.emplace(fileName, std::move(file));
+        }
+        scanned_ = std::move(scanned);
+        return names;
+    }
+
+   private:
+    struct Scanned {
+        std::uintmax_t size = 0;
+        fs::file_time_type writeTime;
+        std::string name;
+    };
+
+    std::string ReadName(const fs::path& path) const
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (mode_ == Mode::Dom) {
+            const auto data = json::parse(in, nullptr, false);
+            const auto it = data.is_object() ? data.find("meta.lang.name")
+                                             : data.end();
+            return it != data.end() && it->is_string() ? it->get<std::string>()
+                                                       : std::string();
+        }
+        LanguageNameReader reader;
+        json::sax_parse(in, &reader);
+        return reader.name.value_or(std::string());
+    }
+
+    Mode mode_;
+    std::map<std::string, Scanned> scanned_;
+};
+
+int BenchmarkScan(const fs::path& dir, int runs)
+{
+    using Mode = LanguageScanner::Mode;
+    const std::pair<Mode, const char*> modes[] = {
+        {Mode::Dom, "DOM parse"},
+        {Mode::NameOnly, "read up to the name"},
+        {Mode::Cached, "name cache, unchanged"}};
+    std::map<std::string, std::string> expected;
+    bool same = true;
+    std::printf("  %-24s %8s %12s\n", "scan", "files", "us per scan");
+    for (const auto& [mode, label] : modes) {
+        LanguageScanner scanner(mode);
+        // The cache is filled by the first scan; that one is not timed.
+        auto names = scanner.Scan(dir);
+        const auto start = Clock::now();
+        for (int i = 0; i < runs; ++i) {
+            names = scanner.Scan(dir);
+        }
+        const auto elapsed = Clock::now() - start;
+        if (mode == Mode::Dom) {
+            expected = names;
+        }
+        same = same && names == expected;
+        std::printf("  %-24s %8zu %12.1f\n", label, names.size(),
+                    std::chrono::duration<double, std::micro>(elapsed).count() /
+                        runs);
+    }
+    if (!same) {
+        std::printf("The scans found different language names\n");
+        return 1;
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc >= 2 && std::string_view(argv[1]) == "--benchmark-scan") {
+        int runs = 200;
+        int arg = 2;
+        if (arg + 1 < argc && std::string_view(argv[arg]) == "--runs") {
+            runs = std::max(1, std::atoi(argv[arg + 1]));
+            arg += 2;
+        }
+        if (arg + 1 != argc) {
+            std::fprintf(stderr,
+                         "Usage: %s --benchmark-scan [--runs N] <directory>\n",
+                         argv[0]);
+            return 2;
+        }
+        return BenchmarkScan(argv[arg], runs);
+    }
+
+    bool strict = false;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    fs::path referencePath;
+    std::vector<fs::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--strict") {
+            strict = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--reference" && i + 1 < argc) {
+            referencePath = argv[++i];
+        } else {
+            inputs.emplace_back(arg);
+        }
+    }
+    if (inputs.empty()) {
+        std::fprintf(stderr,
+                     "Usage: %s [--strict] [--jobs N] [--reference <file>] "
+                     "<file or directory>...\n",
+                     argv[0]);
+        return 2;
+    }
+
+    std::vector<fs::path> paths;
+    for (const auto& input : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            for (fs::directory_iterator it(input, ec), end; !ec && it != end;
+                 it.increment(ec))
+            {
+                if (it->is_regular_file(ec) && IsLanguageFile(it->path())) {
+                    paths.push_back(it->path());
+                }
+            }
+        } else {
+            paths.push_back(input);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    if (referencePath.empty()) {
+        const auto it =
+            std::find_if(paths.begin(), paths.end(), [](const fs::path& p) {
+                return p.filename() == "lang-en.json";
+            });
+        if (it == paths.end()) {
+            std::fprintf(stderr, "No lang-en.json given, use --reference\n");
+            return 2;
+        }
+        referencePath = *it;
+    }
+    std::error_code ec;
+    const auto isReference = [&](const fs::path& p) {
+        return fs::equivalent(p, referencePath, ec);
+    };
+    paths.erase(std::remove_if(paths.begin(), paths.end(), isReference),
+                paths.end());
+    paths.insert(paths.begin(), referencePath);
+
+    std::vector<LangFile> files(paths.size());
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        files[i].path = paths[i];
+    }
+    jobs = std::min<unsigned>(jobs, static_cast<unsigned>(files.size()));
+    const auto start = Clock::now();
+    {
+        std::atomic<std::size_t> next{0};
+        std::vector<std::jthread> workers;
+        for (unsigned i = 0; i < jobs; ++i) {
+            workers.emplace_back([&] {
+                for (auto n = next++; n < files.size(); n = next++) {
+                    LoadFile(files[n]);
+                }
+            });
+        }
+    }
+    const auto loadTime = Clock::now() - start;
+
+    const auto referenceArgs = CheckReference(files[0]);
+    const bool referenceLoaded =
+        files[0].complete && files[0].errors.empty();
+    for (std::size_t i = 1; i < files.size() && referenceLoaded; ++i) {
+        CheckTranslation(files[i], referenceArgs);
+    }
+
+    std::size_t errors = 0;
+    std::size_t warnings = 0;
+    for (const auto& file : files) {
+        PrintFile(file);
+        errors += file.errors.size();
+        warnings += file.warnings.size();
+    }
+    if (!referenceLoaded) {
+        std::printf("The reference has errors, nothing else was checked\n");
+    }
+
+    std::printf("\n  %-20s %6s %8s %6s %8s %9s %9s %11s\n", "file", "keys",
+                "utf-16", "errors", "warnings", "read us", "parse us",
+                "convert us");
+    for (const auto& file : files) {
+        std::printf("  %-20s %6zu %8zu %6zu %8zu %9lld %9lld %11lld\n",
+                    file.path.filename().string().c_str(),
+                    file.entries.size(), file.utf16Units, file.errors.size(),
+                    file.warnings.size(), Micros(file.readTime),
+                    Micros(file.parseTime), Micros(file.convertTime));
+    }
+    std::printf("\nLoaded %zu file(s) on %u thread(s) in %lld us: "
+                "%zu error(s), %zu warning(s)\n",
+                files.size(), jobs, Micros(loadTime), errors, warnings);
+    return errors != 0 || (strict && warnings != 0) ? 1 : 0;
+}
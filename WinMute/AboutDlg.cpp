@@ -112,14 +112,14 @@ struct AboutDlgData {
     HFONT hTitleFont = nullptr;
 };
 
-static void InsertTabItem(HWND hTabCtrl, UINT id, const std::wstring& itemName)
+static void InsertTabItem(HWND hTabCtrl, UINT id, std::wstring_view itemName)
 {
     constexpr int bufSize = 50;
     wchar_t buf[bufSize] = {L'\0'};
     TC_ITEM tcItem;
     ZeroMemory(&tcItem, sizeof(tcItem));
     tcItem.mask |= TCIF_TEXT;
-    StringCchCopyW(buf, bufSize, itemName.c_str());
+    StringCchCopyNW(buf, bufSize, itemName.data(), itemName.size());
     tcItem.pszText = buf;
     tcItem.cchTextMax = bufSize;
 
@@ -173,20 +173,17 @@ static void TranslateAboutGeneralDlgProc(HWND hDlg)
 {
     WMi18n& i18n = WMi18n::GetInstance();
 
-    const auto hpLink = std::vformat(
-        std::wstring_view(L"<a href=\"https://www.lx-s.de\">{}</a>"),
-        std::make_wformat_args(
-            i18n.GetTranslationW("about.general.author-site-label")));
+    const auto hpLink =
+        std::format(L"<a href=\"https://www.lx-s.de\">{}</a>",
+                    i18n.GetTranslationW("about.general.author-site-label"));
 
-    const auto projLink = std::vformat(
-        L"<a href=\"https://github.com/lx-s/WinMute/\">{}</a>",
-        std::make_wformat_args(
-            i18n.GetTranslationW("about.general.project-site-label")));
+    const auto projLink =
+        std::format(L"<a href=\"https://github.com/lx-s/WinMute/\">{}</a>",
+                    i18n.GetTranslationW("about.general.project-site-label"));
 
-    const auto supportLink = std::vformat(
+    const auto supportLink = std::format(
         L"<a href=\"https://github.com/lx-s/WinMute/issues/\">{}</a>",
-        std::make_wformat_args(
-            i18n.GetTranslationW("about.general.support-label")));
+        i18n.GetTranslationW("about.general.support-label"));
 
     SetDlgItemTextW(hDlg, IDC_LINK_HOMEPAGE, hpLink.c_str());
     SetDlgItemTextW(hDlg, IDC_LINK_PROJECT, projLink.c_str());
@@ -268,7 +265,7 @@ static INT_PTR CALLBACK About_ThirdPartyDlgProc(HWND hDlg, UINT msg, WPARAM,
 static void TranslateAboutDlgProc(HWND hDlg)
 {
     WMi18n& i18n = WMi18n::GetInstance();
-    SetWindowText(hDlg, i18n.GetTranslationW("about.title").c_str());
+    SetWindowText(hDlg, i18n.GetTranslationW("about.title").data());
     i18n.SetItemText(hDlg, IDOK, "about.btn-close");
 }
 
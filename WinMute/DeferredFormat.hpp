@@ -0,0 +1,302 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace deferred_format {
+
+template <typename T>
+using Plain = std::remove_cvref_t<T>;
+
+template <typename T>
+constexpr bool IsString = std::is_same_v<std::decay_t<T>, const wchar_t*> ||
+                          std::is_same_v<std::decay_t<T>, wchar_t*> ||
+                          std::is_same_v<Plain<T>, std::wstring> ||
+                          std::is_same_v<Plain<T>, std::wstring_view>;
+
+template <typename T>
+constexpr bool IsValue = std::is_arithmetic_v<Plain<T>> ||
+                         std::is_same_v<Plain<T>, const void*> ||
+                         std::is_same_v<Plain<T>, void*> ||
+                         std::is_same_v<Plain<T>, std::nullptr_t>;
+
+// What an argument is stored (and formatted) as.
+template <typename T>
+using Stored = std::conditional_t<IsString<T>, std::wstring_view, Plain<T>>;
+
+// Strings are stored as a length followed by the characters, which are read
+// in place; the length is padded so the characters stay aligned.
+constexpr std::size_t kLengthBytes =
+    alignof(wchar_t) > sizeof(std::uint16_t) ? alignof(wchar_t)
+                                             : sizeof(std::uint16_t);
+
+template <typename... Stored>
+constexpr std::size_t ValueBytes()
+{
+    constexpr std::size_t bytes =
+        ((std::is_same_v<Stored, std::wstring_view> ? 0 : sizeof(Stored)) +
+         ... + 0);
+    // The strings that follow are read in place as wchar_t.
+    return (bytes + alignof(wchar_t) - 1) & ~(alignof(wchar_t) - 1);
+}
+
+}  // namespace deferred_format
+
+// A format string plus its arguments, captured without formatting them. The
+// format string is a compile-time literal, so its address doubles as an id
+// for the kind of message. Numbers are stored as they are; strings are copied
+// into the fixed-size buffer (and cut off if they do not fit). Formatting
+// only happens in Format(), with the same format string and equivalent
+// arguments as a direct std::format call.
+//
+// Argument types without a compact encoding are formatted right away and
+// stored as the resulting string.
+template <std::size_t ArgBytes>
+class DeferredFormat {
+   public:
+    template <typename... Args>
+    void Capture(std::wformat_string<Args...> fmt, const Args&... args)
+    {
+        using namespace deferred_format;
+        const std::wstring_view view = fmt.get();
+        format_ = view.data();
+        formatLength_ = static_cast<std::uint32_t>(view.size());
+        size_ = 0;
+        if constexpr (((IsString<Args> || IsValue<Args>) && ...)) {
+            constexpr std::size_t valueBytes = ValueBytes<Stored<Args>...>();
+            constexpr std::size_t stringCount =
+                (static_cast<std::size_t>(IsString<Args>) + ... + 0);
+            static_assert(valueBytes + kLengthBytes * stringCount <= ArgBytes,
+                          "Too many arguments for a deferred log record");
+            formatter_ = &FormatStored<Stored<Args>...>;
+            (WriteValue(args), ...);
+            while (size_ < valueBytes) {
+                args_[size_++] = std::byte{0};  // alignment padding
+            }
+            if constexpr (stringCount > 0) {
+                const std::array<std::wstring_view, stringCount> strings =
+                    CollectStrings<stringCount>(args...);
+                const std::size_t cap = StringCap(strings);
+                for (const auto& str : strings) {
+                    WriteString(str, cap);
+                }
+            }
+        } else {
+            const std::wstring text =
+                std::vformat(view, std::make_wformat_args(args...));
+            formatter_ = &FormatPreformatted;
+            WriteString(text, StringCap(std::array{std::wstring_view(text)}));
+        }
+    }
+
+    // Captures an already formatted message.
+    void CaptureText(std::wstring_view text)
+    {
+        format_ = L"{}";
+        formatLength_ = 2;
+        size_ = 0;
+        formatter_ = &FormatPreformatted;
+        WriteString(text, StringCap(std::array{text}));
+    }
+
+    // Appends the formatted message to `out`.
+    void FormatTo(std::wstring& out) const
+    {
+        if (formatter_ != nullptr) {
+            formatter_(out, FormatString(), args_);
+        }
+    }
+
+    std::wstring Format() const
+    {
+        std::wstring out;
+        FormatTo(out);
+        return out;
+    }
+
+    std::wstring_view FormatString() const
+    {
+        return {format_, formatLength_};
+    }
+
+    // Same format string and same argument values.
+    bool SameAs(const DeferredFormat& other) const
+    {
+        return format_ == other.format_ && size_ == other.size_ &&
+               std::memcmp(args_, other.args_, size_) == 0;
+    }
+
+   private:
+    using FormatFn = void (*)(std::wstring& out, std::wstring_view fmt,
+                              const std::byte* args);
+
+    template <typename T>
+    void WriteValue(const T& value)
+    {
+        if constexpr (!deferred_format::IsString<T>) {
+            const deferred_format::Stored<T> stored = value;
+            std::memcpy(args_ + size_, &stored, sizeof(stored));
+            size_ += static_cast<std::uint16_t>(sizeof(stored));
+        }
+    }
+
+    template <std::size_t Count, typename... Args>
+    static std::array<std::wstring_view, Count> CollectStrings(
+        const Args&... args)
+    {
+        std::array<std::wstring_view, Count> strings;
+        std::size_t i = 0;
+        const auto collect = [&](const auto& arg) {
+            using T = decltype(arg);
+            if constexpr (deferred_format::IsString<T>) {
+                strings[i++] = ToView(arg);
+            }
+        };
+        (collect(args), ...);
+        return strings;
+    }
+
+    template <typename T>
+    static std::wstring_view ToView(const T& str)
+    {
+        if constexpr (std::is_pointer_v<std::decay_t<T>>) {
+            return str != nullptr ? std::wstring_view(str)
+                                  : std::wstring_view();
+        } else {
+            return std::wstring_view(str);
+        }
+    }
+
+    // The longest a string may be so that all of them fit: short strings
+    // are stored whole, the long ones share what is left.
+    template <std::size_t Count>
+    std::size_t StringCap(const std::array<std::wstring_view, Count>& strings)
+    {
+        std::size_t budget =
+            (ArgBytes - size_ - deferred_format::kLengthBytes * Count) /
+            sizeof(wchar_t);
+        std::array<std::size_t, Count> lengths;
+        for (std::size_t i = 0; i < Count; ++i) {
+            lengths[i] = strings[i].size();
+        }
+        std::sort(lengths.begin(), lengths.end());
+        for (std::size_t i = 0; i < Count; ++i) {
+            const std::size_t share = budget / (Count - i);
+            if (lengths[i] > share) {
+                return share;
+            }
+            budget -= lengths[i];
+        }
+        return lengths[Count - 1];  // all of them fit
+    }
+
+    void WriteString(std::wstring_view str, std::size_t cap)
+    {
+        const std::size_t len = std::min(str.size(), cap);
+        const auto len16 = static_cast<std::uint16_t>(len);
+        std::memcpy(args_ + size_, &len16, sizeof(len16));
+        std::fill(args_ + size_ + sizeof(len16),
+                  args_ + size_ + deferred_format::kLengthBytes, std::byte{0});
+        size_ += static_cast<std::uint16_t>(deferred_format::kLengthBytes);
+        std::memcpy(args_ + size_, str.data(), len * sizeof(wchar_t));
+        if (len < str.size() && len > 0) {
+            const wchar_t ellipsis = L'\u2026';
+            std::memcpy(args_ + size_ + (len - 1) * sizeof(wchar_t),
+                        &ellipsis, sizeof(ellipsis));
+        }
+        size_ += static_cast<std::uint16_t>(len * sizeof(wchar_t));
+    }
+
+    template <typename T>
+    static T Read(const std::byte*& values, const std::byte*& strings)
+    {
+        if constexpr (std::is_same_v<T, std::wstring_view>) {
+            std::uint16_t len = 0;
+            std::memcpy(&len, strings, sizeof(len));
+            strings += deferred_format::kLengthBytes;
+            const std::wstring_view str(
+                reinterpret_cast<const wchar_t*>(strings), len);
+            strings += len * sizeof(wchar_t);
+            return str;
+        } else {
+            T value;
+            std::memcpy(&value, values, sizeof(value));
+            values += sizeof(value);
+            return value;
+        }
+    }
+
+    template <typename... Stored>
+    static void FormatStored(std::wstring& out, std::wstring_view fmt,
+                             const std::byte* args)
+    {
+        // Unused if there are no arguments.
+        [[maybe_unused]] const std::byte* values = args;
+        [[maybe_unused]] const std::byte* strings =
+            args + deferred_format::ValueBytes<Stored...>();
+        // Braced initialization evaluates the reads left to right.
+        std::tuple<Stored...> decoded{Read<Stored>(values, strings)...};
+        std::apply(
+            [&out, fmt](auto&... decodedArgs) {
+                std::vformat_to(std::back_inserter(out), fmt,
+                                std::make_wformat_args(decodedArgs...));
+            },
+            decoded);
+    }
+
+    static void FormatPreformatted(std::wstring& out, std::wstring_view,
+                                   const std::byte* args)
+    {
+        const std::byte* values = args;
+        const std::byte* strings = args;
+        out.append(Read<std::wstring_view>(values, strings));
+    }
+
+    const wchar_t* format_ = nullptr;
+    std::uint32_t formatLength_ = 0;
+    std::uint16_t size_ = 0;
+    FormatFn formatter_ = nullptr;
+    alignas(8) std::byte args_[ArgBytes];
+};
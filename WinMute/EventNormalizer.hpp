@@ -0,0 +1,229 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Cleans up the raw stream of OS notifications before it reaches the muting
+// logic. Every source (display, lid, ...) reports a small integer state and is
+// filtered according to its rule:
+//
+//  - Events stamped earlier than the last one seen from the same source are
+//    dropped, so a late delivery cannot overwrite a newer state.
+//  - With `armedBy` set, everything but that state is dropped until it was
+//    seen once. Used where the initial report on registration must not count.
+//  - With `dropRepeats` set, an event that reports the state that was last
+//    passed on (or is about to be) is dropped.
+//  - With a non-zero `debounce`, the first change is passed on immediately,
+//    but further changes within the window are held back and only the final
+//    state is passed on once the window ended. A change that is reverted
+//    within the window is never passed on.
+//
+// Held-back events are delivered from Poll(); NextDeadline() tells the owner
+// when to call it. Not thread-safe.
+class EventNormalizer {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    struct Rule {
+        bool dropRepeats = true;
+        std::optional<int> armedBy;
+        Clock::duration debounce{0};
+    };
+
+    struct Event {
+        std::size_t source = 0;
+        int state = 0;
+        TimePoint received;
+    };
+    using Sink = std::function<void(const Event&)>;
+
+    enum class Verdict { Passed, Held, Duplicate, Unarmed, OutOfOrder };
+
+    struct Counters {
+        std::uint64_t passed = 0;
+        std::uint64_t duplicates = 0;
+        std::uint64_t unarmed = 0;
+        std::uint64_t outOfOrder = 0;
+        // Held-back events that were superseded, reverted or reset.
+        std::uint64_t coalesced = 0;
+
+        std::uint64_t Dropped() const
+        {
+            return duplicates + unarmed + outOfOrder + coalesced;
+        }
+    };
+
+    EventNormalizer(std::vector<Rule> rules, Sink sink)
+        : sink_(std::move(sink)), sources_(rules.size())
+    {
+        for (std::size_t i = 0; i < rules.size(); ++i) {
+            sources_[i].rule = rules[i];
+        }
+    }
+
+    Verdict Submit(std::size_t source, int state, TimePoint received)
+    {
+        Source& src = sources_.at(source);
+        if (src.lastSeen && received < *src.lastSeen) {
+            ++src.counters.outOfOrder;
+            return Verdict::OutOfOrder;
+        }
+        src.lastSeen = received;
+        FlushIfDue(source, received);
+
+        if (src.rule.armedBy && !src.armed) {
+            if (state != *src.rule.armedBy) {
+                ++src.counters.unarmed;
+                return Verdict::Unarmed;
+            }
+            src.armed = true;
+        }
+
+        const std::optional<int> effective =
+            src.pending ? std::optional<int>(src.pending->state) : src.last;
+        if (src.rule.dropRepeats && effective == state) {
+            ++src.counters.duplicates;
+            return Verdict::Duplicate;
+        }
+
+        if (src.last && received < src.lastPassed + src.rule.debounce) {
+            if (src.pending) {
+                ++src.counters.coalesced;
+                src.pending.reset();
+            }
+            if (state == *src.last) {
+                ++src.counters.coalesced;  // reverted within the window
+            } else {
+                src.pending = Event{source, state, received};
+            }
+            return Verdict::Held;
+        }
+
+        Pass(src, Event{source, state, received});
+        return Verdict::Passed;
+    }
+
+    // Passes on every held-back event whose debounce window has ended.
+    void Poll(TimePoint now)
+    {
+        for (std::size_t i = 0; i < sources_.size(); ++i) {
+            FlushIfDue(i, now);
+        }
+    }
+
+    // Forgets the state of `source`, as if it had just been registered: the
+    // next event passes even if it repeats the last one. For sources whose
+    // end is not always reported, e.g. when they are reconfigured. A held-back
+    // event is dropped. Counters are kept.
+    void Reset(std::size_t source)
+    {
+        Source& src = sources_.at(source);
+        if (src.pending) {
+            ++src.counters.coalesced;
+        }
+        src.armed = false;
+        src.last.reset();
+        src.lastPassed = {};
+        src.lastSeen.reset();
+        src.pending.reset();
+    }
+
+    // When the next held-back event becomes due, if there is one.
+    std::optional<TimePoint> NextDeadline() const
+    {
+        std::optional<TimePoint> next;
+        for (const auto& src : sources_) {
+            if (src.pending) {
+                const TimePoint due = src.lastPassed + src.rule.debounce;
+                if (!next || due < *next) {
+                    next = due;
+                }
+            }
+        }
+        return next;
+    }
+
+    const Counters& GetCounters(std::size_t source) const
+    {
+        return sources_.at(source).counters;
+    }
+
+    std::size_t SourceCount() const
+    {
+        return sources_.size();
+    }
+
+   private:
+    struct Source {
+        Rule rule;
+        Counters counters;
+        bool armed = false;
+        std::optional<int> last;
+        TimePoint lastPassed;
+        std::optional<TimePoint> lastSeen;
+        std::optional<Event> pending;
+    };
+
+    void Pass(Source& src, const Event& event)
+    {
+        src.last = event.state;
+        src.lastPassed = event.received;
+        ++src.counters.passed;
+        sink_(event);
+    }
+
+    void FlushIfDue(std::size_t source, TimePoint now)
+    {
+        Source& src = sources_[source];
+        const TimePoint due = src.lastPassed + src.rule.debounce;
+        if (src.pending && now >= due) {
+            Event event = *src.pending;
+            src.pending.reset();
+            Pass(src, event);
+            // The next window starts when the held event was released.
+            src.lastPassed = due;
+        }
+    }
+
+    Sink sink_;
+    std::vector<Source> sources_;
+};
@@ -0,0 +1,179 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// One record of the JSON lines log: a flat object on a single line,
+//
+//   {"level":"INFO","mono_us":123,"time":"...","event":"muted",
+//    "trigger":"Workstation Lock","endpoint":"{0.0.0.00000000}.{...}",
+//    "duration_us":2150,"msg":"Muted workstation"}
+//
+// Optional fields (event, trigger, endpoint, duration_us, repeats) are left
+// out when empty, negative or zero. mono_us is a monotonic clock reading, only
+// comparable between records of the same boot.
+//
+// A record with "repeats" stands for that many further copies of the record
+// before it that were folded into a count. It carries the same event fields,
+// so it can be counted without looking back.
+struct JsonLogRecord {
+    std::wstring_view level;
+    std::int64_t monotonicUs = 0;
+    std::wstring_view time;
+    std::wstring_view event;
+    std::wstring_view trigger;
+    std::wstring_view endpoint;
+    std::int64_t durationUs = -1;
+    std::uint64_t repeats = 0;
+    std::wstring_view message;
+};
+
+namespace json_log {
+
+inline void AppendUtf8(std::string& out, char32_t cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Appends `text` as a quoted, escaped JSON string in UTF-8. Unpaired
+// surrogates become U+FFFD.
+inline void AppendString(std::string& out, std::wstring_view text)
+{
+    static constexpr char kHex[] = "0123456789abcdef";
+    out += '"';
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto cp = static_cast<char32_t>(text[i]);
+        switch (cp) {
+            case U'"':
+                out += "\\\"";
+                continue;
+            case U'\\':
+                out += "\\\\";
+                continue;
+            case U'\n':
+                out += "\\n";
+                continue;
+            case U'\r':
+                out += "\\r";
+                continue;
+            case U'\t':
+                out += "\\t";
+                continue;
+            default:
+                break;
+        }
+        if (cp < 0x20) {
+            out += "\\u00";
+            out += kHex[cp >> 4];
+            out += kHex[cp & 0xF];
+            continue;
+        }
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < text.size()) {
+            const auto low = static_cast<char32_t>(text[i + 1]);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                ++i;
+            }
+        }
+        if ((cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            cp = 0xFFFD;
+        }
+        AppendUtf8(out, cp);
+    }
+    out += '"';
+}
+
+inline void AppendStringField(std::string& out, std::string_view key,
+                              std::wstring_view value)
+{
+    out += ",\"";
+    out += key;
+    out += "\":";
+    AppendString(out, value);
+}
+
+inline void AppendNumberField(std::string& out, std::string_view key,
+                              std::int64_t value)
+{
+    out += ",\"";
+    out += key;
+    out += "\":";
+    out += std::to_string(value);
+}
+
+}  // namespace json_log
+
+// Appends `record` and a line break to `out`.
+inline void AppendJsonLogLine(std::string& out, const JsonLogRecord& record)
+{
+    out += "{\"level\":";
+    json_log::AppendString(out, record.level);
+    json_log::AppendNumberField(out, "mono_us", record.monotonicUs);
+    json_log::AppendStringField(out, "time", record.time);
+    if (!record.event.empty()) {
+        json_log::AppendStringField(out, "event", record.event);
+    }
+    if (!record.trigger.empty()) {
+        json_log::AppendStringField(out, "trigger", record.trigger);
+    }
+    if (!record.endpoint.empty()) {
+        json_log::AppendStringField(out, "endpoint", record.endpoint);
+    }
+    if (record.durationUs >= 0) {
+        json_log::AppendNumberField(out, "duration_us", record.durationUs);
+    }
+    if (record.repeats != 0) {
+        json_log::AppendNumberField(out, "repeats",
+                                    static_cast<std::int64_t>(record.repeats));
+    }
+    json_log::AppendStringField(out, "msg", record.message);
+    out += "}\n";
+}
@@ -0,0 +1,123 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "libs/json.hpp"
+
+// Reads a language file only up to its top-level "meta.lang.name", without
+// building a DOM.
+class LanguageNameReader : public nlohmann::json_sax<nlohmann::json> {
+   public:
+    std::optional<std::string> name;
+    std::string error;
+
+    bool null() override
+    {
+        return Value();
+    }
+    bool boolean(bool) override
+    {
+        return Value();
+    }
+    bool number_integer(number_integer_t) override
+    {
+        return Value();
+    }
+    bool number_unsigned(number_unsigned_t) override
+    {
+        return Value();
+    }
+    bool number_float(number_float_t, const string_t&) override
+    {
+        return Value();
+    }
+    bool string(string_t& val) override
+    {
+        if (isName_) {
+            name = std::move(val);
+            return false;  // Done, stop parsing
+        }
+        return true;
+    }
+    bool binary(binary_t&) override
+    {
+        return Value();
+    }
+    bool start_object(std::size_t) override
+    {
+        ++depth_;
+        return Value();
+    }
+    bool end_object() override
+    {
+        --depth_;
+        return true;
+    }
+    bool start_array(std::size_t) override
+    {
+        ++depth_;
+        return Value();
+    }
+    bool end_array() override
+    {
+        --depth_;
+        return true;
+    }
+    bool key(string_t& val) override
+    {
+        isName_ = depth_ == 1 && val == "meta.lang.name";
+        return true;
+    }
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception& ex) override
+    {
+        error = ex.what();
+        return false;
+    }
+
+   private:
+    bool Value()
+    {
+        isName_ = false;
+        return true;
+    }
+
+    int depth_ = 0;
+    bool isName_ = false;
+};
@@ -0,0 +1,190 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+// A language file compiled by Tools/BuildLanguagePacks.ps1, read in place
+// from a mapped file. All numbers are little-endian, offsets count from the
+// start of the file:
+//
+//   header   magic "WMLP", version, size and HashSource() of the source
+//            JSON file, entry count, entry table offset, blob offset,
+//            blob size
+//   entries  key offset, key length, text offset, text length; sorted by
+//            key, ordinally
+//   blob     the texts, UTF-16, each followed by a 0; then the keys, ASCII
+//
+// A pack is only used if it was built from the JSON file next to it, so an
+// edited JSON file takes precedence over a stale pack. This compares the
+// content, not the last write time: installers and zip files round that to
+// two seconds.
+class LanguagePackView {
+   public:
+    static constexpr std::uint32_t kVersion = 2;
+
+    // 64-bit FNV-1a of the source JSON file, as stored in the pack.
+    static std::uint64_t HashSource(std::span<const std::byte> source)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const std::byte b : source) {
+            hash = (hash ^ std::to_integer<std::uint64_t>(b)) *
+                   1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Returns false if `data` is not a well-formed pack of kVersion. The view
+    // does not copy `data`, which must outlive it.
+    bool Open(std::span<const std::byte> data)
+    {
+        data_ = {};
+        Header header;
+        if (data.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        const std::uint64_t entriesEnd =
+            header.entriesOffset +
+            std::uint64_t{header.entryCount} * sizeof(Entry);
+        const std::uint64_t blobEnd =
+            std::uint64_t{header.blobOffset} + header.blobSize;
+        if (std::memcmp(header.magic, kMagic, sizeof(header.magic)) != 0 ||
+            header.version != kVersion || header.entriesOffset % 4 != 0 ||
+            header.entriesOffset < sizeof(header) || entriesEnd > data.size() ||
+            header.blobOffset % 2 != 0 || header.blobOffset < entriesEnd ||
+            blobEnd > data.size())
+        {
+            return false;
+        }
+        data_ = data;
+        header_ = header;
+        for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+            const Entry entry = GetEntry(i);
+            const std::uint64_t keyEnd =
+                std::uint64_t{entry.keyOffset} + entry.keyLength;
+            const std::uint64_t textEnd =
+                entry.textOffset + (std::uint64_t{entry.textLength} + 1) * 2;
+            if (keyEnd > header.blobSize || entry.textOffset % 2 != 0 ||
+                textEnd > header.blobSize ||
+                (i > 0 && GetKey(i - 1) >= GetKey(i)) ||
+                GetText(i).data()[entry.textLength] != u'\0')
+            {
+                data_ = {};
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::uint64_t GetSourceSize() const
+    {
+        return header_.sourceSize;
+    }
+
+    std::uint64_t GetSourceHash() const
+    {
+        return header_.sourceHash;
+    }
+
+    // Upper bound for the UTF-16 code units of all texts.
+    std::size_t GetTextCapacity() const
+    {
+        return data_.empty() ? 0 : header_.blobSize / 2;
+    }
+
+    std::size_t Size() const
+    {
+        return data_.empty() ? 0 : header_.entryCount;
+    }
+
+    std::string_view GetKey(std::size_t i) const
+    {
+        const Entry entry = GetEntry(i);
+        return {reinterpret_cast<const char*>(Blob() + entry.keyOffset),
+                entry.keyLength};
+    }
+
+    // Null-terminated.
+    std::u16string_view GetText(std::size_t i) const
+    {
+        const Entry entry = GetEntry(i);
+        return {reinterpret_cast<const char16_t*>(Blob() + entry.textOffset),
+                entry.textLength};
+    }
+
+   private:
+    static constexpr char kMagic[4] = {'W', 'M', 'L', 'P'};
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint64_t sourceSize;
+        std::uint64_t sourceHash;
+        std::uint32_t entryCount;
+        std::uint32_t entriesOffset;
+        std::uint32_t blobOffset;
+        std::uint32_t blobSize;
+    };
+    static_assert(sizeof(Header) == 40);
+
+    struct Entry {
+        std::uint32_t keyOffset;
+        std::uint32_t keyLength;
+        std::uint32_t textOffset;
+        std::uint32_t textLength;
+    };
+    static_assert(sizeof(Entry) == 16);
+
+    Entry GetEntry(std::size_t i) const
+    {
+        Entry entry;
+        std::memcpy(&entry,
+                    data_.data() + header_.entriesOffset + i * sizeof(Entry),
+                    sizeof(entry));
+        return entry;
+    }
+
+    const std::byte* Blob() const
+    {
+        return data_.data() + header_.blobOffset;
+    }
+
+    std::span<const std::byte> data_;
+    Header header_{};
+};
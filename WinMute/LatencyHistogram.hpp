@@ -0,0 +1,140 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+// Fixed-size latency histogram with log-linear buckets: every power of two is
+// split into eight sub-buckets, so percentiles are accurate to within 12.5%
+// regardless of the magnitude. Values are recorded in microseconds; anything
+// up to roughly 2^40 us (12 days) is tracked, larger values are clamped.
+//
+// Recording never allocates. Not thread-safe.
+class LatencyHistogram {
+   public:
+    using Duration = std::chrono::microseconds;
+
+    // `count` records the same value that many times.
+    void Record(Duration value, std::uint32_t count = 1)
+    {
+        const auto us = static_cast<std::uint64_t>(
+            std::max<Duration::rep>(value.count(), 0));
+        buckets_[BucketOf(us)] += count;
+        count_ += count;
+        max_ = std::max(max_, us);
+    }
+
+    std::uint64_t Count() const
+    {
+        return count_;
+    }
+
+    Duration Max() const
+    {
+        return Duration(static_cast<Duration::rep>(max_));
+    }
+
+    // Smallest recorded bucket bound below which at least `percentile` percent
+    // of all values lie. Never reports more than the recorded maximum.
+    Duration Percentile(double percentile) const
+    {
+        if (count_ == 0) {
+            return Duration(0);
+        }
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        auto rank = static_cast<std::uint64_t>(
+            (clamped / 100.0) * static_cast<double>(count_) + 0.5);
+        rank = std::clamp<std::uint64_t>(rank, 1, count_);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < buckets_.size(); ++i) {
+            seen += buckets_[i];
+            if (seen >= rank && i == buckets_.size() - 1) {
+                return Max();  // clamped values have no meaningful bound
+            } else if (seen >= rank) {
+                return Duration(static_cast<Duration::rep>(
+                    std::min(UpperBoundOf(i), max_)));
+            }
+        }
+        return Max();
+    }
+
+    void Reset()
+    {
+        buckets_.fill(0);
+        count_ = 0;
+        max_ = 0;
+    }
+
+   private:
+    static constexpr int kSubBits = 3;
+    static constexpr std::uint64_t kSubBuckets = 1 << kSubBits;
+    static constexpr int kMaxExponent = 40;
+    static constexpr std::size_t kBucketCount =
+        (kMaxExponent - kSubBits + 2) * kSubBuckets;
+
+    static std::size_t BucketOf(std::uint64_t us)
+    {
+        if (us < kSubBuckets) {
+            return static_cast<std::size_t>(us);
+        }
+        const int exponent = static_cast<int>(std::bit_width(us)) - 1;
+        if (exponent > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const std::uint64_t sub =
+            (us >> (exponent - kSubBits)) & (kSubBuckets - 1);
+        return static_cast<std::size_t>(
+            (exponent - kSubBits + 1) * kSubBuckets + sub);
+    }
+
+    static std::uint64_t UpperBoundOf(std::size_t bucket)
+    {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const int exponent =
+            static_cast<int>(bucket / kSubBuckets) + kSubBits - 1;
+        const std::uint64_t sub = bucket % kSubBuckets;
+        const std::uint64_t width = std::uint64_t{1} << (exponent - kSubBits);
+        return (std::uint64_t{1} << exponent) + (sub + 1) * width - 1;
+    }
+
+    std::array<std::uint32_t, kBucketCount> buckets_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t max_ = 0;
+};
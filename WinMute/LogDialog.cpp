@@ -35,12 +35,517 @@ POSSIBILITY OF SUCH DAMAGE.
 
 extern HINSTANCE hglobInstance;
 
+enum LogColumn {
+    LOG_COLUMN_TIME,
+    LOG_COLUMN_LEVEL,
+    LOG_COLUMN_MESSAGE,
+    LOG_COLUMN_COUNT
+};
+
+struct LogRow {
+    std::uint64_t seq;
+    LogLevel level;
+};
+
+// Folds the way the user expects a case-insensitive search to behave, not
+// just for ASCII.
+static void FoldLogText(std::wstring& text)
+{
+    if (!text.empty()) {
+        CharLowerBuffW(text.data(), static_cast<DWORD>(text.length()));
+    }
+}
+
+// The fields of a new message the filter index needs.
+struct NewMessage {
+    std::uint64_t seq;
+    LogLevel level;
+    const wchar_t* trigger;
+    DeferredFormat<512> message;
+};
+
 struct LogDlgData {
-    HWND hLogContent;
+    HWND hLogContent = nullptr;
+    // Which of the stored messages pass the filter bar. Messages are added
+    // as they are picked up, so changing the filter never formats them again.
+    LogFilterIndex filterIndex{FoldLogText};
+    // New messages are copied here while the history is locked, and only
+    // formatted for the filter index after it has been released. Kept to
+    // reuse its memory.
+    std::vector<NewMessage> newMessages;
+    // The shown messages in display order. Only the sequence number is kept:
+    // the list view is owner-data, so the text of a row is formatted from the
+    // log history when the row is painted.
+    std::vector<LogRow> rows;
+    // Rows hold the stored messages in [firstSeq, nextSeq) that pass the
+    // filter.
+    std::uint64_t firstSeq = 0;
+    std::uint64_t nextSeq = 0;
+    int sortColumn = LOG_COLUMN_TIME;
+    bool sortAscending = true;
+    // New messages are picked up by a timer, not one by one.
+    bool updatePending = false;
+    // The list view asks for the columns of a row one after the other.
+    std::uint64_t cachedSeq = UINT64_MAX;
+    std::wstring cachedText[LOG_COLUMN_COUNT];
 };
 
 static HWND hLogDlg_ = nullptr;
 
+static constexpr UINT_PTR LOG_UPDATE_TIMER_ID = 1;
+static constexpr UINT LOG_UPDATE_INTERVAL_MS = 100;
+
+// System menu entries. The low four bits of SC_* ids are used by Windows.
+static constexpr UINT IDM_LOG_SHOW_MUTE_LATENCY = 0x0010;
+static constexpr UINT IDM_LOG_EXPORT_MUTE_LATENCY = 0x0020;
+
+static void AddMuteLatencyMenuItems(HWND hDlg)
+{
+    HMENU hSysMenu = GetSystemMenu(hDlg, FALSE);
+    if (hSysMenu == nullptr) {
+        return;
+    }
+    WMi18n& i18n = WMi18n::GetInstance();
+    AppendMenuW(hSysMenu, MF_SEPARATOR, 0, nullptr);
+    AppendMenuW(hSysMenu, MF_STRING, IDM_LOG_SHOW_MUTE_LATENCY,
+                i18n.GetTranslationW("log.menu.show-mute-latency").data());
+    AppendMenuW(hSysMenu, MF_STRING, IDM_LOG_EXPORT_MUTE_LATENCY,
+                i18n.GetTranslationW("log.menu.export-mute-latency").data());
+}
+
+static void ExportMuteLatency(HWND hDlg)
+{
+    WMLog& log = WMLog::GetInstance();
+    CComPtr<IFileSaveDialog> fileDlg;
+    HRESULT hr = fileDlg.CoCreateInstance(CLSID_FileSaveDialog);
+    if (FAILED(hr)) {
+        log.LogWinError(L"CoCreateInstance", static_cast<DWORD>(hr));
+        return;
+    }
+    const COMDLG_FILTERSPEC fileTypes[] = {{L"CSV", L"*.csv"}};
+    fileDlg->SetFileTypes(static_cast<UINT>(ARRAY_SIZE(fileTypes)), fileTypes);
+    fileDlg->SetDefaultExtension(L"csv");
+    fileDlg->SetFileName(L"WinMute-mute-latency.csv");
+    hr = fileDlg->Show(hDlg);
+    if (hr == HRESULT_FROM_WIN32(ERROR_CANCELLED)) {
+        return;
+    } else if (FAILED(hr)) {
+        log.LogWinError(L"IFileSaveDialog::Show", static_cast<DWORD>(hr));
+        return;
+    }
+    CComPtr<IShellItem> result;
+    PWSTR path = nullptr;
+    if (FAILED(fileDlg->GetResult(&result)) ||
+        FAILED(result->GetDisplayName(SIGDN_FILESYSPATH, &path)))
+    {
+        log.LogError(L"Failed to get the path for the mute latency export");
+        return;
+    }
+    const std::wstring filePath{path};
+    CoTaskMemFree(path);
+    MuteLatencyStats::GetInstance().ExportCsv(filePath);
+}
+
+// Returns false if the message is no longer stored.
+static bool FormatRow(LogDlgData& data, std::uint64_t seq)
+{
+    if (seq == data.cachedSeq) {
+        return true;
+    }
+    const WMLog& wmLog = WMLog::GetInstance();
+    // Copied, so it is not formatted while the history is locked.
+    std::optional<LogMessage> lm;
+    wmLog.VisitLogMessages(seq, seq + 1,
+                           [&lm](const LogMessage& stored) { lm = stored; });
+    if (!lm) {
+        data.cachedSeq = UINT64_MAX;
+        return false;
+    }
+    for (auto& text : data.cachedText) {
+        text.clear();
+    }
+    wmLog.FormatLogTime(lm->time, data.cachedText[LOG_COLUMN_TIME]);
+    data.cachedText[LOG_COLUMN_LEVEL] = WMLog::GetLevelName(lm->level);
+    lm->message.FormatTo(data.cachedText[LOG_COLUMN_MESSAGE]);
+    data.cachedSeq = seq;
+    return true;
+}
+
+static std::wstring GetMessageText(LogDlgData& data, std::uint64_t seq)
+{
+    return FormatRow(data, seq) ? data.cachedText[LOG_COLUMN_MESSAGE]
+                                : std::wstring();
+}
+
+// Index of the trigger a message was logged for, as the filter bar lists them.
+static int GetTriggerIndex(const wchar_t* trigger)
+{
+    if (trigger == nullptr) {
+        return LogFilterIndex::kAnyTrigger;
+    }
+    for (int i = 0; i < static_cast<int>(MuteTrigger::Count); ++i) {
+        if (trigger ==
+            MuteLatencyStats::TriggerToString(static_cast<MuteTrigger>(i)))
+        {
+            return i;
+        }
+    }
+    return LogFilterIndex::kAnyTrigger;
+}
+
+// Sequence numbers grow with time, so they double as the time order and as
+// the tie breaker for the other columns.
+static bool RowLess(LogDlgData& data, const LogRow& a, const LogRow& b)
+{
+    const LogRow& lhs = data.sortAscending ? a : b;
+    const LogRow& rhs = data.sortAscending ? b : a;
+    switch (data.sortColumn) {
+        case LOG_COLUMN_LEVEL:
+            if (lhs.level != rhs.level) {
+                return lhs.level < rhs.level;
+            }
+            break;
+        case LOG_COLUMN_MESSAGE: {
+            const auto cmp = GetMessageText(data, lhs.seq)
+                                 .compare(GetMessageText(data, rhs.seq));
+            if (cmp != 0) {
+                return cmp < 0;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return lhs.seq < rhs.seq;
+}
+
+static void SortRows(LogDlgData& data)
+{
+    if (data.sortColumn == LOG_COLUMN_MESSAGE) {
+        // Format every message once instead of twice per comparison.
+        std::vector<std::pair<std::wstring, LogRow>> keyed;
+        keyed.reserve(data.rows.size());
+        for (const auto& row : data.rows) {
+            keyed.emplace_back(GetMessageText(data, row.seq), row);
+        }
+        std::sort(keyed.begin(), keyed.end(),
+                  [&data](const auto& a, const auto& b) {
+                      const auto& lhs = data.sortAscending ? a : b;
+                      const auto& rhs = data.sortAscending ? b : a;
+                      const auto cmp = lhs.first.compare(rhs.first);
+                      if (cmp != 0) {
+                          return cmp < 0;
+                      }
+                      return lhs.second.seq < rhs.second.seq;
+                  });
+        for (size_t i = 0; i < keyed.size(); ++i) {
+            data.rows[i] = keyed[i].second;
+        }
+    } else {
+        std::sort(data.rows.begin(), data.rows.end(),
+                  [&data](const LogRow& a, const LogRow& b) {
+                      return RowLess(data, a, b);
+                  });
+    }
+}
+
+static void UpdateSortArrows(const LogDlgData& data)
+{
+    HWND hHeader = ListView_GetHeader(data.hLogContent);
+    for (int i = 0; i < LOG_COLUMN_COUNT; ++i) {
+        HDITEMW hdi{};
+        hdi.mask = HDI_FORMAT;
+        Header_GetItem(hHeader, i, &hdi);
+        hdi.fmt &= ~(HDF_SORTUP | HDF_SORTDOWN);
+        if (i == data.sortColumn) {
+            hdi.fmt |= data.sortAscending ? HDF_SORTUP : HDF_SORTDOWN;
+        }
+        Header_SetItem(hHeader, i, &hdi);
+    }
+}
+
+static bool IsLastRowVisible(const LogDlgData& data)
+{
+    const int count = ListView_GetItemCount(data.hLogContent);
+    return count == 0 || ListView_GetTopIndex(data.hLogContent) +
+                                 ListView_GetCountPerPage(data.hLogContent) >=
+                             count;
+}
+
+// Picks up the messages stored since the last update and drops the ones the
+// history has overwritten. The list view only repaints the visible rows.
+static void UpdateRows(LogDlgData& data)
+{
+    const WMLog& wmLog = WMLog::GetInstance();
+    const bool followNewest = data.sortColumn == LOG_COLUMN_TIME &&
+                              data.sortAscending && IsLastRowVisible(data);
+    const auto oldCount = data.rows.size();
+    bool appendedOnly = data.sortColumn == LOG_COLUMN_TIME &&
+                        data.sortAscending;
+
+    const auto firstSeq = wmLog.GetFirstSequence();
+    if (firstSeq > data.firstSeq) {
+        std::erase_if(data.rows, [firstSeq](const LogRow& row) {
+            return row.seq < firstSeq;
+        });
+        data.filterIndex.Evict(firstSeq);
+        data.firstSeq = firstSeq;
+        appendedOnly = false;
+    }
+
+    // Visiting locks the history, which blocks the log writer and everyone
+    // logging, so nothing is formatted in there.
+    data.newMessages.clear();
+    const auto endSeq = wmLog.GetEndSequence();
+    wmLog.VisitLogMessages(data.nextSeq, endSeq, [&](const LogMessage& lm) {
+        data.newMessages.push_back({lm.seq, lm.level, lm.trigger, lm.message});
+    });
+    data.nextSeq = endSeq;
+
+    std::vector<LogRow> newRows;
+    for (const auto& msg : data.newMessages) {
+        if (data.filterIndex.Add(msg.seq, static_cast<int>(msg.level),
+                                 GetTriggerIndex(msg.trigger),
+                                 msg.message.Format()))
+        {
+            newRows.push_back({msg.seq, msg.level});
+        }
+    }
+    for (const auto& row : newRows) {
+        const auto pos = std::upper_bound(
+            data.rows.begin(), data.rows.end(), row,
+            [&data](const LogRow& a, const LogRow& b) {
+                return RowLess(data, a, b);
+            });
+        data.rows.insert(pos, row);
+    }
+
+    const int count = static_cast<int>(data.rows.size());
+    if (appendedOnly) {
+        ListView_SetItemCountEx(data.hLogContent, count,
+                                LVSICF_NOINVALIDATEALL | LVSICF_NOSCROLL);
+        if (data.rows.size() != oldCount) {
+            ListView_RedrawItems(data.hLogContent,
+                                 static_cast<int>(oldCount), count - 1);
+        }
+    } else {
+        ListView_SetItemCountEx(data.hLogContent, count, LVSICF_NOSCROLL);
+        InvalidateRect(data.hLogContent, nullptr, FALSE);
+    }
+    if (followNewest && count > 0) {
+        ListView_EnsureVisible(data.hLogContent, count - 1, FALSE);
+    }
+}
+
+static void ApplyFilter(HWND hDlg, LogDlgData& data)
+{
+    LogFilterIndex::Filter filter;
+    HWND hLevel = GetDlgItem(hDlg, IDC_LOG_FILTER_LEVEL);
+    HWND hTrigger = GetDlgItem(hDlg, IDC_LOG_FILTER_TRIGGER);
+    const int level = ComboBox_GetCurSel(hLevel);
+    if (level != CB_ERR) {
+        filter.minLevel = static_cast<int>(ComboBox_GetItemData(hLevel, level));
+    }
+    const int trigger = ComboBox_GetCurSel(hTrigger);
+    if (trigger != CB_ERR) {
+        filter.trigger =
+            static_cast<int>(ComboBox_GetItemData(hTrigger, trigger));
+    }
+    HWND hText = GetDlgItem(hDlg, IDC_LOG_FILTER_TEXT);
+    filter.text.resize(static_cast<size_t>(GetWindowTextLengthW(hText)) + 1);
+    filter.text.resize(static_cast<size_t>(GetWindowTextW(
+        hText, filter.text.data(), static_cast<int>(filter.text.size()))));
+    data.filterIndex.Fold(filter.text);
+
+    if (!data.filterIndex.SetFilter(filter)) {
+        return;
+    }
+    data.rows.clear();
+    for (const auto seq : data.filterIndex.GetMatches()) {
+        data.rows.push_back(
+            {seq, static_cast<LogLevel>(data.filterIndex.GetLevel(seq))});
+    }
+    // Matches come in time order.
+    if (data.sortColumn != LOG_COLUMN_TIME || !data.sortAscending) {
+        SortRows(data);
+    }
+    ListView_SetItemCountEx(data.hLogContent,
+                            static_cast<int>(data.rows.size()), 0);
+    InvalidateRect(data.hLogContent, nullptr, FALSE);
+}
+
+static void CopySelectedRows(HWND hDlg, LogDlgData& data)
+{
+    const WMLog& wmLog = WMLog::GetInstance();
+    std::wstring text;
+    int item = -1;
+    while ((item = ListView_GetNextItem(data.hLogContent, item,
+                                        LVNI_SELECTED)) != -1)
+    {
+        if (static_cast<size_t>(item) >= data.rows.size()) {
+            break;
+        }
+        const auto seq = data.rows[item].seq;
+        std::optional<LogMessage> lm;
+        wmLog.VisitLogMessages(
+            seq, seq + 1, [&lm](const LogMessage& stored) { lm = stored; });
+        if (lm) {
+            text += wmLog.FormatLogMessage(*lm, true);
+        }
+    }
+    if (text.empty() || !OpenClipboard(hDlg)) {
+        return;
+    }
+    EmptyClipboard();
+    const size_t size = (text.length() + 1) * sizeof(wchar_t);
+    HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, size);
+    if (hMem != nullptr) {
+        void* buffer = GlobalLock(hMem);
+        if (buffer != nullptr) {
+            memcpy(buffer, text.c_str(), size);
+            GlobalUnlock(hMem);
+        }
+        if (buffer == nullptr ||
+            SetClipboardData(CF_UNICODETEXT, hMem) == nullptr)
+        {
+            GlobalFree(hMem);
+        }
+    }
+    CloseClipboard();
+}
+
+static void SetupFilterBar(HWND hDlg)
+{
+    WMi18n& i18n = WMi18n::GetInstance();
+    HWND hLevel = GetDlgItem(hDlg, IDC_LOG_FILTER_LEVEL);
+    const struct {
+        TextKey key;
+        LogLevel minLevel;
+    } levels[] = {
+        {"log.filter.level.all", LogLevel::Debug},
+        {"log.filter.level.info", LogLevel::Info},
+        {"log.filter.level.warning", LogLevel::Warning},
+        {"log.filter.level.error", LogLevel::Error},
+    };
+    for (const auto& level : levels) {
+        const int item = ComboBox_AddString(
+            hLevel, i18n.GetTranslationW(level.key).data());
+        ComboBox_SetItemData(hLevel, item, static_cast<int>(level.minLevel));
+    }
+    ComboBox_SetCurSel(hLevel, 0);
+
+    HWND hTrigger = GetDlgItem(hDlg, IDC_LOG_FILTER_TRIGGER);
+    int item = ComboBox_AddString(
+        hTrigger, i18n.GetTranslationW("log.filter.trigger.any").data());
+    ComboBox_SetItemData(hTrigger, item, LogFilterIndex::kAnyTrigger);
+    for (int i = 0; i < static_cast<int>(MuteTrigger::Count); ++i) {
+        item = ComboBox_AddString(hTrigger,
+                                  MuteLatencyStats::TriggerToString(
+                                      static_cast<MuteTrigger>(i)));
+        ComboBox_SetItemData(hTrigger, item, i);
+    }
+    ComboBox_SetCurSel(hTrigger, 0);
+
+    Edit_SetCueBannerText(
+        GetDlgItem(hDlg, IDC_LOG_FILTER_TEXT),
+        i18n.GetTranslationW("log.filter.search-hint").data());
+}
+
+static void SetupLogList(LogDlgData& data)
+{
+    ListView_SetExtendedListViewStyle(
+        data.hLogContent, LVS_EX_FULLROWSELECT | LVS_EX_DOUBLEBUFFER);
+
+    WMi18n& i18n = WMi18n::GetInstance();
+    const std::wstring_view titles[LOG_COLUMN_COUNT] = {
+        i18n.GetTranslationW("log.column.time"),
+        i18n.GetTranslationW("log.column.level"),
+        i18n.GetTranslationW("log.column.message")};
+    const int widths[LOG_COLUMN_COUNT] = {150, 65, 400};
+
+    LVCOLUMN lvCol{};
+    lvCol.mask = LVCF_FMT | LVCF_TEXT | LVCF_WIDTH | LVCF_ORDER;
+    lvCol.fmt = LVCFMT_LEFT;
+    for (int i = 0; i < LOG_COLUMN_COUNT; ++i) {
+        lvCol.cx = widths[i];
+        lvCol.pszText = const_cast<LPWSTR>(titles[i].data());
+        lvCol.cchTextMax = static_cast<int>(titles[i].length());
+        lvCol.iOrder = i;
+        ListView_InsertColumn(data.hLogContent, i, &lvCol);
+    }
+    UpdateSortArrows(data);
+}
+
+// The search box takes the width left of the filter bar, the list everything
+// below it.
+static void ResizeLogList(HWND hDlg, const LogDlgData& data)
+{
+    RECT rcClient;
+    GetClientRect(hDlg, &rcClient);
+    HWND hText = GetDlgItem(hDlg, IDC_LOG_FILTER_TEXT);
+    RECT rcText;
+    GetWindowRect(hText, &rcText);
+    MapWindowPoints(nullptr, hDlg, reinterpret_cast<POINT*>(&rcText), 2);
+    const LONG margin = rcText.top;
+    SetWindowPos(hText, nullptr, 0, 0,
+                 std::max(rcClient.right - margin - rcText.left, 0L),
+                 rcText.bottom - rcText.top, SWP_NOZORDER | SWP_NOMOVE);
+    const LONG listTop = rcText.bottom + margin;
+    SetWindowPos(data.hLogContent, nullptr, 0, listTop,
+                 rcClient.right - rcClient.left,
+                 std::max(rcClient.bottom - listTop, 0L), SWP_NOZORDER);
+    ListView_SetColumnWidth(data.hLogContent, LOG_COLUMN_MESSAGE,
+                            LVSCW_AUTOSIZE_USEHEADER);
+}
+
+static INT_PTR OnLogListNotify(HWND hDlg, LogDlgData& data,
+                               const NMHDR* pnmh)
+{
+    switch (pnmh->code) {
+        case LVN_GETDISPINFO: {
+            auto* dispInfo =
+                reinterpret_cast<NMLVDISPINFO*>(const_cast<NMHDR*>(pnmh));
+            LVITEM& item = dispInfo->item;
+            if ((item.mask & LVIF_TEXT) == 0 || item.cchTextMax <= 0) {
+                return TRUE;
+            }
+            item.pszText[0] = L'\0';
+            if (item.iItem >= 0 &&
+                static_cast<size_t>(item.iItem) < data.rows.size() &&
+                item.iSubItem >= 0 && item.iSubItem < LOG_COLUMN_COUNT &&
+                FormatRow(data, data.rows[item.iItem].seq))
+            {
+                wcsncpy_s(item.pszText, item.cchTextMax,
+                          data.cachedText[item.iSubItem].c_str(), _TRUNCATE);
+            }
+            return TRUE;
+        }
+        case LVN_COLUMNCLICK: {
+            const auto* nmList = reinterpret_cast<const NMLISTVIEW*>(pnmh);
+            if (nmList->iSubItem == data.sortColumn) {
+                data.sortAscending = !data.sortAscending;
+            } else {
+                data.sortColumn = nmList->iSubItem;
+                data.sortAscending = true;
+            }
+            SortRows(data);
+            UpdateSortArrows(data);
+            InvalidateRect(data.hLogContent, nullptr, FALSE);
+            return TRUE;
+        }
+        case LVN_KEYDOWN: {
+            const auto* keyDown = reinterpret_cast<const NMLVKEYDOWN*>(pnmh);
+            if (keyDown->wVKey == 'C' && GetKeyState(VK_CONTROL) < 0) {
+                CopySelectedRows(hDlg, data);
+            }
+            return TRUE;
+        }
+        default:
+            break;
+    }
+    return FALSE;
+}
+
 static INT_PTR CALLBACK LogDlgProc(HWND hDlg, UINT msg, WPARAM wParam,
                                    LPARAM lParam)
 {
@@ -56,62 +561,92 @@ static INT_PTR CALLBACK LogDlgProc(HWND hDlg, UINT msg, WPARAM wParam,
             hLogDlg_ = hDlg;
 
             WMi18n& i18n = WMi18n::GetInstance();
-            SetWindowText(hDlg, i18n.GetTranslationW("log.title").c_str());
+            SetWindowText(hDlg, i18n.GetTranslationW("log.title").data());
+
+            AddMuteLatencyMenuItems(hDlg);
 
             HICON hIcon = LoadIcon(GetModuleHandle(nullptr),
                                    MAKEINTRESOURCE(IDI_TRAY_DARK));
             SendMessageW(hDlg, WM_SETICON, ICON_BIG,
                          reinterpret_cast<LPARAM>(hIcon));
 
-            auto& wmLog = WMLog::GetInstance();
-            const auto logMessages = wmLog.GetLogMessages();
-            std::wstring logText;
-            logText.reserve(logMessages.size() * 30);
-            for (auto& lm : logMessages) {
-                logText.append(wmLog.FormatLogMessage(lm, true));
-            }
-
             dlgData->hLogContent = GetDlgItem(hDlg, IDC_LOG_CONTENT);
-            Edit_SetText(dlgData->hLogContent, logText.c_str());
-            Edit_SetSel(dlgData->hLogContent, static_cast<WPARAM>(-1), 0);
-            wmLog.RegisterForLogUpdates(hDlg);
-            SetFocus(dlgData->hLogContent);
-
+            SetupFilterBar(hDlg);
+            SetupLogList(*dlgData);
             // Initial sizing
-            RECT rcClient;
-            GetClientRect(hDlg, &rcClient);
-            SetWindowPos(dlgData->hLogContent, nullptr, 0, 0,
-                         rcClient.right - rcClient.left,
-                         rcClient.bottom - rcClient.top, SWP_NOZORDER);
+            ResizeLogList(hDlg, *dlgData);
+
+            // Register first, so no message falls between the initial fill
+            // and the first update.
+            WMLog::GetInstance().RegisterForLogUpdates(hDlg);
+            UpdateRows(*dlgData);
+            SetFocus(dlgData->hLogContent);
             return FALSE;
         }
         case WM_COMMAND:
-            return 0;
+            if (dlgData == nullptr) {
+                return FALSE;
+            }
+            switch (LOWORD(wParam)) {
+                case IDC_LOG_FILTER_LEVEL:
+                case IDC_LOG_FILTER_TRIGGER:
+                    if (HIWORD(wParam) == CBN_SELCHANGE) {
+                        ApplyFilter(hDlg, *dlgData);
+                        return TRUE;
+                    }
+                    break;
+                case IDC_LOG_FILTER_TEXT:
+                    if (HIWORD(wParam) == EN_CHANGE) {
+                        ApplyFilter(hDlg, *dlgData);
+                        return TRUE;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            return FALSE;
+        case WM_SYSCOMMAND:
+            if ((wParam & 0xFFF0) == IDM_LOG_SHOW_MUTE_LATENCY) {
+                MuteLatencyStats::GetInstance().LogReport();
+                return TRUE;
+            } else if ((wParam & 0xFFF0) == IDM_LOG_EXPORT_MUTE_LATENCY) {
+                ExportMuteLatency(hDlg);
+                return TRUE;
+            }
+            return FALSE;
         case WM_SIZE: {
             // WM_SIZE arrives before WM_INITDIALOG, when dlgData is not set yet
             if (dlgData == nullptr) {
                 return 0;
             }
-            RECT rcClient;
-            GetClientRect(hDlg, &rcClient);
-            SetWindowPos(dlgData->hLogContent, nullptr, 0, 0,
-                         rcClient.right - rcClient.left,
-                         rcClient.bottom - rcClient.top, SWP_NOZORDER);
+            ResizeLogList(hDlg, *dlgData);
             return 0;
         }
-        case WM_LOG_UPDATED: {
-            const WMLog& wmLog = WMLog::GetInstance();
-            auto logMsg = reinterpret_cast<LogMessage*>(lParam);
-            if (dlgData == nullptr || logMsg == nullptr) {
+        case WM_NOTIFY: {
+            const NMHDR* pnmh = reinterpret_cast<const NMHDR*>(lParam);
+            if (dlgData == nullptr || pnmh->idFrom != IDC_LOG_CONTENT) {
                 return FALSE;
             }
-            const auto formattedMsg = wmLog.FormatLogMessage(*logMsg, true);
-            const auto textLen = Edit_GetTextLength(dlgData->hLogContent);
-            Edit_SetSel(dlgData->hLogContent, textLen, textLen);
-            Edit_ReplaceSel(dlgData->hLogContent, formattedMsg.c_str());
-            return TRUE;
+            return OnLogListNotify(hDlg, *dlgData, pnmh);
         }
+        case WM_LOG_UPDATED:
+            if (dlgData != nullptr && !dlgData->updatePending) {
+                dlgData->updatePending = true;
+                SetTimer(hDlg, LOG_UPDATE_TIMER_ID, LOG_UPDATE_INTERVAL_MS,
+                         nullptr);
+            }
+            return TRUE;
+        case WM_TIMER:
+            if (wParam == LOG_UPDATE_TIMER_ID && dlgData != nullptr) {
+                KillTimer(hDlg, LOG_UPDATE_TIMER_ID);
+                dlgData->updatePending = false;
+                WMLog::GetInstance().AcknowledgeLogUpdate(hDlg);
+                UpdateRows(*dlgData);
+                return TRUE;
+            }
+            return FALSE;
         case WM_DESTROY:
+            KillTimer(hDlg, LOG_UPDATE_TIMER_ID);
             delete dlgData;
             SetWindowLongPtrW(hDlg, DWLP_USER, 0);
             WMLog::GetInstance().UnregisterForLogUpdates(hDlg);
@@ -0,0 +1,211 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Which records of the log history match a filter (minimum level, trigger,
+// substring), kept up to date as records come and go:
+//
+//  - A new record is tested against the active filter once, in Add(): two
+//    integer compares and one search through its own text.
+//  - Narrowing the filter (typing more characters, raising the level, picking
+//    a trigger) only re-tests the current matches. Anything else re-tests
+//    every record, which needs no formatting either: the index keeps each
+//    record's text in folded (lower) case.
+//
+// Records must be added in sequence order. Not thread-safe.
+class LogFilterIndex {
+   public:
+    static constexpr int kAnyTrigger = -1;
+
+    struct Filter {
+        int minLevel = 0;
+        int trigger = kAnyTrigger;
+        // Must be folded already, see Fold().
+        std::wstring text;
+    };
+
+    using FoldFn = void (*)(std::wstring& text);
+
+    // `fold` maps text to the form substrings are compared in. The default
+    // only folds ASCII letters.
+    explicit LogFilterIndex(FoldFn fold = FoldAscii) : fold_(fold) {}
+
+    void Fold(std::wstring& text) const
+    {
+        fold_(text);
+    }
+
+    // `trigger` is kAnyTrigger if the record has none. Returns whether the
+    // record matches the active filter.
+    bool Add(std::uint64_t seq, int level, int trigger, std::wstring text)
+    {
+        fold_(text);
+        records_.push_back({seq, level, trigger, std::move(text)});
+        if (!Matches(filter_, records_.back())) {
+            return false;
+        }
+        matches_.push_back(seq);
+        return true;
+    }
+
+    // Forgets all records before `firstSeq`.
+    void Evict(std::uint64_t firstSeq)
+    {
+        while (!records_.empty() && records_.front().seq < firstSeq) {
+            records_.pop_front();
+        }
+        const auto end =
+            std::lower_bound(matches_.begin(), matches_.end(), firstSeq);
+        matches_.erase(matches_.begin(), end);
+    }
+
+    void Clear()
+    {
+        records_.clear();
+        matches_.clear();
+    }
+
+    // Returns false if the filter did not change.
+    bool SetFilter(const Filter& filter)
+    {
+        if (filter.minLevel == filter_.minLevel &&
+            filter.trigger == filter_.trigger && filter.text == filter_.text)
+        {
+            return false;
+        }
+        if (IsNarrowing(filter)) {
+            std::size_t kept = 0;
+            auto record = records_.begin();
+            for (const auto seq : matches_) {
+                // Both are in sequence order, so one pass finds every record.
+                while (record->seq != seq) {
+                    ++record;
+                }
+                if (Matches(filter, *record)) {
+                    matches_[kept++] = seq;
+                }
+            }
+            matches_.resize(kept);
+        } else {
+            matches_.clear();
+            for (const auto& record : records_) {
+                if (Matches(filter, record)) {
+                    matches_.push_back(record.seq);
+                }
+            }
+        }
+        filter_ = filter;
+        return true;
+    }
+
+    const Filter& GetFilter() const
+    {
+        return filter_;
+    }
+
+    bool IsFiltering() const
+    {
+        return filter_.minLevel > 0 || filter_.trigger != kAnyTrigger ||
+               !filter_.text.empty();
+    }
+
+    // Sequence numbers of the matching records, ascending.
+    const std::vector<std::uint64_t>& GetMatches() const
+    {
+        return matches_;
+    }
+
+    // Level the record was added with, or -1 if it is not stored.
+    int GetLevel(std::uint64_t seq) const
+    {
+        const auto it = std::lower_bound(
+            records_.begin(), records_.end(), seq,
+            [](const Record& record, std::uint64_t s) {
+                return record.seq < s;
+            });
+        return it != records_.end() && it->seq == seq ? it->level : -1;
+    }
+
+    std::size_t Size() const
+    {
+        return records_.size();
+    }
+
+    static void FoldAscii(std::wstring& text)
+    {
+        for (auto& c : text) {
+            if (c >= L'A' && c <= L'Z') {
+                c = static_cast<wchar_t>(c - L'A' + L'a');
+            }
+        }
+    }
+
+   private:
+    struct Record {
+        std::uint64_t seq;
+        int level;
+        int trigger;
+        std::wstring text;
+    };
+
+    static bool Matches(const Filter& filter, const Record& record)
+    {
+        return record.level >= filter.minLevel &&
+               (filter.trigger == kAnyTrigger ||
+                record.trigger == filter.trigger) &&
+               (filter.text.empty() ||
+                record.text.find(filter.text) != std::wstring::npos);
+    }
+
+    // Everything `filter` matches is matched by the active filter, too.
+    bool IsNarrowing(const Filter& filter) const
+    {
+        return filter.minLevel >= filter_.minLevel &&
+               (filter_.trigger == kAnyTrigger ||
+                filter.trigger == filter_.trigger) &&
+               filter.text.find(filter_.text) != std::wstring::npos;
+    }
+
+    FoldFn fold_;
+    Filter filter_;
+    std::deque<Record> records_;
+    std::vector<std::uint64_t> matches_;
+};
@@ -0,0 +1,115 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-capacity history of the most recent entries. All storage is allocated
+// up front; appending overwrites the oldest entry once the ring is full.
+// Every entry gets a sequence number that grows by one per append, so readers
+// can ask for "everything after the last entry I have seen" and detect what
+// was overwritten in the meantime. Not thread-safe.
+template <typename Entry>
+class LogRing {
+   public:
+    // `capacity` must be a power of two.
+    explicit LogRing(std::size_t capacity)
+        : entries_(capacity), mask_(capacity - 1)
+    {
+        assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+    }
+
+    // Returns the slot for the next entry, to be filled in place, and its
+    // sequence number in `seq`.
+    Entry& Append(std::uint64_t& seq)
+    {
+        seq = endSeq_++;
+        return entries_[seq & mask_];
+    }
+
+    // Sequence number of the oldest entry still stored.
+    std::uint64_t FirstSeq() const
+    {
+        return endSeq_ > entries_.size() ? endSeq_ - entries_.size() : 0;
+    }
+
+    // Sequence number the next entry will get.
+    std::uint64_t EndSeq() const
+    {
+        return endSeq_;
+    }
+
+    // nullptr if the entry was overwritten already or not appended yet.
+    const Entry* Find(std::uint64_t seq) const
+    {
+        if (seq < FirstSeq() || seq >= endSeq_) {
+            return nullptr;
+        }
+        return &entries_[seq & mask_];
+    }
+
+    // Calls fn(seq, entry) for the stored entries in [from, to), oldest
+    // first. The range is clamped to what is still stored.
+    template <typename Fn>
+    void ForEach(std::uint64_t from, std::uint64_t to, Fn&& fn) const
+    {
+        if (from < FirstSeq()) {
+            from = FirstSeq();
+        }
+        if (to > endSeq_) {
+            to = endSeq_;
+        }
+        for (std::uint64_t seq = from; seq < to; ++seq) {
+            fn(seq, entries_[seq & mask_]);
+        }
+    }
+
+    std::size_t Size() const
+    {
+        return static_cast<std::size_t>(endSeq_ - FirstSeq());
+    }
+
+    std::size_t Capacity() const
+    {
+        return entries_.size();
+    }
+
+   private:
+    std::vector<Entry> entries_;
+    std::uint64_t mask_;
+    std::uint64_t endSeq_ = 0;
+};
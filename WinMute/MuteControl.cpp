@@ -35,17 +35,8 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #include "common.h"
 
-extern HINSTANCE hglobInstance;
-
-static constexpr int BLUETOOTH_RECONNECT_UNMUTE_DELAY = 5000;  // Milliseconds
-static constexpr int MUTE_DELAY_MAGIC_VALUE = 0x198604;
-
-// Fixed timer IDs: SetTimer with an ID of 0 returns a value that is not
-// guaranteed to be the timer's actual ID, which breaks the later KillTimer.
-static constexpr UINT_PTR DELAYED_MUTE_TIMER_ID = 190501;
-static constexpr UINT_PTR BLUETOOTH_UNMUTE_TIMER_ID = 190502;
-
-static const wchar_t* MUTECONTROL_CLASS_NAME = L"WinMuteMuteControl";
+static constexpr auto BLUETOOTH_RECONNECT_UNMUTE_DELAY =
+    std::chrono::milliseconds(5000);
 
 const wchar_t* MuteControl::MuteTypeToString(MuteType type)
 {
@@ -72,101 +63,75 @@ const wchar_t* MuteControl::MuteTypeToString(MuteType type)
     }
 }
 
-void CALLBACK DelayedMuteTimerProc(HWND hWnd, UINT, UINT_PTR, DWORD)
+MuteTrigger MuteControl::MuteTypeToTrigger(MuteType type)
 {
-    MuteControl* muteCtrl =
-        reinterpret_cast<MuteControl*>(GetWindowLongPtrW(hWnd, GWLP_USERDATA));
-    if (muteCtrl != nullptr) {
-        muteCtrl->MuteDelayed(MUTE_DELAY_MAGIC_VALUE);
-    }
-}
-
-static void CALLBACK BluetoothUnmuteTimerProc(HWND hWnd, UINT, UINT_PTR id,
-                                              DWORD)
-{
-    KillTimer(hWnd, id);
-    MuteControl* muteCtrl =
-        reinterpret_cast<MuteControl*>(GetWindowLongPtrW(hWnd, GWLP_USERDATA));
-    if (muteCtrl != nullptr) {
-        muteCtrl->CompleteVolumeRestore();
+    switch (type) {
+        case MuteTypeWorkstationLock:
+            return MuteTrigger::WorkstationLock;
+        case MuteTypeRemoteSession:
+            return MuteTrigger::RemoteSession;
+        case MuteTypeDisplayStandby:
+            return MuteTrigger::DisplayStandby;
+        case MuteTypeLidClose:
+            return MuteTrigger::LidClose;
+        case MuteTypeBluetoothDisconnect:
+            return MuteTrigger::BluetoothDisconnect;
+        case MuteTypeLogout:
+            return MuteTrigger::Logout;
+        case MuteTypeSuspend:
+            return MuteTrigger::Suspend;
+        case MuteTypeShutdown:
+            return MuteTrigger::Shutdown;
+        case MuteTypeCount:
+        default:
+            return MuteTrigger::Count;
     }
 }
 
-static LRESULT CALLBACK MuteControlWndProc(HWND hWnd, UINT msg, WPARAM wParam,
-                                           LPARAM lParam)
+std::optional<MuteCondition> MuteControl::MuteTypeToCondition(MuteType type)
 {
-    auto wm =
-        reinterpret_cast<MuteControl*>(GetWindowLongPtr(hWnd, GWLP_USERDATA));
-    switch (msg) {
-        case WM_NCCREATE: {
-            LPCREATESTRUCTW cs = reinterpret_cast<LPCREATESTRUCTW>(lParam);
-            SetWindowLongPtrW(hWnd, GWLP_USERDATA,
-                              reinterpret_cast<LONG_PTR>(cs->lpCreateParams));
-            return TRUE;
-        }
+    switch (type) {
+        case MuteTypeWorkstationLock:
+            return MuteCondition::WorkstationLocked;
+        case MuteTypeRemoteSession:
+            return MuteCondition::RemoteSession;
+        case MuteTypeDisplayStandby:
+            return MuteCondition::DisplayOff;
+        case MuteTypeLidClose:
+            return MuteCondition::LidClosed;
+        case MuteTypeBluetoothDisconnect:
+            return MuteCondition::BluetoothDisconnected;
         default:
-            break;
+            return std::nullopt;
     }
-    return (wm) ? wm->WindowProc(hWnd, msg, wParam, lParam)
-                : DefWindowProcW(hWnd, msg, wParam, lParam);
 }
 
 MuteControl::MuteControl()
+    : muteConfig_(MuteTypeCount), hysteresis_(MuteTypeCount)
 {
-    MuteConfig initMuteConf;
-    initMuteConf.active = false;
-    initMuteConf.shouldMute = false;
-    for (int i = 0; i < MuteTypeCount; ++i) {
-        muteConfig_.push_back(initMuteConf);
-    }
 }
 
 MuteControl::~MuteControl()
 {
-    if (hMuteCtrlWnd_ != nullptr) {
-        DestroyWindow(hMuteCtrlWnd_);
-        hMuteCtrlWnd_ = nullptr;
+    if (scheduler_ != nullptr) {
+        scheduler_->Cancel(delayedMuteTimer_);
+        scheduler_->Cancel(bluetoothUnmuteTimer_);
     }
-    UnregisterClassW(MUTECONTROL_CLASS_NAME, hglobInstance);
 }
 
-bool MuteControl::Init(HWND hParent, const TrayIcon* trayIcon)
+bool MuteControl::Init(HWND hParent, const TrayIcon* trayIcon,
+                       TimerScheduler* scheduler)
 {
-    WNDCLASSEXW wndClass{0};
-    wndClass.cbSize = sizeof(wndClass);
-    wndClass.lpfnWndProc = MuteControlWndProc;
-    wndClass.hInstance = hglobInstance;
-    wndClass.lpszClassName = MUTECONTROL_CLASS_NAME;
-    if (!RegisterClassExW(&wndClass)) {
-        WMLog::GetInstance().LogWinError(L"RegisterClassEx");
-        return false;
-    }
-    hMuteCtrlWnd_ =
-        CreateWindowEx(WS_EX_TOOLWINDOW, MUTECONTROL_CLASS_NAME, L"", 0, 0, 0,
-                       0, 0, nullptr, nullptr, hglobInstance, this);
-    if (hMuteCtrlWnd_ == nullptr) {
-        WMLog::GetInstance().LogWinError(L"CreateWindowEx");
-        UnregisterClassW(MUTECONTROL_CLASS_NAME, hglobInstance);
-        return false;
-    }
     winAudio_ = std::make_unique<VistaAudio>();
     if (!winAudio_->Init(hParent)) {
-        DestroyWindow(hMuteCtrlWnd_);
-        hMuteCtrlWnd_ = nullptr;
-        UnregisterClassW(MUTECONTROL_CLASS_NAME, hglobInstance);
         return false;
     }
 
     trayIcon_ = trayIcon;
+    scheduler_ = scheduler;
     return true;
 }
 
-LRESULT CALLBACK MuteControl::WindowProc(HWND hWnd, UINT msg, WPARAM wParam,
-                                         LPARAM lParam)
-{
-    return DefWindowProc(hWnd, msg, wParam, lParam);
-}
-
 void MuteControl::SetMute(bool mute)
 {
     WMLog::GetInstance().LogInfo(L"Manual muting: {}", mute ? L"on" : L"off");
@@ -187,23 +152,56 @@ bool MuteControl::ToggleMute()
     return mute;
 }
 
-void MuteControl::SaveMuteStatus()
+MuteControl::MuteSnapshot MuteControl::TakeSnapshot()
 {
-    const bool alreadySaved = std::any_of(
-        muteConfig_.begin(), muteConfig_.end(),
-        [](const MuteConfig& conf) { return conf.shouldMute && conf.active; });
+    WMLog::GetInstance().LogInfo(L"Saving mute status");
+    return MuteSnapshot{.generation = winAudio_->SaveMuteStatus()};
+}
 
-    if (alreadySaved) {
+MuteControl::SnapshotPtr MuteControl::TakeInheritableSnapshot()
+{
+    SnapshotPtr snapshot = std::exchange(preSaved_, nullptr);
+    if (scheduler_->Cancel(bluetoothUnmuteTimer_)) {
+        // Restoring now would unmute in the middle of the new event, which
+        // instead restores this state once it is over.
+        bluetoothUnmuteTimer_ = 0;
         WMLog::GetInstance().LogInfo(
-            L"Muting event already active. Skipping status save");
-    } else {
-        WMLog::GetInstance().LogInfo(L"Saving mute status");
-        winAudio_->SaveMuteStatus();
+            L"Cancelled pending restore after Bluetooth delay");
+        snapshot = std::exchange(pendingRestore_, nullptr);
     }
+    return snapshot;
 }
 
-void MuteControl::ShowNotification(const std::wstring& title,
-                                   const std::wstring& text)
+void MuteControl::OpenScope(MuteTrigger scope, SnapshotPtr inherit)
+{
+    WMLog& log = WMLog::GetInstance();
+    const auto result = scopes_.Open(
+        scope, [this] { return TakeSnapshot(); }, std::move(inherit));
+    if (result == Scopes::OpenResult::Joined) {
+        log.LogInfo(L"Muting event already active. Skipping status save");
+    } else if (result == Scopes::OpenResult::Inherited) {
+        log.LogInfo(L"Reusing the mute status saved before \"{}\"",
+                    MuteLatencyStats::TriggerToString(scope));
+    }
+}
+
+void MuteControl::CloseScope(MuteTrigger scope, bool withDelay)
+{
+    if (!scopes_.IsOpen(scope)) {
+        return;
+    }
+    SnapshotPtr snapshot = scopes_.Close(scope);
+    if (snapshot == nullptr) {
+        WMLog::GetInstance().LogInfo(
+            L"Skipping restore since mute event \"{}\" is currently active",
+            MuteLatencyStats::TriggerToString(scopes_.OpenScopes().front()));
+        return;
+    }
+    RestoreVolume(std::move(snapshot), withDelay);
+}
+
+void MuteControl::ShowNotification(std::wstring_view title,
+                                   std::wstring_view text)
 {
     if (notificationsEnabled_ && trayIcon_ != nullptr) {
         trayIcon_->ShowPopup(title, text);
@@ -215,82 +213,84 @@ void MuteControl::SetNotifications(bool enable)
     notificationsEnabled_ = enable;
 }
 
-void MuteControl::MuteDelayed(int magic)
+std::chrono::milliseconds MuteControl::GetMuteDelay() const
 {
-    if (magic != MUTE_DELAY_MAGIC_VALUE || delayedMuteTimerId_ == 0) {
-        return;
-    }
-    WMLog::GetInstance().LogInfo(L"Muting workstation after delay");
-    MuteNow();
-    KillTimer(hMuteCtrlWnd_, delayedMuteTimerId_);
-    delayedMuteTimerId_ = 0;
+    return std::max<std::chrono::milliseconds>(
+        std::chrono::seconds(muteDelaySeconds_), muteGracePeriod_);
 }
 
-bool MuteControl::StartDelayedMute()
+void MuteControl::MuteDelayed(MuteTrigger trigger)
 {
-    if (SetTimer(hMuteCtrlWnd_, DELAYED_MUTE_TIMER_ID, muteDelaySeconds_ * 1000,
-                 DelayedMuteTimerProc) == 0)
-    {
-        WMLog::GetInstance().LogWinError(L"SetTimer", GetLastError());
-        delayedMuteTimerId_ = 0;
-    } else {
-        delayedMuteTimerId_ = DELAYED_MUTE_TIMER_ID;
+    delayedMuteTimer_ = 0;
+    // Only the first scope to open can use it, the others join that one.
+    SnapshotPtr inherit = TakeInheritableSnapshot();
+    hysteresis_.TakePending([&](size_t type) {
+        OpenScope(MuteTypeToTrigger(static_cast<MuteType>(type)),
+                  std::move(inherit));
+        inherit = nullptr;
+    });
+    // The configured delay is intentional, so latency is measured from the
+    // moment the timer fires.
+    MuteNow(trigger, MuteLatencyStats::Clock::now());
+    WMLog::GetInstance().LogInfo(L"Mute delay of {} ms elapsed",
+                                 GetMuteDelay().count());
+}
+
+bool MuteControl::StartDelayedMute(MuteTrigger trigger)
+{
+    scheduler_->Cancel(delayedMuteTimer_);
+    delayedMuteTimer_ = scheduler_->Schedule(
+        GetMuteDelay(), [this, trigger] { MuteDelayed(trigger); });
+    if (delayedMuteTimer_ == 0) {
+        WMLog::GetInstance().LogError(L"Failed to schedule delayed mute");
     }
-    return delayedMuteTimerId_ != 0;
+    return delayedMuteTimer_ != 0;
 }
 
-void MuteControl::RestoreVolume(bool withDelay)
+void MuteControl::RestoreVolume(SnapshotPtr snapshot, bool withDelay)
 {
     WMLog& log = WMLog::GetInstance();
     if (!restoreVolume_) {
         log.LogInfo(L"Volume Restore has been disabled");
+        if (snapshot->unmuteAll) {
+            winAudio_->SetMute(false);
+        }
         return;
     }
-    const auto blocking =
-        std::find_if(muteConfig_.begin(), muteConfig_.end(),
-                     [](const MuteConfig& conf) {
-                         return conf.shouldMute && conf.active;
-                     });
-    if (blocking != muteConfig_.end()) {
-        log.LogInfo(
-            L"Skipping restore since mute event \"{}\" is currently active",
-            MuteTypeToString(static_cast<MuteType>(
-                std::distance(muteConfig_.begin(), blocking))));
-    } else if (delayedMuteTimerId_ != 0) {
-        KillTimer(hMuteCtrlWnd_, delayedMuteTimerId_);
-        delayedMuteTimerId_ = 0;
-        log.LogInfo(
-            L"Skipping restore, since delayed mute was not triggered yet");
-    } else if (withDelay) {
-        log.LogInfo(L"Restoring previous mute state after Bluetooth delay");
-        ShowNotification(WMi18n::GetInstance().GetTranslationW(
-                             "popup.volume-restored.title"),
-                         WMi18n::GetInstance().GetTranslationW(
-                             "popup.volume-restored.text"));
-        if (SetTimer(hMuteCtrlWnd_, BLUETOOTH_UNMUTE_TIMER_ID,
-                     BLUETOOTH_RECONNECT_UNMUTE_DELAY,
-                     BluetoothUnmuteTimerProc) == 0)
-        {
-            log.LogWinError(L"SetTimer (Bluetooth unmute delay)");
-            bluetoothUnmuteTimerId_ = 0;
-            CompleteVolumeRestore();  // fall back to immediate restore
-        } else {
-            bluetoothUnmuteTimerId_ = BLUETOOTH_UNMUTE_TIMER_ID;
+    ShowNotification(
+        WMi18n::GetInstance().GetTranslationW("popup.volume-restored.title"),
+        WMi18n::GetInstance().GetTranslationW("popup.volume-restored.text"));
+    if (withDelay) {
+        log.LogEvent(LogLevel::Info, {LogEventCode::Restore},
+                     L"Restoring previous mute state after Bluetooth delay");
+        scheduler_->Cancel(bluetoothUnmuteTimer_);
+        pendingRestore_ = std::move(snapshot);
+        bluetoothUnmuteTimer_ =
+            scheduler_->Schedule(BLUETOOTH_RECONNECT_UNMUTE_DELAY, [this] {
+                CompleteVolumeRestore(std::exchange(pendingRestore_, nullptr));
+            });
+        if (bluetoothUnmuteTimer_ == 0) {
+            log.LogError(L"Failed to schedule Bluetooth unmute delay");
+            // fall back to immediate restore
+            CompleteVolumeRestore(std::exchange(pendingRestore_, nullptr));
         }
     } else {
-        log.LogInfo(L"Restoring previous mute state");
-        ShowNotification(WMi18n::GetInstance().GetTranslationW(
-                             "popup.volume-restored.title"),
-                         WMi18n::GetInstance().GetTranslationW(
-                             "popup.volume-restored.text"));
-        CompleteVolumeRestore();
+        log.LogEvent(LogLevel::Info, {LogEventCode::Restore},
+                     L"Restoring previous mute state");
+        CompleteVolumeRestore(std::move(snapshot));
     }
 }
 
-void MuteControl::CompleteVolumeRestore()
+void MuteControl::CompleteVolumeRestore(SnapshotPtr snapshot)
 {
-    bluetoothUnmuteTimerId_ = 0;
-    winAudio_->RestoreMuteStatus();
+    bluetoothUnmuteTimer_ = 0;
+    if (snapshot->unmuteAll) {
+        WMLog::GetInstance().LogInfo(
+            L"Quiet hours ended during the mute event, unmuting");
+        winAudio_->SetMute(false);
+    } else {
+        winAudio_->RestoreMuteStatus(snapshot->generation);
+    }
     if (mediaConfig_.tryResume) {
         // Only resumes if a previous RequestPause actually paused the session.
         mediaController_.RequestResume();
@@ -307,6 +307,11 @@ void MuteControl::SetMuteDelay(int delaySeconds)
     muteDelaySeconds_ = delaySeconds;
 }
 
+void MuteControl::SetMuteGracePeriod(std::chrono::milliseconds gracePeriod)
+{
+    muteGracePeriod_ = gracePeriod;
+}
+
 void MuteControl::SetMuteOnWorkstationLock(bool enable)
 {
     muteConfig_[MuteTypeWorkstationLock].shouldMute = enable;
@@ -346,6 +351,11 @@ void MuteControl::SetMuteOnBluetoothDisconnect(bool enable)
     muteConfig_[MuteTypeBluetoothDisconnect].shouldMute = enable;
 }
 
+void MuteControl::SetMuteOnWlan(bool enable)
+{
+    muteOnWlan_ = enable;
+}
+
 void MuteControl::SetMuteTryPauseMedia(bool enable)
 {
     mediaConfig_.tryPause = enable;
@@ -401,129 +411,305 @@ bool MuteControl::GetMuteOnShutdown() const
     return muteConfig_[MuteTypeShutdown].shouldMute;
 }
 
-void MuteControl::MuteNow()
+static LogEventInfo TriggerEvent(MuteTrigger trigger, bool active)
+{
+    LogEventInfo event;
+    event.code = active ? LogEventCode::TriggerStart : LogEventCode::TriggerEnd;
+    event.trigger = MuteLatencyStats::TriggerToString(trigger);
+    return event;
+}
+
+static LogEventInfo MutedEvent(MuteTrigger trigger,
+                               std::chrono::microseconds latency)
+{
+    LogEventInfo event;
+    event.code = LogEventCode::Muted;
+    event.trigger = MuteLatencyStats::TriggerToString(trigger);
+    event.duration = latency;
+    return event;
+}
+
+void MuteControl::MuteEndpoints(MuteTrigger trigger, TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Muting workstation");
-    ShowNotification(
-        WMi18n::GetInstance().GetTranslationW("popup.muting-workstation.title"),
-        WMi18n::GetInstance().GetTranslationW("popup.muting-workstation.text"));
     winAudio_->SetMute(true);
+    const auto latency =
+        MuteLatencyStats::GetInstance().Record(trigger, received);
+    WMLog::GetInstance().LogEvent(LogLevel::Info, MutedEvent(trigger, latency),
+                                  L"Muted {} us after \"{}\" arrived",
+                                  latency.count(),
+                                  MuteLatencyStats::TriggerToString(trigger));
+}
+
+void MuteControl::MuteNow(MuteTrigger trigger, TimePoint received)
+{
+    using Clock = MuteLatencyStats::Clock;
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    // Only what is needed to silence the machine runs before the endpoints
+    // are muted; the balloon (translation lookups and Shell_NotifyIcon) and
+    // the log output can take a noticeable time on slow machines.
+    const auto start = Clock::now();
     if (mediaConfig_.tryPause) {
+        // Only queues the request, the pause itself runs on the media worker
+        // thread in parallel with muting the endpoints.
         mediaController_.RequestPause();
     }
+    const auto mediaDispatched = Clock::now();
+    winAudio_->SetMute(true);
+    const auto muted = Clock::now();
+    const auto latency =
+        MuteLatencyStats::GetInstance().Record(trigger, received, muted);
+
+    WMLog& log = WMLog::GetInstance();
+    log.LogEvent(LogLevel::Info, MutedEvent(trigger, latency),
+                 L"Muted workstation");
+    ShowNotification(
+        WMi18n::GetInstance().GetTranslationW("popup.muting-workstation.title"),
+        WMi18n::GetInstance().GetTranslationW("popup.muting-workstation.text"));
+    const auto notified = Clock::now();
+
+    // Info, so the stage timings also reach the log in release builds.
+    log.LogInfo(
+        L"Mute \"{}\" took {} us: before mute {} us, media dispatch {} us, "
+        L"endpoints {} us, notification {} us",
+        MuteLatencyStats::TriggerToString(trigger), latency.count(),
+        duration_cast<microseconds>(start - received).count(),
+        duration_cast<microseconds>(mediaDispatched - start).count(),
+        duration_cast<microseconds>(muted - mediaDispatched).count(),
+        duration_cast<microseconds>(notified - muted).count());
+}
+
+void MuteControl::SetMuteRules(MuteRuleSet rules)
+{
+    rules_ = std::move(rules);
+}
+
+void MuteControl::SetCondition(MuteCondition condition, bool active)
+{
+    if (active) {
+        conditions_ |= ConditionBit(condition);
+    } else {
+        conditions_ &= ~ConditionBit(condition);
+    }
+}
+
+bool MuteControl::ShouldMuteFor(MuteType type, ConditionSet conditions) const
+{
+    const auto condition = MuteTypeToCondition(type);
+    if (condition && rules_.HasRules(*condition)) {
+        return rules_.ShouldMute(*condition, conditions);
+    }
+    return muteConfig_[type].shouldMute;
 }
 
 void MuteControl::NotifyRestoreCondition(MuteType type, bool active,
-                                         bool withDelay)
+                                         TimePoint received, bool withDelay)
 {
+    WMLog& log = WMLog::GetInstance();
+    if (const auto condition = MuteTypeToCondition(type)) {
+        SetCondition(*condition, active);
+    }
+    const MuteTrigger scope = MuteTypeToTrigger(type);
     if (active) {
-        SaveMuteStatus();
-        muteConfig_[type].active = active;
-        if (muteConfig_[type].shouldMute) {
-            if (muteDelaySeconds_ == 0) {
-                MuteNow();
-            } else {
-                WMLog::GetInstance().LogInfo(L"Starting delayed mute timer...");
-                StartDelayedMute();
-            }
+        const auto action =
+            hysteresis_.Start(type, ShouldMuteFor(type, conditions_),
+                              GetMuteDelay().count() != 0);
+        if (action == MuteHysteresis::StartAction::None) {
+            return;
         }
-    } else {
-        if (!muteConfig_[type].active) {
-            WMLog::GetInstance().LogInfo(
-                L"Ignoring end of \"{}\": it was never seen as started",
-                MuteTypeToString(type));
-        } else {
-            muteConfig_[type].active = false;
-            if (muteConfig_[type].shouldMute) {
-                RestoreVolume(withDelay);
-            } else {
-                WMLog::GetInstance().LogInfo(
-                    L"Not restoring after \"{}\": muting for this event is"
-                    L" disabled",
-                    MuteTypeToString(type));
-            }
+        MuteTrigger trigger = scope;
+        const SnapshotPtr preSaved = preSaved_;
+        SnapshotPtr inherit = TakeInheritableSnapshot();
+        if (inherit != nullptr && inherit == preSaved &&
+            type == MuteTypeDisplayStandby)
+        {
+            trigger = MuteTrigger::DisplayStandbyPreSaved;
+        }
+        if (action == MuteHysteresis::StartAction::MuteNow) {
+            OpenScope(scope, std::move(inherit));
+            MuteNow(trigger, received);
+            return;
         }
+        // Nothing is saved or muted until the delay has passed. If there is a
+        // snapshot to share, the scope opens right away: that is free, and it
+        // holds back the restore of an event ending meanwhile.
+        scopes_.Join(scope, std::move(inherit));
+        if (action == MuteHysteresis::StartAction::Join) {
+            log.LogInfo(L"Joining pending mute");
+            return;
+        }
+        log.LogInfo(L"Starting delayed mute timer...");
+        if (!StartDelayedMute(trigger)) {
+            MuteDelayed(trigger);  // mute right away instead
+        }
+        return;
     }
+    switch (hysteresis_.End(type)) {
+        case MuteHysteresis::EndAction::Ignored:
+            log.LogInfo(L"Ignoring end of \"{}\": it was never seen as started",
+                        MuteTypeToString(type));
+            return;
+        case MuteHysteresis::EndAction::NotMuted:
+            log.LogInfo(L"Not restoring after \"{}\": this event did not mute",
+                        MuteTypeToString(type));
+            return;
+        case MuteHysteresis::EndAction::EndedPending:
+            log.LogInfo(L"\"{}\" ended before the mute delay",
+                        MuteTypeToString(type));
+            break;
+        case MuteHysteresis::EndAction::CancelledPending:
+            scheduler_->Cancel(delayedMuteTimer_);
+            delayedMuteTimer_ = 0;
+            log.LogInfo(L"\"{}\" ended before the mute delay: mute cancelled",
+                        MuteTypeToString(type));
+            break;
+        case MuteHysteresis::EndAction::Restore:
+            break;
+    }
+    // A pending event only has a scope if it joined one; closing it may still
+    // complete the restore of an event that ended meanwhile.
+    CloseScope(scope, withDelay);
 }
 
-void MuteControl::NotifyWorkstationLock(bool active)
+void MuteControl::NotifyWorkstationLock(bool active, TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Workstation Lock {}",
-                                 active ? L"start" : L"stop");
-    NotifyRestoreCondition(MuteTypeWorkstationLock, active);
+    WMLog::GetInstance().LogEvent(
+        LogLevel::Info, TriggerEvent(MuteTrigger::WorkstationLock, active),
+        L"Mute Event: Workstation Lock {}", active ? L"start" : L"stop");
+    NotifyRestoreCondition(MuteTypeWorkstationLock, active, received);
 }
 
-void MuteControl::NotifyRemoteSession(bool active)
+void MuteControl::NotifyRemoteSession(bool active, TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Remote Session {}",
-                                 active ? L"start" : L"stop");
-    NotifyRestoreCondition(MuteTypeRemoteSession, active);
+    WMLog::GetInstance().LogEvent(
+        LogLevel::Info, TriggerEvent(MuteTrigger::RemoteSession, active),
+        L"Mute Event: Remote Session {}", active ? L"start" : L"stop");
+    NotifyRestoreCondition(MuteTypeRemoteSession, active, received);
 }
 
-void MuteControl::NotifyDisplayStandby(bool active)
+void MuteControl::NotifyDisplayStandby(bool active, TimePoint received)
 {
-    if (displayWasOffOnce_ || active) {
-        WMLog::GetInstance().LogInfo(L"Mute Event: Display Standby {}",
-                                     active ? L"start" : L"stop");
-        NotifyRestoreCondition(MuteTypeDisplayStandby, active);
-        displayWasOffOnce_ = true;
-    }
+    WMLog::GetInstance().LogEvent(
+        LogLevel::Info, TriggerEvent(MuteTrigger::DisplayStandby, active),
+        L"Mute Event: Display Standby {}", active ? L"start" : L"stop");
+    NotifyRestoreCondition(MuteTypeDisplayStandby, active, received);
 }
 
-void MuteControl::NotifyLidClosed(bool active)
+void MuteControl::NotifyDisplayDimmed(bool dimmed)
 {
-    if (lidWasOpenedOnce_ || !active) {
-        WMLog::GetInstance().LogInfo(L"Mute Event: Lid Close {}",
-                                     active ? L"start" : L"stop");
-        NotifyRestoreCondition(MuteTypeLidClose, active);
-        lidWasOpenedOnce_ = true;
+    WMLog& log = WMLog::GetInstance();
+    if (!dimmed) {
+        if (std::exchange(preSaved_, nullptr) != nullptr) {
+            log.LogInfo(L"Display active again, discarding pre-saved state");
+        }
+        return;
+    }
+    const ConditionSet standby =
+        conditions_ | ConditionBit(MuteCondition::DisplayOff);
+    if (!ShouldMuteFor(MuteTypeDisplayStandby, standby)) {
+        return;
+    }
+    log.LogInfo(L"Display dimmed, preparing for standby");
+    winAudio_->WarmUp();
+    // With a scope open or a restore pending, standby has a snapshot to use.
+    if (scopes_.Empty() && pendingRestore_ == nullptr && preSaved_ == nullptr)
+    {
+        preSaved_ = std::make_shared<const MuteSnapshot>(TakeSnapshot());
     }
 }
 
-void MuteControl::NotifyBluetoothConnected(bool connected)
+void MuteControl::NotifyLidClosed(bool active, TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Bluetooth audio device {}",
-                                 connected ? L"connected" : L"disconnected");
-    NotifyRestoreCondition(MuteTypeBluetoothDisconnect, !connected, true);
+    WMLog::GetInstance().LogEvent(
+        LogLevel::Info, TriggerEvent(MuteTrigger::LidClose, active),
+        L"Mute Event: Lid Close {}", active ? L"start" : L"stop");
+    NotifyRestoreCondition(MuteTypeLidClose, active, received);
 }
 
-void MuteControl::NotifyLogout()
+void MuteControl::NotifyBluetoothConnected(bool connected, TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Logout start");
+    WMLog::GetInstance().LogEvent(
+        LogLevel::Info,
+        TriggerEvent(MuteTrigger::BluetoothDisconnect, !connected),
+        L"Mute Event: Bluetooth audio device {}",
+        connected ? L"connected" : L"disconnected");
+    NotifyRestoreCondition(MuteTypeBluetoothDisconnect, !connected, received,
+                           true);
+}
+
+void MuteControl::NotifyLogout(TimePoint received)
+{
+    WMLog::GetInstance().LogEvent(LogLevel::Info,
+                                  TriggerEvent(MuteTrigger::Logout, true),
+                                  L"Mute Event: Logout start");
     if (muteConfig_[MuteTypeLogout].shouldMute) {
-        winAudio_->SetMute(true);
+        MuteEndpoints(MuteTrigger::Logout, received);
     }
 }
 
-void MuteControl::NotifySuspend([[maybe_unused]] bool active)
+void MuteControl::NotifySuspend([[maybe_unused]] bool active,
+                                TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Suspend start");
+    WMLog::GetInstance().LogEvent(LogLevel::Info,
+                                  TriggerEvent(MuteTrigger::Suspend, true),
+                                  L"Mute Event: Suspend start");
     if (muteConfig_[MuteTypeSuspend].shouldMute) {
-        winAudio_->SetMute(true);
+        MuteEndpoints(MuteTrigger::Suspend, received);
     }
 }
 
-void MuteControl::NotifyShutdown()
+void MuteControl::NotifyShutdown(TimePoint received)
 {
-    WMLog::GetInstance().LogInfo(L"Mute Event: Shutdown start");
+    WMLog::GetInstance().LogEvent(LogLevel::Info,
+                                  TriggerEvent(MuteTrigger::Shutdown, true),
+                                  L"Mute Event: Shutdown start");
     if (muteConfig_[MuteTypeShutdown].shouldMute) {
-        winAudio_->SetMute(true);
+        MuteEndpoints(MuteTrigger::Shutdown, received);
     }
 }
 
-void MuteControl::NotifyQuietHours(bool active)
+void MuteControl::NotifyQuietHours(bool active, TimePoint received,
+                                   bool forceUnmute)
 {
+    WMLog& log = WMLog::GetInstance();
+    SetCondition(MuteCondition::QuietHours, active);
     if (active) {
-        // SaveMuteStatus() must stay the only save here: calling
-        // winAudio_->SaveMuteStatus() directly would overwrite the state
-        // remembered by an already-active mute event (e.g. workstation lock)
-        // with the currently muted state.
-        SaveMuteStatus();
-        WMLog::GetInstance().LogInfo(L"Mute Event: Quiet Hours started");
-        winAudio_->SetMute(true);
+        // Shares the snapshot of an already-active mute event (e.g.
+        // workstation lock); saving again would only record the muted state.
+        OpenScope(MuteTrigger::QuietHours, TakeInheritableSnapshot());
+        log.LogEvent(LogLevel::Info,
+                     TriggerEvent(MuteTrigger::QuietHours, true),
+                     L"Mute Event: Quiet Hours started");
+        MuteEndpoints(MuteTrigger::QuietHours, received);
+        return;
+    }
+    log.LogEvent(LogLevel::Info, TriggerEvent(MuteTrigger::QuietHours, false),
+                 L"Mute Event: Quiet Hours ended");
+    CloseScope(MuteTrigger::QuietHours);
+    if (!forceUnmute) {
+        return;
+    }
+    // Unmuting now would unmute in the middle of the remaining events; the
+    // restore at the end of the last one unmutes instead.
+    if (scopes_.Amend([](MuteSnapshot& s) { s.unmuteAll = true; })) {
+        log.LogInfo(L"Deferring forced unmute until all mute events ended");
     } else {
-        WMLog::GetInstance().LogInfo(L"Mute Event: Quiet Hours ended");
-        RestoreVolume();
+        SetMute(false);
+    }
+}
+
+void MuteControl::NotifyWlanConnected(bool connected, TimePoint received)
+{
+    SetCondition(MuteCondition::WlanConnected, connected);
+    if (!connected) {
+        return;
+    }
+    WMLog::GetInstance().LogEvent(LogLevel::Info,
+                                  TriggerEvent(MuteTrigger::Wlan, true),
+                                  L"Mute Event: WLAN connected");
+    if (muteOnWlan_) {
+        MuteEndpoints(MuteTrigger::Wlan, received);
     }
 }
 
@@ -535,9 +721,7 @@ void MuteControl::NotifyAudioDeviceArrived()
     // Only endpoints that went missing during a restore are eligible, and only
     // while no mute event is active -- a device showing up mid-mute should stay
     // as it is, not be unmuted behind the user's back.
-    const bool muteActive = std::any_of(
-        muteConfig_.begin(), muteConfig_.end(),
-        [](const MuteConfig& conf) { return conf.shouldMute && conf.active; });
+    const bool muteActive = !scopes_.Empty() || hysteresis_.AnyMuted();
     if (muteActive) {
         return;
     }
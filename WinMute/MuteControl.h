@@ -33,6 +33,9 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "MuteLatency.h"
+#include "MuteRules.hpp"
+#include "TimerScheduler.h"
 #include "TrayIcon.h"
 #include "WinAudio.h"
 #include "common.h"
@@ -44,7 +47,8 @@ class MuteControl {
     MuteControl(const MuteControl&) = delete;
     MuteControl& operator=(const MuteControl&) = delete;
 
-    bool Init(HWND hParent, const TrayIcon* trayIcon);
+    bool Init(HWND hParent, const TrayIcon* trayIcon,
+              TimerScheduler* scheduler);
 
     void SetNotifications(bool enable);
 
@@ -60,12 +64,16 @@ class MuteControl {
     void SetRestoreVolume(bool enable);
 
     void SetMuteDelay(int delaySeconds);
+    // Mutes are held back at least this long, and dropped if the triggering
+    // event ends in the meantime (e.g. an immediately undone Win+L).
+    void SetMuteGracePeriod(std::chrono::milliseconds gracePeriod);
 
     void SetMuteOnWorkstationLock(bool enable);
     void SetMuteOnRemoteSession(bool enable);
     void SetMuteOnDisplayStandby(bool enable);
     void SetMuteOnLidClose(bool enable);
     void SetMuteOnBluetoothDisconnect(bool enable);
+    void SetMuteOnWlan(bool enable);
 
     void SetMuteTryPauseMedia(bool enable);
     void SetMuteTryResumeMedia(bool enable);
@@ -86,31 +94,41 @@ class MuteControl {
     bool GetMuteOnSuspend() const;
     bool GetMuteOnShutdown() const;
 
-    void NotifyWorkstationLock(bool active);
-    void NotifyRemoteSession(bool active);
-    void NotifyDisplayStandby(bool active);
-    void NotifyLidClosed(bool active);
-    void NotifyBluetoothConnected(bool connected);
+    // `received` is when the triggering window message arrived; the time
+    // until all endpoints are muted is recorded in MuteLatencyStats.
+    using TimePoint = MuteLatencyStats::TimePoint;
 
-    void NotifyLogout();
-    void NotifySuspend(bool active);
-    void NotifyShutdown();
+    void NotifyWorkstationLock(bool active, TimePoint received);
+    void NotifyRemoteSession(bool active, TimePoint received);
+    void NotifyDisplayStandby(bool active, TimePoint received);
+    // Dimming precedes display standby by several seconds; the mute state is
+    // saved ahead of time so standby only has to mute.
+    void NotifyDisplayDimmed(bool dimmed);
+    void NotifyLidClosed(bool active, TimePoint received);
+    void NotifyBluetoothConnected(bool connected, TimePoint received);
 
-    void NotifyQuietHours(bool active);
+    void NotifyLogout(TimePoint received);
+    void NotifySuspend(bool active, TimePoint received);
+    void NotifyShutdown(TimePoint received);
+
+    // With `forceUnmute`, the end of quiet hours unmutes instead of restoring
+    // -- once no other mute event is active any more.
+    void NotifyQuietHours(bool active, TimePoint received,
+                          bool forceUnmute = false);
+
+    // Connected to (or disconnected from) a WLAN the WLAN list applies to.
+    // Always tracked for the mute rules, mutes only with SetMuteOnWlan.
+    void NotifyWlanConnected(bool connected, TimePoint received);
 
     void NotifyAudioDeviceArrived();
 
+    // Rules override the SetMuteOn* flag of every trigger they mention.
+    void SetMuteRules(MuteRuleSet rules);
+
     void SetManagedEndpoints(const std::vector<ManagedEndpoint>& endpoints,
                              bool isAllowList);
     void ClearManagedEndpoints();
 
-    LRESULT CALLBACK WindowProc(HWND hWnd, UINT msg, WPARAM wParam,
-                                LPARAM lParam);
-
-    // Should only be called internally
-    void MuteDelayed(int magic);
-    void CompleteVolumeRestore();
-
    private:
     enum MuteType {
         // With restore
@@ -127,42 +145,64 @@ class MuteControl {
         MuteTypeCount  // Meta
     };
     struct MuteConfig {
-        bool shouldMute;
-        bool active;
+        bool shouldMute = false;
     };
     struct MediaConfig {
         bool tryPause = false;
         bool tryResume = false;
     } mediaConfig_;
+    struct MuteSnapshot {
+        std::uint32_t generation = 0;  // as returned by WinAudio
+        bool unmuteAll = false;        // quiet hours ended with force unmute
+    };
+    // Keyed by the event that muted; quiet hours open a scope as well.
+    using Scopes = RestoreScopes<MuteTrigger, MuteSnapshot>;
+    using SnapshotPtr = Scopes::SnapshotPtr;
+
     std::vector<MuteConfig> muteConfig_;
+    // Whether the MuteType events muted, or are waiting for the mute delay.
+    MuteHysteresis hysteresis_;
+    MuteRuleSet rules_;
+    ConditionSet conditions_ = 0;
     bool restoreVolume_ = false;
+    bool muteOnWlan_ = false;
+    Scopes scopes_;
+    // Taken on display dim, adopted by the next scope that opens.
+    SnapshotPtr preSaved_;
+    // Waiting for the Bluetooth reconnect delay; a scope opening in the
+    // meantime takes it over instead of saving the still muted state.
+    SnapshotPtr pendingRestore_;
     bool notificationsEnabled_ = false;
     int muteDelaySeconds_ = 0;
-    UINT_PTR delayedMuteTimerId_ = 0;
-    UINT_PTR bluetoothUnmuteTimerId_ = 0;
+    std::chrono::milliseconds muteGracePeriod_{0};
+    TimerScheduler* scheduler_ = nullptr;
+    TimerScheduler::TimerHandle delayedMuteTimer_ = 0;
+    TimerScheduler::TimerHandle bluetoothUnmuteTimer_ = 0;
     std::unique_ptr<WinAudio> winAudio_;
     MediaPlaybackController mediaController_;
-    HWND hMuteCtrlWnd_ = nullptr;
-
-    // Since a power message is sent right after registering
-    // We skip the first "was on" message
-    bool displayWasOffOnce_ = false;
-
-    // The lid-switch registration also reports the current state
-    // immediately. Ignore "closed" until the lid was open once, so a
-    // laptop started docked with its lid closed is not muted on launch.
-    bool lidWasOpenedOnce_ = false;
 
     const TrayIcon* trayIcon_ = nullptr;
 
     static const wchar_t* MuteTypeToString(MuteType type);
+    static MuteTrigger MuteTypeToTrigger(MuteType type);
+    static std::optional<MuteCondition> MuteTypeToCondition(MuteType type);
 
-    void NotifyRestoreCondition(MuteType type, bool active,
-                                bool withDelay = false);
-    void SaveMuteStatus();
-    void RestoreVolume(bool withDelay = false);
-    void ShowNotification(const std::wstring& title, const std::wstring& text);
-    bool StartDelayedMute();
+    void SetCondition(MuteCondition condition, bool active);
+    bool ShouldMuteFor(MuteType type, ConditionSet conditions) const;
 
-    void MuteNow();
+    void NotifyRestoreCondition(MuteType type, bool active, TimePoint received,
+                                bool withDelay = false);
+    MuteSnapshot TakeSnapshot();
+    SnapshotPtr TakeInheritableSnapshot();
+    void OpenScope(MuteTrigger scope, SnapshotPtr inherit = nullptr);
+    void CloseScope(MuteTrigger scope, bool withDelay = false);
+    void RestoreVolume(SnapshotPtr snapshot, bool withDelay);
+    void ShowNotification(std::wstring_view title, std::wstring_view text);
+    std::chrono::milliseconds GetMuteDelay() const;
+    bool StartDelayedMute(MuteTrigger trigger);
+    void MuteDelayed(MuteTrigger trigger);
+    void CompleteVolumeRestore(SnapshotPtr snapshot);
+
+    void MuteNow(MuteTrigger trigger, TimePoint received);
+    void MuteEndpoints(MuteTrigger trigger, TimePoint received);
 };
@@ -0,0 +1,144 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Decides when the events that restore afterwards (lock, display standby,
+// ...) touch the endpoints. Without a mute delay, a starting event mutes right
+// away. With one, it is only marked pending and the endpoints are saved and
+// muted once the delay ran out:
+//
+//  - Events starting while a mute is pending join it, the delay is not
+//    restarted.
+//  - An event that ends while pending is forgotten. Once no pending event is
+//    left the timer is cancelled, so a blip shorter than the delay causes no
+//    endpoint calls at all.
+//
+// Only decides; the owner runs the timer, saves, mutes and restores. Events
+// are indices below the count passed to the constructor. Not thread-safe.
+class MuteHysteresis {
+   public:
+    enum class StartAction {
+        None,        // the event does not mute
+        MuteNow,     // no delay: save and mute right away
+        StartTimer,  // the first pending event: start the delay
+        Join         // a mute is already pending
+    };
+
+    enum class EndAction {
+        Ignored,          // it was never seen as started
+        NotMuted,         // the event did not mute, nothing to restore
+        Restore,          // close the event's scope
+        EndedPending,     // ended before the delay, others are still pending
+        CancelledPending  // the last pending event ended: cancel the timer
+    };
+
+    explicit MuteHysteresis(std::size_t eventCount) : events_(eventCount) {}
+
+    StartAction Start(std::size_t event, bool mute, bool delayed)
+    {
+        Event& ev = events_.at(event);
+        ev.active = true;
+        if (!mute) {
+            return StartAction::None;
+        }
+        ev.muted = true;
+        if (!delayed) {
+            return StartAction::MuteNow;
+        }
+        const bool alreadyPending = AnyPending();
+        ev.pending = true;
+        return alreadyPending ? StartAction::Join : StartAction::StartTimer;
+    }
+
+    // For every result but Ignored and NotMuted, the owner closes the scope of
+    // the event, if it has one.
+    EndAction End(std::size_t event)
+    {
+        Event& ev = events_.at(event);
+        if (!ev.active) {
+            return EndAction::Ignored;
+        }
+        ev.active = false;
+        if (!ev.muted) {
+            return EndAction::NotMuted;
+        }
+        const bool wasPending = ev.pending;
+        ev.muted = false;
+        ev.pending = false;
+        if (!wasPending) {
+            return EndAction::Restore;
+        }
+        return AnyPending() ? EndAction::EndedPending
+                            : EndAction::CancelledPending;
+    }
+
+    // The delay ran out: calls `fn` with every pending event, in index order,
+    // which is then muted.
+    template <typename Fn>
+    void TakePending(Fn&& fn)
+    {
+        for (std::size_t i = 0; i < events_.size(); ++i) {
+            if (events_[i].pending) {
+                events_[i].pending = false;
+                fn(i);
+            }
+        }
+    }
+
+    bool AnyPending() const
+    {
+        return std::any_of(events_.begin(), events_.end(),
+                           [](const Event& ev) { return ev.pending; });
+    }
+
+    // Muted, or about to be once the delay ran out.
+    bool AnyMuted() const
+    {
+        return std::any_of(events_.begin(), events_.end(),
+                           [](const Event& ev) { return ev.muted; });
+    }
+
+   private:
+    struct Event {
+        bool active = false;
+        bool muted = false;    // the event muted (or is about to)
+        bool pending = false;  // waiting for the delay, endpoints untouched
+    };
+
+    std::vector<Event> events_;
+};
@@ -0,0 +1,153 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#include "common.h"
+
+MuteLatencyStats& MuteLatencyStats::GetInstance()
+{
+    static MuteLatencyStats instance;
+    return instance;
+}
+
+const wchar_t* MuteLatencyStats::TriggerToString(MuteTrigger trigger)
+{
+    switch (trigger) {
+        case MuteTrigger::WorkstationLock:
+            return L"Workstation Lock";
+        case MuteTrigger::RemoteSession:
+            return L"Remote Session";
+        case MuteTrigger::DisplayStandby:
+            return L"Display Standby";
+        case MuteTrigger::DisplayStandbyPreSaved:
+            return L"Display Standby (pre-saved on dim)";
+        case MuteTrigger::LidClose:
+            return L"Lid Close";
+        case MuteTrigger::BluetoothDisconnect:
+            return L"Bluetooth Disconnect";
+        case MuteTrigger::Logout:
+            return L"Logout";
+        case MuteTrigger::Suspend:
+            return L"Suspend";
+        case MuteTrigger::Shutdown:
+            return L"Shutdown";
+        case MuteTrigger::QuietHours:
+            return L"Quiet Hours";
+        case MuteTrigger::Wlan:
+            return L"WLAN";
+        case MuteTrigger::Count:
+        default:
+            return L"Unknown";
+    }
+}
+
+std::chrono::microseconds MuteLatencyStats::Record(MuteTrigger trigger,
+                                                   TimePoint received,
+                                                   TimePoint completed)
+{
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        completed - received);
+    if (trigger != MuteTrigger::Count) {
+        const std::lock_guard lock(mutex_);
+        histograms_[static_cast<std::size_t>(trigger)].Record(elapsed);
+    }
+    return elapsed;
+}
+
+std::vector<MuteLatencyStats::Summary> MuteLatencyStats::GetSummaries() const
+{
+    std::vector<Summary> summaries;
+    const std::lock_guard lock(mutex_);
+    for (std::size_t i = 0; i < histograms_.size(); ++i) {
+        const LatencyHistogram& hist = histograms_[i];
+        if (hist.Count() == 0) {
+            continue;
+        }
+        Summary s;
+        s.trigger = static_cast<MuteTrigger>(i);
+        s.count = hist.Count();
+        s.p50 = hist.Percentile(50.0);
+        s.p99 = hist.Percentile(99.0);
+        s.max = hist.Max();
+        summaries.push_back(s);
+    }
+    return summaries;
+}
+
+void MuteLatencyStats::Reset()
+{
+    const std::lock_guard lock(mutex_);
+    for (auto& hist : histograms_) {
+        hist.Reset();
+    }
+}
+
+void MuteLatencyStats::LogReport() const
+{
+    WMLog& log = WMLog::GetInstance();
+    const auto summaries = GetSummaries();
+    if (summaries.empty()) {
+        log.LogInfo(L"Mute latency: no samples recorded yet");
+        return;
+    }
+    log.LogInfo(L"Mute latency (trigger arrival until all endpoints muted):");
+    for (const auto& s : summaries) {
+        log.LogInfo(L"  {}: n={}, p50={} us, p99={} us, max={} us",
+                    TriggerToString(s.trigger), s.count, s.p50.count(),
+                    s.p99.count(), s.max.count());
+    }
+}
+
+bool MuteLatencyStats::ExportCsv(const std::wstring& filePath) const
+{
+    std::ofstream out(filePath, std::ios::out | std::ios::trunc);
+    if (!out) {
+        WMLog::GetInstance().LogError(
+            L"Failed to open \"{}\" for the mute latency export", filePath);
+        return false;
+    }
+    out << "trigger,count,p50_us,p99_us,max_us\n";
+    for (const auto& s : GetSummaries()) {
+        out << ConvertWideStringToString(TriggerToString(s.trigger)) << ','
+            << s.count << ',' << s.p50.count() << ',' << s.p99.count() << ','
+            << s.max.count() << '\n';
+    }
+    out.close();
+    if (out.fail()) {
+        WMLog::GetInstance().LogError(
+            L"Failed to write the mute latency export to \"{}\"", filePath);
+        return false;
+    }
+    WMLog::GetInstance().LogInfo(L"Exported mute latency statistics to \"{}\"",
+                                 filePath);
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include "common.h"
+
+enum class MuteTrigger {
+    WorkstationLock = 0,
+    RemoteSession,
+    DisplayStandby,
+    DisplayStandbyPreSaved,  // mute state was already saved when dimming
+    LidClose,
+    BluetoothDisconnect,
+    Logout,
+    Suspend,
+    Shutdown,
+    QuietHours,
+    Wlan,
+    Count  // Meta
+};
+
+// Tracks, per trigger, how long it takes from the arrival of the window
+// message that caused a mute until every managed endpoint has been muted.
+class MuteLatencyStats {
+   public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    struct Summary {
+        MuteTrigger trigger = MuteTrigger::Count;
+        std::uint64_t count = 0;
+        std::chrono::microseconds p50{0};
+        std::chrono::microseconds p99{0};
+        std::chrono::microseconds max{0};
+    };
+
+    static MuteLatencyStats& GetInstance();
+    static const wchar_t* TriggerToString(MuteTrigger trigger);
+
+    // Records the time from `received` until `completed` and returns it.
+    std::chrono::microseconds Record(MuteTrigger trigger, TimePoint received,
+                                     TimePoint completed = Clock::now());
+
+    // One entry per trigger that has at least one sample.
+    std::vector<Summary> GetSummaries() const;
+    void Reset();
+
+    void LogReport() const;
+    bool ExportCsv(const std::wstring& filePath) const;
+
+   private:
+    MuteLatencyStats() = default;
+    MuteLatencyStats(const MuteLatencyStats&) = delete;
+    MuteLatencyStats& operator=(const MuteLatencyStats&) = delete;
+
+    mutable std::mutex mutex_;
+    std::array<LatencyHistogram, static_cast<std::size_t>(MuteTrigger::Count)>
+        histograms_;
+};
@@ -0,0 +1,261 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Everything a mute rule can look at. The first five are events that can
+// trigger a mute; WLAN and quiet hours only describe the current situation.
+// WlanConnected follows the WLAN list the same way muting on connect does: it
+// is set for a listed network on a mute list, and for any network that is not
+// listed on an allow list.
+enum class MuteCondition {
+    WorkstationLocked = 0,
+    RemoteSession,
+    DisplayOff,
+    LidClosed,
+    BluetoothDisconnected,
+    WlanConnected,  // connected to a network the WLAN list applies to
+    QuietHours,
+    Count  // Meta
+};
+
+using ConditionSet = std::uint32_t;
+
+constexpr ConditionSet ConditionBit(MuteCondition condition)
+{
+    return ConditionSet{1} << static_cast<unsigned>(condition);
+}
+
+// Rules of the form "<trigger> [& [!]<condition>]...", e.g. "lock & !wlan"
+// mutes on workstation lock unless connected to a WLAN the list applies to
+// (see MuteCondition::WlanConnected). Several rules are separated by ';' and
+// a trigger mutes if any of its rules matches.
+//
+// Since there are only a handful of conditions, every rule is compiled into
+// a bitmap over all possible condition sets. Deciding whether an event should
+// mute is then a single bit test, no matter how many rules there are.
+class MuteRuleSet {
+   public:
+    struct Rule {
+        MuteCondition trigger = MuteCondition::Count;
+        ConditionSet required = 0;  // always includes the trigger
+        ConditionSet forbidden = 0;
+    };
+
+    static const wchar_t* ConditionName(MuteCondition condition)
+    {
+        return kNames[static_cast<std::size_t>(condition)];
+    }
+
+    static bool IsTrigger(MuteCondition condition)
+    {
+        return condition < MuteCondition::WlanConnected;
+    }
+
+    static std::optional<Rule> Parse(std::wstring_view text,
+                                     std::wstring& error)
+    {
+        Rule rule;
+        bool first = true;
+        while (!text.empty() || first) {
+            const std::size_t sep = text.find(L'&');
+            std::wstring_view term = Trim(text.substr(0, sep));
+            text = (sep == std::wstring_view::npos) ? std::wstring_view{}
+                                                    : text.substr(sep + 1);
+            const bool negated = !term.empty() && term.front() == L'!';
+            if (negated) {
+                term = Trim(term.substr(1));
+            }
+            const auto condition = ConditionFromName(term);
+            if (!condition) {
+                error = L"unknown condition \"" + std::wstring(term) + L"\"";
+                return std::nullopt;
+            }
+            const ConditionSet bit = ConditionBit(*condition);
+            if (first) {
+                if (negated || !IsTrigger(*condition)) {
+                    error = L"\"" + std::wstring(term) +
+                            L"\" cannot start a rule, it is not an event";
+                    return std::nullopt;
+                }
+                rule.trigger = *condition;
+                rule.required |= bit;
+                first = false;
+            } else if (negated) {
+                rule.forbidden |= bit;
+            } else {
+                rule.required |= bit;
+            }
+            if (sep != std::wstring_view::npos && text.empty()) {
+                error = L"missing condition after '&'";
+                return std::nullopt;
+            }
+        }
+        if ((rule.required & rule.forbidden) != 0) {
+            error = L"a condition is both required and excluded";
+            return std::nullopt;
+        }
+        return rule;
+    }
+
+    // Compiles a ';'-separated rule list. Empty entries are ignored.
+    static std::optional<MuteRuleSet> Compile(std::wstring_view text,
+                                              std::wstring& error)
+    {
+        MuteRuleSet set;
+        while (!text.empty()) {
+            const std::size_t sep = text.find(L';');
+            const std::wstring_view entry = Trim(text.substr(0, sep));
+            text = (sep == std::wstring_view::npos) ? std::wstring_view{}
+                                                    : text.substr(sep + 1);
+            if (entry.empty()) {
+                continue;
+            }
+            auto rule = Parse(entry, error);
+            if (!rule) {
+                error = L"\"" + std::wstring(entry) + L"\": " + error;
+                return std::nullopt;
+            }
+            set.Add(*rule);
+        }
+        return set;
+    }
+
+    void Add(const Rule& rule)
+    {
+        const ConditionSet mask = rule.required | rule.forbidden;
+        auto& bitmap = bitmaps_[static_cast<std::size_t>(rule.trigger)];
+        for (ConditionSet state = 0; state < kStateCount; ++state) {
+            if ((state & mask) == rule.required) {
+                bitmap[state / 64] |= std::uint64_t{1} << (state % 64);
+            }
+        }
+        hasRules_[static_cast<std::size_t>(rule.trigger)] = true;
+        usedConditions_ |= mask;
+        rules_.push_back(rule);
+    }
+
+    // Every condition at least one rule looks at, triggers included.
+    ConditionSet GetUsedConditions() const
+    {
+        return usedConditions_;
+    }
+
+    bool HasRules(MuteCondition trigger) const
+    {
+        return hasRules_[static_cast<std::size_t>(trigger)];
+    }
+
+    // `conditions` is the current condition set, including the trigger.
+    bool ShouldMute(MuteCondition trigger, ConditionSet conditions) const
+    {
+        const ConditionSet state = conditions & (kStateCount - 1);
+        const auto& bitmap = bitmaps_[static_cast<std::size_t>(trigger)];
+        return ((bitmap[state / 64] >> (state % 64)) & 1) != 0;
+    }
+
+    const std::vector<Rule>& GetRules() const
+    {
+        return rules_;
+    }
+
+    static std::wstring ToString(const Rule& rule)
+    {
+        std::wstring text = ConditionName(rule.trigger);
+        for (std::size_t i = 0; i < kConditionCount; ++i) {
+            const auto condition = static_cast<MuteCondition>(i);
+            const ConditionSet bit = ConditionBit(condition);
+            if (condition == rule.trigger) {
+                continue;
+            } else if (rule.required & bit) {
+                text += L" & ";
+            } else if (rule.forbidden & bit) {
+                text += L" & !";
+            } else {
+                continue;
+            }
+            text += ConditionName(condition);
+        }
+        return text;
+    }
+
+   private:
+    static constexpr std::size_t kConditionCount =
+        static_cast<std::size_t>(MuteCondition::Count);
+    static constexpr ConditionSet kStateCount = ConditionSet{1}
+                                                << kConditionCount;
+    static constexpr std::array<const wchar_t*, kConditionCount> kNames = {
+        L"lock", L"remote", L"display", L"lid",
+        L"bluetooth", L"wlan", L"quiethours"};
+
+    static std::wstring_view Trim(std::wstring_view s)
+    {
+        const auto isSpace = [](wchar_t c) {
+            return c == L' ' || c == L'\t' || c == L'\r' || c == L'\n';
+        };
+        while (!s.empty() && isSpace(s.front())) {
+            s.remove_prefix(1);
+        }
+        while (!s.empty() && isSpace(s.back())) {
+            s.remove_suffix(1);
+        }
+        return s;
+    }
+
+    static std::optional<MuteCondition> ConditionFromName(
+        std::wstring_view name)
+    {
+        for (std::size_t i = 0; i < kNames.size(); ++i) {
+            if (name == kNames[i]) {
+                return static_cast<MuteCondition>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::array<std::array<std::uint64_t, (kStateCount + 63) / 64>,
+               kConditionCount>
+        bitmaps_{};
+    std::array<bool, kConditionCount> hasRules_{};
+    ConditionSet usedConditions_ = 0;
+    std::vector<Rule> rules_;
+};
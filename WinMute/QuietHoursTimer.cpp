@@ -35,8 +35,6 @@ POSSIBILITY OF SUCH DAMAGE.
 
 extern HINSTANCE hglobInstance;
 
-static constexpr UINT_PTR QUIETHOURS_TIMER_START_ID = 271020;
-static constexpr UINT_PTR QUIETHOURS_TIMER_END_ID = 271021;
 static constexpr DWORD SECONDS_PER_DAY = 86400;
 
 // Returns seconds since midnight for the current local time
@@ -59,21 +57,13 @@ static bool TimeInWindow(DWORD t, DWORD wStart, DWORD wEnd) noexcept
     }
 }
 
-static VOID CALLBACK QuietHoursTimerProc(HWND hWnd, UINT /*msg*/, UINT_PTR id,
-                                         DWORD /*msSinceSysStart*/) noexcept
-{
-    KillTimer(hWnd, id);
-    if (id == QUIETHOURS_TIMER_START_ID) {
-        SendMessageW(hWnd, WM_WINMUTE_QUIETHOURS_START, 0, 0);
-    } else if (id == QUIETHOURS_TIMER_END_ID) {
-        SendMessageW(hWnd, WM_WINMUTE_QUIETHOURS_END, 0, 0);
-    }
-}
-
 // ---------------------------------------------------------------------------
 
 QuietHoursTimer::QuietHoursTimer()
     : hParent_(nullptr),
+      scheduler_(nullptr),
+      startTimer_(0),
+      endTimer_(0),
       initialized_(false),
       enabled_(false),
       activeWindowIdx_(-1)
@@ -82,12 +72,19 @@ QuietHoursTimer::QuietHoursTimer()
 
 QuietHoursTimer::~QuietHoursTimer()
 {
-    if (initialized_ && enabled_) {
-        KillTimer(hParent_, QUIETHOURS_TIMER_START_ID);
-        KillTimer(hParent_, QUIETHOURS_TIMER_END_ID);
+    if (initialized_) {
+        CancelTimers();
     }
 }
 
+void QuietHoursTimer::CancelTimers()
+{
+    scheduler_->Cancel(startTimer_);
+    scheduler_->Cancel(endTimer_);
+    startTimer_ = 0;
+    endTimer_ = 0;
+}
+
 // Returns the index of the window that currently contains the local time,
 // or -1 if none is active.
 int QuietHoursTimer::FindActiveWindowIdx() const
@@ -125,7 +122,8 @@ int QuietHoursTimer::FindNextWindowIdx() const
 
 bool QuietHoursTimer::SetStart()
 {
-    KillTimer(hParent_, QUIETHOURS_TIMER_START_ID);
+    scheduler_->Cancel(startTimer_);
+    startTimer_ = 0;
 
     if (!enabled_ || windows_.empty())
         return true;
@@ -147,16 +145,19 @@ bool QuietHoursTimer::SetStart()
     // edge case.
     const UINT msDelay = (diffSec > 0) ? (diffSec * 1000u) : 1u;
 
-    if (SetTimer(hParent_, QUIETHOURS_TIMER_START_ID, msDelay,
-                 QuietHoursTimerProc) == 0)
-    {
+    startTimer_ =
+        scheduler_->Schedule(std::chrono::milliseconds(msDelay), [this] {
+            startTimer_ = 0;
+            SendMessageW(hParent_, WM_WINMUTE_QUIETHOURS_START, 0, 0);
+        });
+    if (startTimer_ == 0) {
         TaskDialog(hParent_, hglobInstance, PROGRAM_NAME,
                    WMi18n::GetInstance()
                        .GetTranslationW("popup.error.quiet-hours-start.title")
-                       .c_str(),
+                       .data(),
                    WMi18n::GetInstance()
                        .GetTranslationW("popup.error.quiet-hours-start.text")
-                       .c_str(),
+                       .data(),
                    TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return false;
     }
@@ -173,7 +174,8 @@ bool QuietHoursTimer::SetStart()
 
 bool QuietHoursTimer::SetEnd()
 {
-    KillTimer(hParent_, QUIETHOURS_TIMER_END_ID);
+    scheduler_->Cancel(endTimer_);
+    endTimer_ = 0;
 
     if (!enabled_ || windows_.empty() || activeWindowIdx_ < 0)
         return true;
@@ -190,16 +192,18 @@ bool QuietHoursTimer::SetEnd()
         return true;
     }
 
-    if (SetTimer(hParent_, QUIETHOURS_TIMER_END_ID, diffSec * 1000u,
-                 QuietHoursTimerProc) == 0)
-    {
+    endTimer_ = scheduler_->Schedule(std::chrono::seconds(diffSec), [this] {
+        endTimer_ = 0;
+        SendMessageW(hParent_, WM_WINMUTE_QUIETHOURS_END, 0, 0);
+    });
+    if (endTimer_ == 0) {
         TaskDialog(hParent_, hglobInstance, PROGRAM_NAME,
                    WMi18n::GetInstance()
                        .GetTranslationW("popup.error.quiet-hours-stop.title")
-                       .c_str(),
+                       .data(),
                    WMi18n::GetInstance()
                        .GetTranslationW("popup.error.quiet-hours-stop.text")
-                       .c_str(),
+                       .data(),
                    TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return false;
     }
@@ -220,8 +224,7 @@ bool QuietHoursTimer::IsQuietTime() const
 
 bool QuietHoursTimer::LoadFromSettings(WMSettings& settings)
 {
-    KillTimer(hParent_, QUIETHOURS_TIMER_START_ID);
-    KillTimer(hParent_, QUIETHOURS_TIMER_END_ID);
+    CancelTimers();
     windows_.clear();
     activeWindowIdx_ = -1;
 
@@ -257,11 +260,13 @@ bool QuietHoursTimer::LoadFromSettings(WMSettings& settings)
     return true;
 }
 
-bool QuietHoursTimer::Init(HWND hParent, WMSettings& settings)
+bool QuietHoursTimer::Init(HWND hParent, TimerScheduler& scheduler,
+                           WMSettings& settings)
 {
     if (initialized_)
         return true;
     hParent_ = hParent;
+    scheduler_ = &scheduler;
     initialized_ = true;
     return LoadFromSettings(settings);
 }
@@ -33,6 +33,7 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include "TimerScheduler.h"
 #include "WMSettings.h"
 #include "common.h"
 
@@ -46,7 +47,7 @@ class QuietHoursTimer {
     QuietHoursTimer(const QuietHoursTimer&) = delete;
     QuietHoursTimer& operator=(const QuietHoursTimer&) = delete;
 
-    bool Init(HWND hParent, WMSettings& settings);
+    bool Init(HWND hParent, TimerScheduler& scheduler, WMSettings& settings);
 
     bool IsQuietTime() const;
 
@@ -57,6 +58,9 @@ class QuietHoursTimer {
 
    private:
     HWND hParent_;
+    TimerScheduler* scheduler_;
+    TimerScheduler::TimerHandle startTimer_;
+    TimerScheduler::TimerHandle endTimer_;
     bool initialized_;
     bool enabled_;
     std::vector<std::pair<DWORD, DWORD>>
@@ -64,6 +68,7 @@ class QuietHoursTimer {
     int activeWindowIdx_;  // index of currently scheduled/active window
 
     bool LoadFromSettings(WMSettings& settings);
+    void CancelTimers();
     int FindActiveWindowIdx() const;
     int FindNextWindowIdx() const;
 };
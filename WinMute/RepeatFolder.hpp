@@ -0,0 +1,128 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+// Run-length folding of identical consecutive records, as syslog does it:
+// the first record of a run passes, the repeats are only counted, and the
+// count is handed back when the run ends so the caller can emit a "last
+// message repeated N times" record in its place. A long run is reported
+// every `maxHold`, so the count never sits unreported for longer than that.
+//
+// `Equal` decides what identical means. Only the first record of a run is
+// kept, so it must compare everything but what may differ between repeats,
+// such as a timestamp. Not thread-safe.
+template <typename Record, typename Equal>
+class RepeatFolder {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RepeatFolder(Equal equal = Equal{},
+                          Clock::duration maxHold = std::chrono::seconds(30))
+        : equal_(std::move(equal)), maxHold_(maxHold)
+    {
+    }
+
+    // Returns true if `record` repeats the previous one and was folded.
+    // `repeats` receives the number of folded repeats to report now, before
+    // `record` if that passes; 0 if there is nothing to report.
+    bool Offer(const Record& record, Clock::time_point now,
+               std::uint64_t& repeats)
+    {
+        repeats = 0;
+        if (hasLast_ && equal_(last_, record)) {
+            if (pending_ == 0) {
+                firstPending_ = now;
+            }
+            ++pending_;
+            ++folded_;
+            if (now - firstPending_ >= maxHold_) {
+                repeats = std::exchange(pending_, 0);
+            }
+            return true;
+        }
+        repeats = std::exchange(pending_, 0);
+        last_ = record;
+        hasLast_ = true;
+        return false;
+    }
+
+    // Hands back the repeats that have waited for `maxHold`, or all of them
+    // if `force` is set; the run itself continues.
+    std::uint64_t TakeRepeats(Clock::time_point now, bool force = false)
+    {
+        if (pending_ == 0 || (!force && now - firstPending_ < maxHold_)) {
+            return 0;
+        }
+        return std::exchange(pending_, 0);
+    }
+
+    // When TakeRepeats has something to report; Clock::time_point::max()
+    // if nothing is pending.
+    Clock::time_point Deadline() const
+    {
+        return pending_ == 0 ? Clock::time_point::max()
+                             : firstPending_ + maxHold_;
+    }
+
+    // Repeats counted but not handed back yet.
+    std::uint64_t PendingRepeats() const
+    {
+        return pending_;
+    }
+
+    // The record the current run repeats. Only valid after the first Offer.
+    const Record& Last() const
+    {
+        return last_;
+    }
+
+    // Records folded since construction.
+    std::uint64_t FoldedCount() const
+    {
+        return folded_;
+    }
+
+   private:
+    Equal equal_;
+    Clock::duration maxHold_;
+    Record last_{};
+    bool hasLast_ = false;
+    std::uint64_t pending_ = 0;
+    Clock::time_point firstPending_{};
+    std::uint64_t folded_ = 0;
+};
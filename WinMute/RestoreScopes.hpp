@@ -0,0 +1,162 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Tracks the events that currently keep the endpoints muted ("scopes") and the
+// state to restore once all of them are over. Merge rules:
+//
+//  - The first scope to open takes the snapshot, unless it is handed one that
+//    was taken earlier (a restore still waiting for its delay, or a state
+//    saved ahead of time). Scopes opening while others are open share that
+//    snapshot; the endpoints are already muted by then, so saving again would
+//    only record the muted state.
+//  - Closing a scope while others are still open restores nothing.
+//  - Closing the last scope hands out the snapshot. It is restored with the
+//    semantics of that last scope (e.g. delayed for Bluetooth).
+//  - An event that wants to change what the final restore does (quiet hours
+//    forcing an unmute) amends the shared snapshot. Amending is copy-on-write:
+//    snapshots handed out before are not affected.
+//
+// There is deliberately one snapshot for all open scopes rather than one per
+// scope: every scope but the first opens while the endpoints are already
+// muted, so a snapshot of its own would record the muted state and restoring
+// it would be wrong or redundant. What differs between scopes is only how the
+// final restore runs, which the closing scope decides, and what it restores,
+// which goes through Amend.
+//
+// Opening or closing a scope twice is a no-op. Not thread-safe.
+template <typename Key, typename Snapshot>
+class RestoreScopes {
+   public:
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    enum class OpenResult {
+        AlreadyOpen,  // the key was already open, nothing changed
+        Joined,       // shares the snapshot of the scopes already open
+        Inherited,    // first scope, adopted the snapshot it was handed
+        Taken         // first scope, took a new snapshot
+    };
+
+    // `take` is only called if a new snapshot is needed.
+    template <typename Take>
+    OpenResult Open(const Key& key, Take&& take, SnapshotPtr inherit = nullptr)
+    {
+        if (IsOpen(key)) {
+            return OpenResult::AlreadyOpen;
+        }
+        OpenResult result = OpenResult::Joined;
+        if (scopes_.empty()) {
+            if (inherit != nullptr) {
+                snapshot_ = std::move(inherit);
+                result = OpenResult::Inherited;
+            } else {
+                snapshot_ = std::make_shared<const Snapshot>(take());
+                result = OpenResult::Taken;
+            }
+        }
+        scopes_.push_back(key);
+        return result;
+    }
+
+    // Opens the scope only if that needs no new snapshot: either other scopes
+    // are open or `inherit` is set. Returns whether the scope is open now.
+    bool Join(const Key& key, SnapshotPtr inherit = nullptr)
+    {
+        if (scopes_.empty() && inherit == nullptr) {
+            return false;
+        }
+        // Never takes: there is either a snapshot to join or one to inherit.
+        Open(key, [this] { return *snapshot_; }, std::move(inherit));
+        return true;
+    }
+
+    // Returns the snapshot to restore if `key` was the last open scope, and
+    // nullptr if it was not open or other scopes are still open.
+    SnapshotPtr Close(const Key& key)
+    {
+        const auto it = std::find(scopes_.begin(), scopes_.end(), key);
+        if (it == scopes_.end()) {
+            return nullptr;
+        }
+        scopes_.erase(it);
+        if (!scopes_.empty()) {
+            return nullptr;
+        }
+        return std::exchange(snapshot_, nullptr);
+    }
+
+    // Applies `amend` to a copy of the shared snapshot, which then replaces
+    // it for all open scopes. Returns false if no scope is open.
+    template <typename Fn>
+    bool Amend(Fn&& amend)
+    {
+        if (scopes_.empty()) {
+            return false;
+        }
+        auto copy = std::make_shared<Snapshot>(*snapshot_);
+        amend(*copy);
+        snapshot_ = std::move(copy);
+        return true;
+    }
+
+    bool IsOpen(const Key& key) const
+    {
+        return std::find(scopes_.begin(), scopes_.end(), key) != scopes_.end();
+    }
+
+    bool Empty() const
+    {
+        return scopes_.empty();
+    }
+
+    // In the order they were opened.
+    const std::vector<Key>& OpenScopes() const
+    {
+        return scopes_;
+    }
+
+    const SnapshotPtr& Current() const
+    {
+        return snapshot_;
+    }
+
+   private:
+    std::vector<Key> scopes_;
+    SnapshotPtr snapshot_;
+};
@@ -0,0 +1,275 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// Append-only log file with a bounded footprint on disk and few writes.
+//
+// Records are collected in a buffer and committed (one write plus flush) when
+// the commit interval has passed, when the buffer is full, or right away if
+// the caller asks for it (errors should not sit in memory when the process
+// dies). Once the file would grow past maxFileBytes, or has been written to
+// for longer than maxFileAge, it is rotated: "name" becomes "name.1", "name.1"
+// becomes "name.2", and so on, keeping at most retainedFiles old files.
+// Records never straddle two files.
+//
+// Time is passed in by the caller, so the policy can be driven by a fake
+// clock. Not thread-safe.
+class RotatingLogFile {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Policy {
+        std::uint64_t maxFileBytes = 1024 * 1024;
+        std::chrono::hours maxFileAge{24};
+        std::size_t retainedFiles = 3;
+        std::size_t bufferBytes = 16 * 1024;
+        std::chrono::milliseconds commitInterval{250};
+    };
+
+    // bytesCommitted / commits is the average write size; records / commits
+    // how many records each write saved. Counted since construction.
+    struct Counters {
+        std::uint64_t records = 0;
+        std::uint64_t bytesCommitted = 0;
+        std::uint64_t commits = 0;
+        std::uint64_t rotations = 0;
+        std::uint64_t failedWrites = 0;
+    };
+
+    RotatingLogFile() = default;
+    RotatingLogFile(const RotatingLogFile&) = delete;
+    RotatingLogFile& operator=(const RotatingLogFile&) = delete;
+    ~RotatingLogFile()
+    {
+        Close();
+    }
+
+    // Takes effect for the next record.
+    void SetPolicy(const Policy& policy)
+    {
+        policy_ = policy;
+        if (policy_.retainedFiles == 0) {
+            policy_.retainedFiles = 1;
+        }
+        buffer_.reserve(policy_.bufferBytes);
+    }
+    const Policy& GetPolicy() const
+    {
+        return policy_;
+    }
+
+    // Appends to an existing file, unless that is already over the limits.
+    bool Open(const std::filesystem::path& path, Clock::time_point now)
+    {
+        Close();
+        path_ = path;
+
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(path_, ec);
+        fileBytes_ = ec ? 0 : size;
+        if (!ec) {
+            const auto lastWrite = std::filesystem::last_write_time(path_, ec);
+            const auto age = std::filesystem::file_time_type::clock::now() -
+                             lastWrite;
+            if (fileBytes_ >= policy_.maxFileBytes ||
+                (!ec && age >= policy_.maxFileAge))
+            {
+                ShiftFiles();
+                fileBytes_ = 0;
+            }
+        }
+        return OpenCurrent(now);
+    }
+
+    void Close()
+    {
+        if (file_.is_open()) {
+            Commit();
+            file_.close();
+        }
+    }
+
+    bool IsOpen() const
+    {
+        return file_.is_open();
+    }
+
+    // Closes the file, if open, and deletes `path` along with all of its
+    // rotated files. Nothing is created, so this also cleans up after a
+    // previous run without opening the file first.
+    void Remove(const std::filesystem::path& path)
+    {
+        Close();
+        buffer_.clear();
+        path_ = path;
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+        // A smaller retention setting, or a file deleted by hand, can leave
+        // gaps: look at every index rather than stopping at the first one
+        // that is missing.
+        for (std::size_t i = 1; i <= kMaxRetainedFiles; ++i) {
+            std::filesystem::remove(RotatedPath(i), ec);
+        }
+    }
+
+    // `record` must be complete, including its line break.
+    void Append(std::string_view record, bool commitNow, Clock::time_point now)
+    {
+        if (!file_.is_open()) {
+            return;
+        }
+        if (fileBytes_ + buffer_.size() + record.size() >
+                policy_.maxFileBytes ||
+            now - fileOpened_ >= policy_.maxFileAge)
+        {
+            if (fileBytes_ + buffer_.size() != 0) {
+                Commit();
+                Rotate(now);
+            } else {
+                fileOpened_ = now;
+            }
+        } else if (buffer_.size() + record.size() > policy_.bufferBytes) {
+            Commit();
+        }
+        if (buffer_.empty()) {
+            firstBuffered_ = now;
+        }
+        buffer_.append(record);
+        ++counters_.records;
+        if (commitNow || buffer_.size() >= policy_.bufferBytes ||
+            now - firstBuffered_ >= policy_.commitInterval)
+        {
+            Commit();
+        }
+    }
+
+    // Commits buffered records once they have waited for the commit interval.
+    void CommitIfDue(Clock::time_point now)
+    {
+        if (!buffer_.empty() && now - firstBuffered_ >= policy_.commitInterval)
+        {
+            Commit();
+        }
+    }
+
+    // When CommitIfDue has work to do; Clock::time_point::max() if nothing is
+    // buffered.
+    Clock::time_point CommitDeadline() const
+    {
+        return buffer_.empty() ? Clock::time_point::max()
+                               : firstBuffered_ + policy_.commitInterval;
+    }
+
+    void Commit()
+    {
+        if (buffer_.empty() || !file_.is_open()) {
+            return;
+        }
+        file_.write(buffer_.data(), static_cast<std::streamsize>(
+                                        buffer_.size()));
+        file_.flush();
+        if (file_.good()) {
+            fileBytes_ += buffer_.size();
+            counters_.bytesCommitted += buffer_.size();
+            ++counters_.commits;
+        } else {
+            file_.clear();
+            ++counters_.failedWrites;
+        }
+        buffer_.clear();
+    }
+
+    const Counters& GetCounters() const
+    {
+        return counters_;
+    }
+
+   private:
+    // Upper bound for the retained files Remove() looks for.
+    static constexpr std::size_t kMaxRetainedFiles = 100;
+
+    std::filesystem::path RotatedPath(std::size_t index) const
+    {
+        auto path = path_;
+        path += ".";
+        path += std::to_string(index);
+        return path;
+    }
+
+    void ShiftFiles()
+    {
+        std::error_code ec;
+        const auto retained =
+            policy_.retainedFiles < kMaxRetainedFiles ? policy_.retainedFiles
+                                                      : kMaxRetainedFiles;
+        std::filesystem::remove(RotatedPath(retained), ec);
+        for (std::size_t i = retained; i > 1; --i) {
+            std::filesystem::rename(RotatedPath(i - 1), RotatedPath(i), ec);
+        }
+        std::filesystem::rename(path_, RotatedPath(1), ec);
+    }
+
+    bool OpenCurrent(Clock::time_point now)
+    {
+        file_.open(path_, std::ios::out | std::ios::app | std::ios::binary);
+        fileOpened_ = now;
+        return file_.is_open();
+    }
+
+    void Rotate(Clock::time_point now)
+    {
+        file_.close();
+        ShiftFiles();
+        fileBytes_ = 0;
+        ++counters_.rotations;
+        OpenCurrent(now);
+    }
+
+    Policy policy_;
+    std::filesystem::path path_;
+    std::ofstream file_;
+    std::uint64_t fileBytes_ = 0;
+    Clock::time_point fileOpened_{};
+    std::string buffer_;
+    Clock::time_point firstBuffered_{};
+    Counters counters_;
+};
@@ -67,11 +67,11 @@ enum SettingsPageId {
 struct SettingsPageDesc {
     int templateId;
     DLGPROC dlgProc;
-    const char* titleId;
+    TextKey titleId;
 };
 
 struct SettingsGroupDesc {
-    const char* titleId;
+    TextKey titleId;
     int firstPage;
     int pageCount;
 };
@@ -337,13 +337,13 @@ struct SettingsDlgData {
 };
 
 static HTREEITEM InsertNavItem(HWND hTree, HTREEITEM hParent,
-                               const std::wstring& text, LPARAM data)
+                               std::wstring_view text, LPARAM data)
 {
     TVINSERTSTRUCTW tvis = {0};
     tvis.hParent = (hParent == nullptr) ? TVI_ROOT : hParent;
     tvis.hInsertAfter = TVI_LAST;
     tvis.item.mask = TVIF_TEXT | TVIF_PARAM;
-    tvis.item.pszText = const_cast<LPWSTR>(text.c_str());
+    tvis.item.pszText = const_cast<LPWSTR>(text.data());
     tvis.item.lParam = data;
     return TreeView_InsertItem(hTree, &tvis);
 }
@@ -430,7 +430,7 @@ INT_PTR CALLBACK SettingsDlgProc(HWND hDlg, UINT msg, WPARAM wParam,
             SetWindowLongPtr(hDlg, DWLP_USER,
                              reinterpret_cast<LONG_PTR>(dlgData));
 
-            SetWindowText(hDlg, i18n.GetTranslationW("settings.title").c_str());
+            SetWindowText(hDlg, i18n.GetTranslationW("settings.title").data());
             i18n.SetItemText(hDlg, IDOK, "settings.btn-save");
             i18n.SetItemText(hDlg, IDCANCEL, "settings.btn-cancel");
 
@@ -81,7 +81,7 @@ static void LoadBluetoothAddDlgTranslation(HWND hDlg, bool isEdit)
     const auto placeholder = i18n.GetTranslationW(
         "settings.bluetooth.add-edit.enter-device-name-placeholder");
     ComboBox_SetCueBannerText(GetDlgItem(hDlg, IDC_BT_DEVICE_NAME),
-                              placeholder.c_str());
+                              placeholder.data());
 }
 
 static INT_PTR CALLBACK Settings_BluetoothAddDlgProc(HWND hDlg, UINT msg,
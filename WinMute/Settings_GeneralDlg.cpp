@@ -81,12 +81,11 @@ static void LoadLanguageDlgTranslation(HWND hDlg)
 {
     WMi18n& i18n = WMi18n::GetInstance();
 
-    const auto helpTranslateLink = std::vformat(
+    const auto helpTranslateLink = std::format(
         L"<a "
         L"href=\"https://github.com/lx-s/WinMute/blob/main/"
         L"CONTRIBUTING.md#translations\">{}</a>",
-        std::make_wformat_args(
-            i18n.GetTranslationW("settings.general.help-translating")));
+        i18n.GetTranslationW("settings.general.help-translating"));
 
     SetDlgItemText(hDlg, IDC_LINK_HELP_TRANSLATING, helpTranslateLink.c_str());
     i18n.SetItemText(hDlg, IDC_SELECT_LANGUAGE_LABEL,
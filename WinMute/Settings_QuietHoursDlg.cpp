@@ -118,10 +118,10 @@ static bool ShowOverlapError(HWND hParent)
         hParent, nullptr, PROGRAM_NAME,
         i18n.GetTranslationW(
                 "settings.quiet-hours.error.overlapping-time-range.title")
-            .c_str(),
+            .data(),
         i18n.GetTranslationW(
                 "settings.quiet-hours.error.overlapping-time-range.text")
-            .c_str(),
+            .data(),
         TDCBF_OK_BUTTON, TD_WARNING_ICON, nullptr);
     return false;
 }
@@ -166,10 +166,10 @@ static bool SaveQuietHours(WMSettings* settings, const int enabled,
             nullptr, nullptr, PROGRAM_NAME,
             i18n.GetTranslationW(
                     "settings.quiet-hours.error.error-while-saving.title")
-                .c_str(),
+                .data(),
             i18n.GetTranslationW(
                     "settings.quiet-hours.error.error-while-saving.text")
-                .c_str(),
+                .data(),
             TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return false;
     }
@@ -251,10 +251,10 @@ static INT_PTR CALLBACK Settings_QuietHoursAddDlgProc(HWND hDlg, UINT msg,
                         nullptr, nullptr, PROGRAM_NAME,
                         i18n.GetTranslationW("settings.quiet-hours.error."
                                              "invalid-time-range.title")
-                            .c_str(),
+                            .data(),
                         i18n.GetTranslationW("settings.quiet-hours.error."
                                              "invalid-time-range.text")
-                            .c_str(),
+                            .data(),
                         TDCBF_OK_BUTTON, TD_WARNING_ICON, nullptr);
                     return FALSE;
                 } else {
@@ -316,13 +316,13 @@ static void SetupListView(HWND hListView)
     lvCol.mask = LVCF_FMT | LVCF_TEXT | LVCF_WIDTH | LVCF_ORDER;
     lvCol.fmt = LVCFMT_LEFT;
     lvCol.cx = 75;
-    lvCol.pszText = const_cast<LPWSTR>(textBegin.c_str());
+    lvCol.pszText = const_cast<LPWSTR>(textBegin.data());
     lvCol.cchTextMax = static_cast<int>(textBegin.length());
     lvCol.iOrder = 0;
     ListView_InsertColumn(hListView, 0, &lvCol);
 
     lvCol.cx = 75;
-    lvCol.pszText = const_cast<LPWSTR>(textEnd.c_str());
+    lvCol.pszText = const_cast<LPWSTR>(textEnd.data());
     lvCol.cchTextMax = static_cast<int>(textEnd.length());
     lvCol.iOrder = 1;
     ListView_InsertColumn(hListView, 1, &lvCol);
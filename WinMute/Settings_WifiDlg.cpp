@@ -54,7 +54,7 @@ static void LoadWifiAddDlgTranslation(HWND hDlg, bool isEdit)
 
     const auto placeholder = i18n.GetTranslationW(
         "settings.wifi.add-edit.enter-device-name-placeholder");
-    Edit_SetCueBannerText(GetDlgItem(hDlg, IDC_WIFI_NAME), placeholder.c_str());
+    Edit_SetCueBannerText(GetDlgItem(hDlg, IDC_WIFI_NAME), placeholder.data());
 }
 
 INT_PTR CALLBACK Settings_WifiAddDlgProc(HWND hDlg, UINT msg, WPARAM wParam,
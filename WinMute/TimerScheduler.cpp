@@ -0,0 +1,188 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#include "TimerScheduler.h"
+
+#include "common.h"
+
+extern HINSTANCE hglobInstance;
+
+static const wchar_t* TIMERSCHEDULER_CLASS_NAME = L"WinMuteTimerScheduler";
+static constexpr UINT_PTR SCHEDULER_TIMER_ID = 190500;
+
+static LRESULT CALLBACK TimerSchedulerWndProc(HWND hWnd, UINT msg,
+                                              WPARAM wParam, LPARAM lParam)
+{
+    switch (msg) {
+        case WM_NCCREATE: {
+            LPCREATESTRUCTW cs = reinterpret_cast<LPCREATESTRUCTW>(lParam);
+            SetWindowLongPtrW(hWnd, GWLP_USERDATA,
+                              reinterpret_cast<LONG_PTR>(cs->lpCreateParams));
+            return TRUE;
+        }
+        case WM_TIMER: {
+            auto scheduler = reinterpret_cast<TimerScheduler*>(
+                GetWindowLongPtrW(hWnd, GWLP_USERDATA));
+            if (wParam == SCHEDULER_TIMER_ID && scheduler != nullptr) {
+                scheduler->RunDueTimers();
+            }
+            return 0;
+        }
+        default:
+            break;
+    }
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+TimerScheduler::TimerScheduler() : wheel_(GetTickCount64())
+{
+}
+
+TimerScheduler::~TimerScheduler()
+{
+    Unload();
+}
+
+bool TimerScheduler::Init()
+{
+    if (hWnd_ != nullptr) {
+        return true;
+    }
+    WNDCLASSEXW wndClass{0};
+    wndClass.cbSize = sizeof(wndClass);
+    wndClass.lpfnWndProc = TimerSchedulerWndProc;
+    wndClass.hInstance = hglobInstance;
+    wndClass.lpszClassName = TIMERSCHEDULER_CLASS_NAME;
+    if (!RegisterClassExW(&wndClass)) {
+        WMLog::GetInstance().LogWinError(L"RegisterClassEx");
+        return false;
+    }
+    hWnd_ = CreateWindowExW(0, TIMERSCHEDULER_CLASS_NAME, L"", 0, 0, 0, 0, 0,
+                            HWND_MESSAGE, nullptr, hglobInstance, this);
+    if (hWnd_ == nullptr) {
+        WMLog::GetInstance().LogWinError(L"CreateWindowEx");
+        UnregisterClassW(TIMERSCHEDULER_CLASS_NAME, hglobInstance);
+        return false;
+    }
+    Rearm();
+    return true;
+}
+
+void TimerScheduler::Unload() noexcept
+{
+    if (hWnd_ != nullptr) {
+        KillTimer(hWnd_, SCHEDULER_TIMER_ID);
+        DestroyWindow(hWnd_);
+        hWnd_ = nullptr;
+        UnregisterClassW(TIMERSCHEDULER_CLASS_NAME, hglobInstance);
+    }
+    armedFor_ = 0;
+    timerSet_ = false;
+}
+
+TimerScheduler::TimerHandle TimerScheduler::Schedule(
+    std::chrono::milliseconds delay, TimerWheel::Callback callback)
+{
+    if (hWnd_ == nullptr) {
+        return 0;
+    }
+    // The wheel only moves forward in RunDueTimers, so its notion of "now"
+    // can lag behind. Schedule against the real clock instead.
+    const ULONGLONG deadline =
+        GetTickCount64() + static_cast<ULONGLONG>(std::max<long long>(
+                               delay.count(), 0));
+    const TimerHandle handle =
+        wheel_.ScheduleAt(deadline, std::move(callback));
+    Rearm();
+    return handle;
+}
+
+bool TimerScheduler::Cancel(TimerHandle handle)
+{
+    if (handle == 0) {
+        return false;
+    }
+    const bool cancelled = wheel_.Cancel(handle);
+    if (cancelled) {
+        Rearm();
+    }
+    return cancelled;
+}
+
+bool TimerScheduler::IsPending(TimerHandle handle) const
+{
+    return handle != 0 && wheel_.IsPending(handle);
+}
+
+void TimerScheduler::RunDueTimers()
+{
+    // Callbacks can schedule new timers; the re-arm happens once at the end.
+    running_ = true;
+    armedFor_ = 0;
+    wheel_.Advance(GetTickCount64());
+    running_ = false;
+    Rearm();
+}
+
+void TimerScheduler::Rearm()
+{
+    if (hWnd_ == nullptr || running_) {
+        return;
+    }
+    const auto next = wheel_.NextTick();
+    if (!next) {
+        if (timerSet_) {
+            KillTimer(hWnd_, SCHEDULER_TIMER_ID);
+            timerSet_ = false;
+        }
+        armedFor_ = 0;
+        return;
+    }
+    if (armedFor_ != 0 && armedFor_ <= *next) {
+        return;  // Already firing early enough
+    }
+    const ULONGLONG now = GetTickCount64();
+    const ULONGLONG wait = (*next > now) ? (*next - now) : 0;
+    // SetTimer clamps to USER_TIMER_MAXIMUM (~24.8 days) anyway; waking up
+    // early is harmless, the wheel just re-arms.
+    const UINT elapse = static_cast<UINT>(
+        std::clamp<ULONGLONG>(wait, USER_TIMER_MINIMUM, USER_TIMER_MAXIMUM));
+    if (SetTimer(hWnd_, SCHEDULER_TIMER_ID, elapse, nullptr) == 0) {
+        WMLog::GetInstance().LogWinError(L"SetTimer (scheduler)",
+                                         GetLastError());
+        armedFor_ = 0;
+        return;
+    }
+    timerSet_ = true;
+    armedFor_ = now + elapse;
+}
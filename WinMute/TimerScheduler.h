@@ -0,0 +1,79 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include "TimerWheel.hpp"
+#include "common.h"
+
+// Single timer source for the main thread. Components register callbacks here
+// instead of owning HWND timers with hand-picked IDs. All timers share one
+// TimerWheel and one WM_TIMER, which is always re-armed to the next deadline.
+//
+// A WM_TIMER (instead of a waitable timer) keeps the scheduler running while a
+// modal dialog owns the message loop. Callbacks run on the thread that called
+// Init() and must only be scheduled and cancelled from that thread.
+class TimerScheduler {
+   public:
+    using TimerHandle = TimerWheel::TimerId;
+
+    TimerScheduler();
+    ~TimerScheduler();
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    bool Init();
+    void Unload() noexcept;
+
+    // Returns 0 if the scheduler is not initialized.
+    TimerHandle Schedule(std::chrono::milliseconds delay,
+                         TimerWheel::Callback callback);
+    // Safe to call with 0 or with a handle that already fired.
+    bool Cancel(TimerHandle handle);
+    bool IsPending(TimerHandle handle) const;
+
+    // for internal use
+    void RunDueTimers();
+
+   private:
+    void Rearm();
+
+    HWND hWnd_ = nullptr;
+    TimerWheel wheel_;
+    // Deadline the WM_TIMER is currently set for, 0 if it needs re-arming
+    ULONGLONG armedFor_ = 0;
+    // Whether the WM_TIMER exists. It keeps firing until it is killed, also
+    // while armedFor_ is 0.
+    bool timerSet_ = false;
+    bool running_ = false;
+};
@@ -0,0 +1,358 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Hierarchical timer wheel with millisecond ticks.
+//
+// Every level has 64 slots and covers six more bits of the deadline than the
+// level below it. A timer is filed on the level of the highest bit in which
+// its deadline differs from the current tick, so it only ever moves down a
+// level ("cascades") when the wheel reaches the start of its slot. Inserting
+// and cancelling are O(1); expiring costs O(1) per timer plus at most one
+// cascade per level it was filed on.
+//
+// The wheel has no notion of a clock: the owner passes the current tick to
+// Advance() and uses NextTick() to decide when to call it again. It is not
+// thread-safe.
+class TimerWheel {
+   public:
+    using Callback = std::function<void()>;
+    // 0 never identifies a timer, so it can be used as "no timer".
+    using TimerId = std::uint64_t;
+
+    explicit TimerWheel(std::uint64_t nowTick = 0) : now_(nowTick)
+    {
+        for (auto& level : slots_) {
+            level.fill(kNil);
+        }
+    }
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Runs callback once the wheel has been advanced to nowTick + delay.
+    TimerId Schedule(std::uint64_t delay, Callback callback)
+    {
+        return ScheduleAt(now_ + delay, std::move(callback));
+    }
+
+    // Runs callback once the wheel has been advanced to tick. Ticks that are
+    // already in the past fire on the next Advance().
+    TimerId ScheduleAt(std::uint64_t tick, Callback callback)
+    {
+        const std::uint32_t idx = AllocNode();
+        Node& node = nodes_[idx];
+        node.when = (tick < now_) ? now_ : tick;
+        node.callback = std::move(callback);
+        node.live = true;
+        Link(idx);
+        ++size_;
+        return MakeId(idx, node.generation);
+    }
+
+    // Returns false if the timer already fired or was cancelled.
+    bool Cancel(TimerId id)
+    {
+        const std::uint32_t idx = IdToIndex(id);
+        if (!IsLive(id)) {
+            return false;
+        }
+        if (nodes_[idx].linked) {
+            Unlink(idx);
+        }
+        FreeNode(idx);
+        return true;
+    }
+
+    bool IsPending(TimerId id) const
+    {
+        return IsLive(id);
+    }
+
+    std::size_t Size() const
+    {
+        return size_;
+    }
+
+    // The tick the wheel has been advanced to.
+    std::uint64_t Now() const
+    {
+        return now_;
+    }
+
+    // Earliest tick at which Advance() has work to do: either a timer fires or
+    // a higher level has to be cascaded. Never later than the next expiry, so
+    // it is safe to sleep until then.
+    std::optional<std::uint64_t> NextTick() const
+    {
+        std::optional<std::uint64_t> next;
+        for (int level = 0; level < kLevels; ++level) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            const int shift = level * kSlotBits;
+            const auto cur = static_cast<int>((now_ >> shift) & kSlotMask);
+            const std::uint64_t ahead = occupied_[level] >> cur;
+            if (ahead == 0) {
+                // Only possible for slots that were filed before the level
+                // wrapped, which the invariants rule out.
+                continue;
+            }
+            const int slot = cur + std::countr_zero(ahead);
+            const std::uint64_t span = std::uint64_t{1} << shift;
+            const std::uint64_t base =
+                (shift + kSlotBits >= 64)
+                    ? 0
+                    : (now_ >> (shift + kSlotBits)) << (shift + kSlotBits);
+            std::uint64_t tick = base + static_cast<std::uint64_t>(slot) * span;
+            if (tick < now_) {
+                tick = now_;
+            }
+            if (!next || tick < *next) {
+                next = tick;
+            }
+        }
+        return next;
+    }
+
+    // Fires every timer whose deadline is <= nowTick and returns how many
+    // fired. Callbacks may schedule and cancel timers, including themselves.
+    std::size_t Advance(std::uint64_t nowTick)
+    {
+        std::size_t fired = 0;
+        for (;;) {
+            const auto next = NextTick();
+            if (!next || *next > nowTick) {
+                break;
+            }
+            now_ = *next;
+            Cascade();
+            fired += Expire();
+        }
+        if (nowTick >= now_) {
+            now_ = nowTick + 1;
+        }
+        return fired;
+    }
+
+   private:
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    // 11 * 6 bits cover the whole 64 bit tick range, so no overflow list is
+    // needed. Unused upper levels cost a few hundred bytes.
+    static constexpr int kLevels = (64 + kSlotBits - 1) / kSlotBits;
+    static constexpr std::uint32_t kNil = UINT32_MAX;
+
+    struct Node {
+        std::uint64_t when = 0;
+        std::uint32_t prev = kNil;
+        std::uint32_t next = kNil;
+        std::uint32_t generation = 1;
+        // Where the node is filed. Stored rather than recomputed: once now_
+        // reaches the start of the slot, the deadline maps to a lower level
+        // until the slot has actually been cascaded.
+        std::uint8_t level = 0;
+        std::uint8_t slot = 0;
+        bool live = false;
+        bool linked = false;
+        Callback callback;
+    };
+
+    std::uint64_t now_;
+    std::size_t size_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> freeNodes_;
+    std::array<std::array<std::uint32_t, kSlots>, kLevels> slots_;
+    std::array<std::uint64_t, kLevels> occupied_{};
+    // Reused between Expire() calls to keep expiry allocation-free.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> expiring_;
+
+    static TimerId MakeId(std::uint32_t idx, std::uint32_t generation)
+    {
+        return (static_cast<TimerId>(generation) << 32) | (idx + 1);
+    }
+    static std::uint32_t IdToIndex(TimerId id)
+    {
+        return static_cast<std::uint32_t>(id & 0xFFFFFFFF) - 1;
+    }
+
+    bool IsLive(TimerId id) const
+    {
+        const std::uint32_t idx = IdToIndex(id);
+        return id != 0 && idx < nodes_.size() && nodes_[idx].live &&
+               nodes_[idx].generation == static_cast<std::uint32_t>(id >> 32);
+    }
+
+    std::uint32_t AllocNode()
+    {
+        if (!freeNodes_.empty()) {
+            const std::uint32_t idx = freeNodes_.back();
+            freeNodes_.pop_back();
+            return idx;
+        }
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void FreeNode(std::uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        node.live = false;
+        node.callback = nullptr;
+        ++node.generation;
+        freeNodes_.push_back(idx);
+        --size_;
+    }
+
+    std::pair<int, int> SlotOf(std::uint64_t when) const
+    {
+        const std::uint64_t diff = when ^ now_;
+        const int level =
+            (diff == 0) ? 0
+                        : (static_cast<int>(std::bit_width(diff)) - 1) / kSlotBits;
+        const int slot =
+            static_cast<int>((when >> (level * kSlotBits)) & kSlotMask);
+        return {level, slot};
+    }
+
+    void Link(std::uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        const auto [level, slot] = SlotOf(node.when);
+        node.level = static_cast<std::uint8_t>(level);
+        node.slot = static_cast<std::uint8_t>(slot);
+        std::uint32_t& head = slots_[level][slot];
+        node.prev = kNil;
+        node.next = head;
+        if (head != kNil) {
+            nodes_[head].prev = idx;
+        }
+        head = idx;
+        node.linked = true;
+        occupied_[level] |= std::uint64_t{1} << slot;
+    }
+
+    void Unlink(std::uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        const int level = node.level;
+        const int slot = node.slot;
+        if (node.prev != kNil) {
+            nodes_[node.prev].next = node.next;
+        } else {
+            slots_[level][slot] = node.next;
+        }
+        if (node.next != kNil) {
+            nodes_[node.next].prev = node.prev;
+        }
+        if (slots_[level][slot] == kNil) {
+            occupied_[level] &= ~(std::uint64_t{1} << slot);
+        }
+        node.prev = node.next = kNil;
+        node.linked = false;
+    }
+
+    // Detaches a whole slot and returns its first node.
+    std::uint32_t TakeSlot(int level, int slot)
+    {
+        const std::uint32_t head = slots_[level][slot];
+        slots_[level][slot] = kNil;
+        occupied_[level] &= ~(std::uint64_t{1} << slot);
+        return head;
+    }
+
+    // Redistributes the slots that start at now_, highest level first, so
+    // that their timers end up on the level matching their remaining time.
+    void Cascade()
+    {
+        for (int level = kLevels - 1; level > 0; --level) {
+            const int shift = level * kSlotBits;
+            if ((now_ & ((std::uint64_t{1} << shift) - 1)) != 0) {
+                continue;
+            }
+            const auto slot = static_cast<int>((now_ >> shift) & kSlotMask);
+            if ((occupied_[level] & (std::uint64_t{1} << slot)) == 0) {
+                continue;
+            }
+            std::uint32_t idx = TakeSlot(level, slot);
+            while (idx != kNil) {
+                const std::uint32_t next = nodes_[idx].next;
+                Link(idx);
+                idx = next;
+            }
+        }
+    }
+
+    std::size_t Expire()
+    {
+        const auto slot = static_cast<int>(now_ & kSlotMask);
+        expiring_.clear();
+        for (std::uint32_t idx = TakeSlot(0, slot); idx != kNil;) {
+            Node& node = nodes_[idx];
+            const std::uint32_t next = node.next;
+            node.prev = node.next = kNil;
+            node.linked = false;
+            expiring_.emplace_back(idx, node.generation);
+            idx = next;
+        }
+        // Anything scheduled by the callbacks below lands on a later tick.
+        ++now_;
+
+        std::size_t fired = 0;
+        // Callbacks can re-enter and clobber expiring_, so work on a copy.
+        auto batch = std::move(expiring_);
+        for (const auto& [idx, generation] : batch) {
+            if (!IsLive(MakeId(idx, generation))) {
+                continue;  // cancelled by an earlier callback of this batch
+            }
+            Callback callback = std::move(nodes_[idx].callback);
+            FreeNode(idx);
+            ++fired;
+            if (callback) {
+                callback();
+            }
+        }
+        batch.clear();
+        expiring_ = std::move(batch);
+        return fired;
+    }
+};
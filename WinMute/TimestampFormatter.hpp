@@ -0,0 +1,157 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Formats log timestamps like std::format("{:%F %T%Ez}") does for a zoned
+// time with millisecond precision ("2024-05-01 13:37:00.042+02:00"), but
+// without time zone database work per call:
+//
+//  - The UTC offset is looked up once and reused for as long as the lookup
+//    says it is valid (until the next DST transition), at most for an hour,
+//    or until Invalidate() is called (time zone changed).
+//  - The "YYYY-MM-DD HH:MM:SS" part is cached for the current second.
+//
+// Not thread-safe; use one instance per thread.
+class TimestampFormatter {
+   public:
+    using Clock = std::chrono::system_clock;
+
+    struct ZoneOffset {
+        std::chrono::seconds offset{0};
+        // The offset applies to [begin, end).
+        Clock::time_point begin = Clock::time_point::min();
+        Clock::time_point end = Clock::time_point::max();
+    };
+    using OffsetLookup = std::function<ZoneOffset(Clock::time_point)>;
+
+    explicit TimestampFormatter(OffsetLookup lookup)
+        : lookup_(std::move(lookup))
+    {
+    }
+
+    void Invalidate()
+    {
+        valid_ = false;
+    }
+
+    void FormatTo(std::wstring& out, Clock::time_point time)
+    {
+        using namespace std::chrono;
+        if (!valid_ || time < zone_.begin || time >= zone_.end) {
+            Lookup(time);
+        }
+        const auto local =
+            floor<milliseconds>(time) + duration_cast<milliseconds>(
+                                            zone_.offset);
+        const auto second = floor<seconds>(local);
+        if (second != cachedSecond_) {
+            FormatSecond(second);
+        }
+        out.append(prefix_, kPrefixLength);
+        const auto ms = static_cast<int>((local - second).count());
+        wchar_t fraction[4] = {L'.', static_cast<wchar_t>(L'0' + ms / 100),
+                               static_cast<wchar_t>(L'0' + ms / 10 % 10),
+                               static_cast<wchar_t>(L'0' + ms % 10)};
+        out.append(fraction, 4);
+        out.append(suffix_, kSuffixLength);
+    }
+
+   private:
+    static constexpr std::size_t kPrefixLength = 19;  // YYYY-MM-DD HH:MM:SS
+    static constexpr std::size_t kSuffixLength = 6;   // +HH:MM
+    static constexpr auto kMaxOffsetAge = std::chrono::hours(1);
+
+    static void PutDigits(wchar_t* out, unsigned value, int count)
+    {
+        for (int i = count - 1; i >= 0; --i) {
+            out[i] = static_cast<wchar_t>(L'0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    void Lookup(Clock::time_point time)
+    {
+        zone_ = lookup_(time);
+        if (time < zone_.end - kMaxOffsetAge) {
+            zone_.end = time + kMaxOffsetAge;
+        }
+        valid_ = true;
+        cachedSecond_ = std::chrono::sys_seconds::min();
+
+        const auto minutes =
+            std::chrono::duration_cast<std::chrono::minutes>(zone_.offset)
+                .count();
+        const auto absMinutes = static_cast<unsigned>(minutes < 0 ? -minutes
+                                                                  : minutes);
+        suffix_[0] = minutes < 0 ? L'-' : L'+';
+        PutDigits(suffix_ + 1, absMinutes / 60, 2);
+        suffix_[3] = L':';
+        PutDigits(suffix_ + 4, absMinutes % 60, 2);
+    }
+
+    void FormatSecond(std::chrono::sys_seconds second)
+    {
+        using namespace std::chrono;
+        const auto day = floor<days>(second);
+        const year_month_day ymd{day};
+        const hh_mm_ss hms{second - day};
+        PutDigits(prefix_, static_cast<unsigned>(static_cast<int>(ymd.year())),
+                  4);
+        prefix_[4] = L'-';
+        PutDigits(prefix_ + 5, static_cast<unsigned>(ymd.month()), 2);
+        prefix_[7] = L'-';
+        PutDigits(prefix_ + 8, static_cast<unsigned>(ymd.day()), 2);
+        prefix_[10] = L' ';
+        PutDigits(prefix_ + 11, static_cast<unsigned>(hms.hours().count()), 2);
+        prefix_[13] = L':';
+        PutDigits(prefix_ + 14, static_cast<unsigned>(hms.minutes().count()),
+                  2);
+        prefix_[16] = L':';
+        PutDigits(prefix_ + 17, static_cast<unsigned>(hms.seconds().count()),
+                  2);
+        cachedSecond_ = second;
+    }
+
+    OffsetLookup lookup_;
+    ZoneOffset zone_;
+    bool valid_ = false;
+    std::chrono::sys_seconds cachedSecond_ = std::chrono::sys_seconds::min();
+    wchar_t prefix_[kPrefixLength] = {};
+    wchar_t suffix_[kSuffixLength] = {};
+};
@@ -0,0 +1,350 @@
+// Generated from Translations/lang-en.json by
+// Tools/GenerateTranslationKeys.ps1. Do not edit.
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// One id per key of the default language, in ordinal key order.
+enum class TextId : std::uint16_t {
+    about_btn_close,
+    about_general_author_site_label,
+    about_general_description,
+    about_general_project_site_label,
+    about_general_support_label,
+    about_tab_license,
+    about_tab_third_party,
+    about_tab_winmute,
+    about_title,
+    general_error_audio_service_shutdown_text,
+    general_error_audio_service_shutdown_title,
+    general_error_winapi_text,
+    init_error_already_running_text,
+    init_error_already_running_title,
+    init_error_settings_text,
+    init_error_settings_title,
+    init_error_winmute_migrating_settings_error,
+    init_error_winmute_platform_support_text,
+    init_error_winmute_platform_support_title,
+    init_error_winmute_quiet_hours_corrupted_settings,
+    init_error_winmute_text,
+    init_error_winmute_title,
+    log_column_level,
+    log_column_message,
+    log_column_time,
+    log_filter_level_all,
+    log_filter_level_error,
+    log_filter_level_info,
+    log_filter_level_warning,
+    log_filter_search_hint,
+    log_filter_trigger_any,
+    log_menu_export_mute_latency,
+    log_menu_show_mute_latency,
+    log_title,
+    meta_lang_mode,
+    meta_lang_name,
+    popup_bluetooth_muting_disabled_text,
+    popup_bluetooth_muting_disabled_title,
+    popup_error_global_mute_hotkey_register_text,
+    popup_error_global_mute_hotkey_register_title,
+    popup_error_quiet_hours_start_text,
+    popup_error_quiet_hours_start_title,
+    popup_error_quiet_hours_stop_text,
+    popup_error_quiet_hours_stop_title,
+    popup_error_update_check_failed_text,
+    popup_error_update_check_failed_title,
+    popup_muting_workstation_after_delay_text,
+    popup_muting_workstation_after_delay_title,
+    popup_muting_workstation_text,
+    popup_muting_workstation_title,
+    popup_quiet_hours_ended_text,
+    popup_quiet_hours_ended_title,
+    popup_quiet_hours_started_text,
+    popup_quiet_hours_started_title,
+    popup_remote_session_detected_text,
+    popup_remote_session_detected_title,
+    popup_session_notification_failed_text,
+    popup_session_notification_failed_title,
+    popup_update_available_beta_text,
+    popup_update_available_beta_title,
+    popup_update_available_text,
+    popup_update_available_title,
+    popup_volume_restored_text,
+    popup_volume_restored_title,
+    popup_wlan_is_on_mute_list_text,
+    popup_wlan_muting_disabled_text,
+    popup_wlan_muting_disabled_title,
+    popup_wlan_not_on_mute_list_text,
+    popup_workstation_muted_title,
+    settings_bluetooth_add_edit_add_title,
+    settings_bluetooth_add_edit_device_name_label,
+    settings_bluetooth_add_edit_edit_title,
+    settings_bluetooth_add_edit_enter_device_name_placeholder,
+    settings_bluetooth_bluetooth_disabled_info,
+    settings_bluetooth_description,
+    settings_bluetooth_enable_muting,
+    settings_bluetooth_enable_muting_filter,
+    settings_btn_add,
+    settings_btn_cancel,
+    settings_btn_edit,
+    settings_btn_remove,
+    settings_btn_remove_all,
+    settings_btn_save,
+    settings_general_btn_open_log_file,
+    settings_general_btn_open_log_window,
+    settings_general_check_for_beta_updates_on_start,
+    settings_general_check_for_updates_on_start,
+    settings_general_enable_global_mute_hotkey,
+    settings_general_enable_logging,
+    settings_general_help_translating,
+    settings_general_run_on_startup,
+    settings_general_select_language_label,
+    settings_general_updates_handled_externally,
+    settings_mute_manage_endpoints_individually,
+    settings_mute_manage_endpoints_add_edit_add_title,
+    settings_mute_manage_endpoints_add_edit_edit_title,
+    settings_mute_manage_endpoints_add_edit_endpoint_name_label,
+    settings_mute_manage_endpoints_add_edit_endpoint_name_placeholder,
+    settings_mute_manage_endpoints_endpoints_title,
+    settings_mute_manage_endpoints_list_behaviour_mute_all_but_listed,
+    settings_mute_manage_endpoints_list_behaviour_mute_only_listed,
+    settings_mute_manage_endpoints_list_behaviour_title,
+    settings_mute_mute_with_restore_restore_volume,
+    settings_mute_mute_with_restore_restore_volume_delay_label,
+    settings_mute_mute_with_restore_title,
+    settings_mute_mute_with_restore_when_lid_closes,
+    settings_mute_mute_with_restore_when_screen_turns_off,
+    settings_mute_mute_with_restore_when_workstation_is_locked,
+    settings_mute_mute_without_restore_title,
+    settings_mute_mute_without_restore_when_computer_goes_to_sleep,
+    settings_mute_mute_without_restore_when_computer_shuts_down,
+    settings_mute_mute_without_restore_when_rdp_session_starts,
+    settings_mute_mute_without_restore_when_user_logs_out,
+    settings_mute_show_mute_event_notifications,
+    settings_mute_try_pause_media_on_mute,
+    settings_mute_try_resume_media_on_unmute,
+    settings_nav_general,
+    settings_nav_general_hotkeys,
+    settings_nav_general_language,
+    settings_nav_general_logging,
+    settings_nav_general_startup,
+    settings_nav_muting,
+    settings_nav_muting_endpoints,
+    settings_nav_muting_events,
+    settings_nav_muting_media,
+    settings_nav_triggers,
+    settings_nav_triggers_bluetooth,
+    settings_nav_triggers_quiet_hours,
+    settings_nav_triggers_wifi,
+    settings_quiet_hours_add_edit_add_title,
+    settings_quiet_hours_add_edit_edit_title,
+    settings_quiet_hours_enable,
+    settings_quiet_hours_end_time_label,
+    settings_quiet_hours_error_error_while_saving_text,
+    settings_quiet_hours_error_error_while_saving_title,
+    settings_quiet_hours_error_invalid_time_range_text,
+    settings_quiet_hours_error_invalid_time_range_title,
+    settings_quiet_hours_error_overlapping_time_range_text,
+    settings_quiet_hours_error_overlapping_time_range_title,
+    settings_quiet_hours_force_unmute,
+    settings_quiet_hours_force_unmute_description,
+    settings_quiet_hours_intro,
+    settings_quiet_hours_show_notifications,
+    settings_quiet_hours_start_time_label,
+    settings_title,
+    settings_wifi_add_edit_add_title,
+    settings_wifi_add_edit_edit_title,
+    settings_wifi_add_edit_enter_device_name_placeholder,
+    settings_wifi_add_edit_ssid_name_label,
+    settings_wifi_enable,
+    settings_wifi_intro,
+    settings_wifi_mute_when_in_list,
+    settings_wifi_mute_when_not_in_list,
+    settings_wifi_wifi_disabled_info,
+    traymenu_exit,
+    traymenu_info,
+    traymenu_mute_all_devices,
+    traymenu_mute_no_restore,
+    traymenu_mute_on_lock,
+    traymenu_mute_on_logout,
+    traymenu_mute_on_screen_suspend,
+    traymenu_mute_on_shutdown,
+    traymenu_mute_on_sleep,
+    traymenu_mute_when,
+    traymenu_restore_volume,
+    traymenu_settings,
+    traymenu_show_log,
+    Count
+};
+
+// The key of each TextId.
+inline constexpr std::string_view kTextKeys[] = {
+    "about.btn-close",
+    "about.general.author-site-label",
+    "about.general.description",
+    "about.general.project-site-label",
+    "about.general.support-label",
+    "about.tab.license",
+    "about.tab.third-party",
+    "about.tab.winmute",
+    "about.title",
+    "general.error.audio-service-shutdown.text",
+    "general.error.audio-service-shutdown.title",
+    "general.error.winapi.text",
+    "init.error.already-running.text",
+    "init.error.already-running.title",
+    "init.error.settings.text",
+    "init.error.settings.title",
+    "init.error.winmute.migrating-settings-error",
+    "init.error.winmute.platform-support.text",
+    "init.error.winmute.platform-support.title",
+    "init.error.winmute.quiet-hours-corrupted-settings",
+    "init.error.winmute.text",
+    "init.error.winmute.title",
+    "log.column.level",
+    "log.column.message",
+    "log.column.time",
+    "log.filter.level.all",
+    "log.filter.level.error",
+    "log.filter.level.info",
+    "log.filter.level.warning",
+    "log.filter.search-hint",
+    "log.filter.trigger.any",
+    "log.menu.export-mute-latency",
+    "log.menu.show-mute-latency",
+    "log.title",
+    "meta.lang.mode",
+    "meta.lang.name",
+    "popup.bluetooth-muting-disabled.text",
+    "popup.bluetooth-muting-disabled.title",
+    "popup.error.global-mute-hotkey-register.text",
+    "popup.error.global-mute-hotkey-register.title",
+    "popup.error.quiet-hours-start.text",
+    "popup.error.quiet-hours-start.title",
+    "popup.error.quiet-hours-stop.text",
+    "popup.error.quiet-hours-stop.title",
+    "popup.error.update-check-failed.text",
+    "popup.error.update-check-failed.title",
+    "popup.muting-workstation-after-delay.text",
+    "popup.muting-workstation-after-delay.title",
+    "popup.muting-workstation.text",
+    "popup.muting-workstation.title",
+    "popup.quiet-hours-ended.text",
+    "popup.quiet-hours-ended.title",
+    "popup.quiet-hours-started.text",
+    "popup.quiet-hours-started.title",
+    "popup.remote-session-detected.text",
+    "popup.remote-session-detected.title",
+    "popup.session-notification-failed.text",
+    "popup.session-notification-failed.title",
+    "popup.update-available-beta.text",
+    "popup.update-available-beta.title",
+    "popup.update-available.text",
+    "popup.update-available.title",
+    "popup.volume-restored.text",
+    "popup.volume-restored.title",
+    "popup.wlan-is-on-mute-list.text",
+    "popup.wlan-muting-disabled.text",
+    "popup.wlan-muting-disabled.title",
+    "popup.wlan-not-on-mute-list.text",
+    "popup.workstation-muted.title",
+    "settings.bluetooth.add-edit.add-title",
+    "settings.bluetooth.add-edit.device-name-label",
+    "settings.bluetooth.add-edit.edit-title",
+    "settings.bluetooth.add-edit.enter-device-name-placeholder",
+    "settings.bluetooth.bluetooth-disabled-info",
+    "settings.bluetooth.description",
+    "settings.bluetooth.enable-muting",
+    "settings.bluetooth.enable-muting-filter",
+    "settings.btn-add",
+    "settings.btn-cancel",
+    "settings.btn-edit",
+    "settings.btn-remove",
+    "settings.btn-remove-all",
+    "settings.btn-save",
+    "settings.general.btn-open-log-file",
+    "settings.general.btn-open-log-window",
+    "settings.general.check-for-beta-updates-on-start",
+    "settings.general.check-for-updates-on-start",
+    "settings.general.enable-global-mute-hotkey",
+    "settings.general.enable-logging",
+    "settings.general.help-translating",
+    "settings.general.run-on-startup",
+    "settings.general.select-language-label",
+    "settings.general.updates-handled-externally",
+    "settings.mute.manage-endpoints-individually",
+    "settings.mute.manage-endpoints.add-edit.add-title",
+    "settings.mute.manage-endpoints.add-edit.edit-title",
+    "settings.mute.manage-endpoints.add-edit.endpoint-name-label",
+    "settings.mute.manage-endpoints.add-edit.endpoint-name-placeholder",
+    "settings.mute.manage-endpoints.endpoints.title",
+    "settings.mute.manage-endpoints.list-behaviour.mute-all-but-listed",
+    "settings.mute.manage-endpoints.list-behaviour.mute-only-listed",
+    "settings.mute.manage-endpoints.list-behaviour.title",
+    "settings.mute.mute-with-restore.restore-volume",
+    "settings.mute.mute-with-restore.restore-volume-delay-label",
+    "settings.mute.mute-with-restore.title",
+    "settings.mute.mute-with-restore.when-lid-closes",
+    "settings.mute.mute-with-restore.when-screen-turns-off",
+    "settings.mute.mute-with-restore.when-workstation-is-locked",
+    "settings.mute.mute-without-restore.title",
+    "settings.mute.mute-without-restore.when-computer-goes-to-sleep",
+    "settings.mute.mute-without-restore.when-computer-shuts-down",
+    "settings.mute.mute-without-restore.when-rdp-session-starts",
+    "settings.mute.mute-without-restore.when-user-logs-out",
+    "settings.mute.show-mute-event-notifications",
+    "settings.mute.try-pause-media-on-mute",
+    "settings.mute.try-resume-media-on-unmute",
+    "settings.nav.general",
+    "settings.nav.general.hotkeys",
+    "settings.nav.general.language",
+    "settings.nav.general.logging",
+    "settings.nav.general.startup",
+    "settings.nav.muting",
+    "settings.nav.muting.endpoints",
+    "settings.nav.muting.events",
+    "settings.nav.muting.media",
+    "settings.nav.triggers",
+    "settings.nav.triggers.bluetooth",
+    "settings.nav.triggers.quiet-hours",
+    "settings.nav.triggers.wifi",
+    "settings.quiet-hours.add-edit.add-title",
+    "settings.quiet-hours.add-edit.edit-title",
+    "settings.quiet-hours.enable",
+    "settings.quiet-hours.end-time-label",
+    "settings.quiet-hours.error.error-while-saving.text",
+    "settings.quiet-hours.error.error-while-saving.title",
+    "settings.quiet-hours.error.invalid-time-range.text",
+    "settings.quiet-hours.error.invalid-time-range.title",
+    "settings.quiet-hours.error.overlapping-time-range.text",
+    "settings.quiet-hours.error.overlapping-time-range.title",
+    "settings.quiet-hours.force-unmute",
+    "settings.quiet-hours.force-unmute-description",
+    "settings.quiet-hours.intro",
+    "settings.quiet-hours.show-notifications",
+    "settings.quiet-hours.start-time-label",
+    "settings.title",
+    "settings.wifi.add-edit.add-title",
+    "settings.wifi.add-edit.edit-title",
+    "settings.wifi.add-edit.enter-device-name-placeholder",
+    "settings.wifi.add-edit.ssid-name-label",
+    "settings.wifi.enable",
+    "settings.wifi.intro",
+    "settings.wifi.mute-when-in-list",
+    "settings.wifi.mute-when-not-in-list",
+    "settings.wifi.wifi-disabled-info",
+    "traymenu.exit",
+    "traymenu.info",
+    "traymenu.mute-all-devices",
+    "traymenu.mute-no-restore",
+    "traymenu.mute-on-lock",
+    "traymenu.mute-on-logout",
+    "traymenu.mute-on-screen-suspend",
+    "traymenu.mute-on-shutdown",
+    "traymenu.mute-on-sleep",
+    "traymenu.mute-when",
+    "traymenu.restore-volume",
+    "traymenu.settings",
+    "traymenu.show-log",
+};
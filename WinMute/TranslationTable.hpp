@@ -0,0 +1,236 @@
+/*
+ WinMute
+           Copyright (c) 2011-2026 Alexander Steinhoefer
+
+-----------------------------------------------------------------------------
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice,
+      this list of conditions and the following disclaimer.
+
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+
+    * Neither the name of the author nor the names of its contributors may
+      be used to endorse or promote products derived from this software
+      without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+-----------------------------------------------------------------------------
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TranslationKeys.h"
+
+// A key of the default language, checked at compile time: a string literal
+// converts to a TextKey only if lang-en.json has that key, see
+// TranslationKeys.h.
+class TextKey {
+   public:
+    consteval TextKey(const char* key) : id_(Find(key)) {}
+    constexpr TextKey(TextId id) : id_(id) {}
+
+    constexpr TextId GetId() const
+    {
+        return id_;
+    }
+
+    // Returns TextId::Count for an unknown key.
+    static constexpr TextId Lookup(std::string_view key)
+    {
+        const auto first = std::begin(kTextKeys);
+        const auto it = std::lower_bound(first, std::end(kTextKeys), key);
+        if (it == std::end(kTextKeys) || *it != key) {
+            return TextId::Count;
+        }
+        return static_cast<TextId>(it - first);
+    }
+
+   private:
+    static consteval TextId Find(std::string_view key)
+    {
+        const TextId id = Lookup(key);
+        if (id == TextId::Count) {
+            throw "Unknown translation key";
+        }
+        return id;
+    }
+
+    TextId id_;
+};
+
+// The texts of one language, one per TextId at most. A text is either copied
+// into a buffer shared by all copied texts, each followed by a 0, so a
+// language takes two allocations however many texts it has; or it is
+// referenced where it is, e.g. in a mapped language pack.
+class TranslationTable {
+   public:
+    void Reserve(std::size_t chars)
+    {
+        blob_.reserve(chars);
+    }
+
+    // Copies `text`. Returns false if `id` already has a text.
+    bool Set(TextId id, std::wstring_view text)
+    {
+        Span& span = spans_[static_cast<std::size_t>(id)];
+        if (span.length != 0) {
+            return false;
+        }
+        span.offset = static_cast<std::uint32_t>(blob_.size());
+        span.length = static_cast<std::uint32_t>(text.size());
+        blob_.append(text);
+        blob_.push_back(L'\0');
+        return true;
+    }
+
+    // Like Set, but does not copy: `text` must be null-terminated and
+    // outlive the table, and every table that takes it over with SetFrom.
+    bool Refer(TextId id, std::wstring_view text)
+    {
+        Span& span = spans_[static_cast<std::size_t>(id)];
+        if (span.length != 0) {
+            return false;
+        }
+        span.referenced = text.data();
+        span.length = static_cast<std::uint32_t>(text.size());
+        return true;
+    }
+
+    // Takes over the text `other` has for `id`: refers to it if `other` does,
+    // copies it otherwise.
+    bool SetFrom(TextId id, const TranslationTable& other)
+    {
+        const Span& span = other.spans_[static_cast<std::size_t>(id)];
+        return span.referenced != nullptr ? Refer(id, other.Get(id))
+                                          : Set(id, other.Get(id));
+    }
+
+    // Null-terminated. Empty if `id` has no text.
+    std::wstring_view Get(TextId id) const
+    {
+        const Span& span = spans_[static_cast<std::size_t>(id)];
+        if (span.length == 0) {
+            return L"";
+        } else if (span.referenced != nullptr) {
+            return {span.referenced, span.length};
+        }
+        return {blob_.data() + span.offset, span.length};
+    }
+
+    // The copied characters, including the terminating 0s.
+    std::size_t GetChars() const
+    {
+        return blob_.size();
+    }
+
+    // Compares the texts, not where they are stored.
+    bool operator==(const TranslationTable& other) const
+    {
+        for (std::size_t i = 0; i < spans_.size(); ++i) {
+            const auto id = static_cast<TextId>(i);
+            if (Get(id) != other.Get(id)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+   private:
+    struct Span {
+        const wchar_t* referenced = nullptr;  // or in blob_ at offset
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    std::wstring blob_;
+    std::array<Span, static_cast<std::size_t>(TextId::Count)> spans_{};
+};
+
+// Resolves every fallback once, so a lookup is a plain index: each text is
+// that of `strings`, else that of `defaults`, else `missing(key)`. Referenced
+// texts stay referenced.
+template <typename Missing>
+TranslationTable ResolveTranslations(const TranslationTable& strings,
+                                     const TranslationTable& defaults,
+                                     Missing missing)
+{
+    TranslationTable texts;
+    texts.Reserve(strings.GetChars() + defaults.GetChars());
+    for (std::size_t i = 0; i < std::size(kTextKeys); ++i) {
+        const auto id = static_cast<TextId>(i);
+        if (!strings.Get(id).empty()) {
+            texts.SetFrom(id, strings);
+        } else if (!defaults.Get(id).empty()) {
+            texts.SetFrom(id, defaults);
+        } else {
+            texts.Set(id, missing(kTextKeys[i]));
+        }
+    }
+    return texts;
+}
+
+// The texts handed out, read without a lock while another thread switches
+// the language. A table is immutable once published and never freed before
+// the object is destroyed, so readers need neither a lock nor a reference
+// count, and a text stays valid across language switches. Publishing the
+// same texts again reuses their table, so switching back and forth does not
+// add up.
+//
+// Publish must be serialized by the caller; Get may run concurrently with it.
+class PublishedTranslations {
+   public:
+    void Publish(TranslationTable texts)
+    {
+        const auto known = std::find_if(
+            tables_.begin(), tables_.end(),
+            [&texts](const auto& table) { return *table == texts; });
+        if (known != tables_.end()) {
+            current_.store(known->get(), std::memory_order_release);
+            return;
+        }
+        tables_.push_back(
+            std::make_unique<const TranslationTable>(std::move(texts)));
+        current_.store(tables_.back().get(), std::memory_order_release);
+    }
+
+    // Null-terminated. Only valid after the first Publish.
+    std::wstring_view Get(TextId id) const
+    {
+        return current_.load(std::memory_order_acquire)->Get(id);
+    }
+
+    // Tables published so far, without repeats.
+    std::size_t GetTableCount() const
+    {
+        return tables_.size();
+    }
+
+   private:
+    std::vector<std::unique_ptr<const TranslationTable>> tables_;
+    std::atomic<const TranslationTable*> current_{nullptr};
+};
@@ -129,8 +129,8 @@ void TrayIcon::ChangeText(const std::wstring& tooltip)
         ChangeText();
 }
 
-void TrayIcon::ShowPopup(const std::wstring& title,
-                         const std::wstring& text) const
+void TrayIcon::ShowPopup(std::wstring_view title,
+                         std::wstring_view text) const
 {
     if (!initialized_) {
         TrayIconPopup popup;
@@ -146,9 +146,10 @@ void TrayIcon::ShowPopup(const std::wstring& title,
     tnid.uFlags = NIF_INFO | NIF_SHOWTIP;
     tnid.dwInfoFlags =
         NIIF_INFO | NIIF_NOSOUND | NIIF_LARGE_ICON | NIIF_RESPECT_QUIET_TIME;
-    StringCchCopy(tnid.szInfoTitle, ARRAY_SIZE(tnid.szInfoTitle),
-                  title.c_str());
-    StringCchCopy(tnid.szInfo, ARRAY_SIZE(tnid.szInfo), text.c_str());
+    StringCchCopyNW(tnid.szInfoTitle, ARRAY_SIZE(tnid.szInfoTitle),
+                    title.data(), title.size());
+    StringCchCopyNW(tnid.szInfo, ARRAY_SIZE(tnid.szInfo), text.data(),
+                    text.size());
 
     Shell_NotifyIcon(NIM_MODIFY, &tnid);
 }
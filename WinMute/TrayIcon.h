@@ -58,7 +58,7 @@ class TrayIcon {
     }
     void ChangeIcon(HICON hNewIcon);
     void ChangeText(const std::wstring& tooltip);
-    void ShowPopup(const std::wstring& title, const std::wstring& text) const;
+    void ShowPopup(std::wstring_view title, std::wstring_view text) const;
 
    private:
     void DestroyTrayIcon();
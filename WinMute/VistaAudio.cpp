@@ -117,6 +117,7 @@ bool VistaAudio::LoadAllEndpoints()
             continue;
         }
         ep->deviceId = *deviceId;
+        ep->stateSlot = GetStateSlot(ep->deviceId);
 
         const auto deviceName = GetAudioDeviceName(device);
         if (!deviceName) {
@@ -174,6 +175,19 @@ bool VistaAudio::LoadAllEndpoints()
     return true;
 }
 
+std::size_t VistaAudio::GetStateSlot(const std::wstring& deviceId)
+{
+    // Only a handful of devices ever show up, so a linear scan is fine; it
+    // runs on (re-)init, never per mute cycle.
+    for (std::size_t i = 0; i < endpointStates_.size(); ++i) {
+        if (endpointStates_[i].deviceId == deviceId) {
+            return i;
+        }
+    }
+    endpointStates_.push_back(EndpointState{.deviceId = deviceId});
+    return endpointStates_.size() - 1;
+}
+
 bool VistaAudio::Init(HWND hParent)
 {
     WMLog& log = WMLog::GetInstance();
@@ -214,6 +228,11 @@ void VistaAudio::ShouldReInit()
     reInit_ = true;
 }
 
+bool VistaAudio::WarmUp()
+{
+    return CheckForReInit();
+}
+
 void VistaAudio::OnAudioServiceShutdown()
 {
     PostMessageW(hParent_, WM_WINMUTE_AUDIO_SERVICE_SHUTDOWN, 0, 0);
@@ -276,71 +295,83 @@ bool VistaAudio::AllEndpointsMuted()
 // must not be touched.
 static constexpr auto LATE_RESTORE_WINDOW = std::chrono::seconds(60);
 
-bool VistaAudio::SaveMuteStatus()
+std::uint32_t VistaAudio::SaveMuteStatus()
 {
-    bool success = true;
     WMLog& log = WMLog::GetInstance();
 
-    if (CheckForReInit()) {
-        // A new mute cycle supersedes any restore still waiting for a device.
-        pendingRestoreIds_.clear();
-        savedMuteState_.clear();
-        for (auto& e : endpoints_) {
-            BOOL isMuted = FALSE;
-            if (FAILED(e->endpointVolume->GetMute(&isMuted))) {
-                log.LogError(L"Failed to get mute status for \"{}\"",
-                             e->deviceName);
-                success = false;
-            } else {
-                savedMuteState_[e->deviceId] = !!isMuted;
-            }
+    if (!CheckForReInit()) {
+        return 0;
+    }
+    // A new mute cycle supersedes the previous save and any restore still
+    // waiting for a device; bumping the stamps invalidates both at once.
+    ++saveGeneration_;
+    ++restorePass_;
+    pendingRestoreCount_ = 0;
+    for (auto& e : endpoints_) {
+        EndpointState& state = endpointStates_[e->stateSlot];
+        BOOL isMuted = FALSE;
+        if (FAILED(e->endpointVolume->GetMute(&isMuted))) {
+            log.LogError(L"Failed to get mute status for \"{}\"",
+                         e->deviceName);
+        } else {
+            state.wasMuted = isMuted != FALSE;
+            state.savedIn = saveGeneration_;
         }
     }
-    return success;
+    return saveGeneration_;
 }
 
 bool VistaAudio::RestoreEndpoint(const Endpoint& ep, bool wasMuted)
 {
     WMLog& log = WMLog::GetInstance();
 
-    log.LogInfo(L"Restoring: Mute {} for \"{}\"", wasMuted ? L"true" : L"false",
-                ep.deviceName);
+    log.LogEvent(LogLevel::Info,
+                 {LogEventCode::EndpointRestored, nullptr, ep.deviceId},
+                 L"Restoring: Mute {} for \"{}\"",
+                 wasMuted ? L"true" : L"false", ep.deviceName);
     if (wasMuted) {
         return true;
     }
     if (FAILED(ep.endpointVolume->SetMute(false, nullptr))) {
-        log.LogError(L"Failed to restore mute status to false for \"{}\"",
+        log.LogEvent(LogLevel::Error,
+                     {LogEventCode::EndpointError, nullptr, ep.deviceId},
+                     L"Failed to restore mute status to false for \"{}\"",
                      ep.deviceName);
         return false;
     }
     return true;
 }
 
-bool VistaAudio::RestoreMuteStatus()
+bool VistaAudio::RestoreMuteStatus(std::uint32_t generation)
 {
     bool success = true;
     WMLog& log = WMLog::GetInstance();
 
+    if (generation == 0 || generation != saveGeneration_) {
+        log.LogError(L"Saved mute state #{} is no longer available",
+                     generation);
+        return false;
+    }
     if (!CheckForReInit()) {
         return false;
     }
 
-    pendingRestoreIds_.clear();
-    std::set<std::wstring> presentIds;
+    ++restorePass_;
+    pendingRestoreCount_ = 0;
     for (auto& e : endpoints_) {
-        presentIds.insert(e->deviceId);
+        EndpointState& state = endpointStates_[e->stateSlot];
+        state.seenIn = restorePass_;
         if (!IsEndpointManaged(*e)) {
             log.LogInfo(L"Skipping Endpoint {}", e->deviceName);
             continue;
         }
-        const auto saved = savedMuteState_.find(e->deviceId);
-        if (saved == savedMuteState_.end()) {
+        if (state.savedIn != saveGeneration_) {
             // Appeared after the mute event; nothing was remembered for it.
             log.LogInfo(L"No saved mute state for \"{}\"; leaving it alone",
                         e->deviceName);
             continue;
         }
-        if (!RestoreEndpoint(*e, saved->second)) {
+        if (!RestoreEndpoint(*e, state.wasMuted)) {
             success = false;
         }
     }
@@ -349,18 +380,21 @@ bool VistaAudio::RestoreMuteStatus()
     // monitor's HDMI/DisplayPort audio, for example) keep the mute flag
     // Windows persisted for them. Remember them so their reappearance within
     // the next minute still completes the restore.
-    for (const auto& [deviceId, wasMuted] : savedMuteState_) {
-        if (presentIds.count(deviceId) == 0 && !wasMuted) {
-            pendingRestoreIds_.insert(deviceId);
+    for (auto& state : endpointStates_) {
+        if (state.savedIn == saveGeneration_ && state.seenIn != restorePass_ &&
+            !state.wasMuted)
+        {
+            state.pendingIn = restorePass_;
+            ++pendingRestoreCount_;
         }
     }
-    if (!pendingRestoreIds_.empty()) {
+    if (pendingRestoreCount_ != 0) {
         restoreDeadline_ = std::chrono::steady_clock::now() +
                            LATE_RESTORE_WINDOW;
         log.LogInfo(
             L"{} endpoint(s) were not present at restore time."
             L" Waiting up to {}s for them to reappear",
-            pendingRestoreIds_.size(), LATE_RESTORE_WINDOW.count());
+            pendingRestoreCount_, LATE_RESTORE_WINDOW.count());
     }
 
     return success;
@@ -370,32 +404,34 @@ void VistaAudio::RestoreArrivedEndpoints()
 {
     WMLog& log = WMLog::GetInstance();
 
-    if (pendingRestoreIds_.empty()) {
+    if (pendingRestoreCount_ == 0) {
         return;
     }
     if (std::chrono::steady_clock::now() > restoreDeadline_) {
         log.LogInfo(
             L"Endpoint arrived, but the restore window has expired."
             L" Discarding {} pending restore(s)",
-            pendingRestoreIds_.size());
-        pendingRestoreIds_.clear();
+            pendingRestoreCount_);
+        ++restorePass_;
+        pendingRestoreCount_ = 0;
         return;
     }
     if (!CheckForReInit()) {
         return;
     }
     for (auto& e : endpoints_) {
-        if (pendingRestoreIds_.count(e->deviceId) == 0) {
+        EndpointState& state = endpointStates_[e->stateSlot];
+        if (state.pendingIn != restorePass_) {
             continue;
         }
+        state.pendingIn = 0;
+        --pendingRestoreCount_;
         if (!IsEndpointManaged(*e)) {
             log.LogInfo(L"Skipping Endpoint {}", e->deviceName);
-            pendingRestoreIds_.erase(e->deviceId);
             continue;
         }
         log.LogInfo(L"Endpoint \"{}\" reappeared after restore", e->deviceName);
         RestoreEndpoint(*e, false);
-        pendingRestoreIds_.erase(e->deviceId);
     }
 }
 
@@ -409,13 +445,17 @@ void VistaAudio::SetMute(bool mute)
                 log.LogInfo(L"Skipping Endpoint {}", e->deviceName);
                 continue;
             }
+            const LogEventInfo endpointError{LogEventCode::EndpointError,
+                                             nullptr, e->deviceId};
             if (FAILED(e->endpointVolume->GetMute(&isMuted))) {
-                log.LogError(L"Failed to get mute status for \"{}\"",
+                log.LogEvent(LogLevel::Error, endpointError,
+                             L"Failed to get mute status for \"{}\"",
                              e->deviceName);
             }
             if (!!isMuted != mute) {
                 if (FAILED(e->endpointVolume->SetMute(mute, nullptr))) {
-                    log.LogError(L"Failed to set mute status to {} for \"{}\"",
+                    log.LogEvent(LogLevel::Error, endpointError,
+                                 L"Failed to set mute status to {} for \"{}\"",
                                  mute ? L"true" : L"false", e->deviceName);
                 }
             }
@@ -35,7 +35,7 @@ POSSIBILITY OF SUCH DAMAGE.
 
 #include "common.h"
 
-static const wchar_t* LogLevelToString(LogLevel level)
+const wchar_t* WMLog::GetLevelName(LogLevel level)
 {
     switch (level) {
         case LogLevel::Debug:
@@ -51,10 +51,64 @@ static const wchar_t* LogLevelToString(LogLevel level)
     }
 }
 
-static bool OpenLogFile(const std::wstring& filePath, std::wofstream& logFile)
+const wchar_t* WMLog::GetEventName(LogEventCode event)
 {
-    logFile.open(filePath, std::ios::out | std::ios::app | std::ios::binary);
-    return logFile.is_open();
+    switch (event) {
+        case LogEventCode::TriggerStart:
+            return L"trigger_start";
+        case LogEventCode::TriggerEnd:
+            return L"trigger_end";
+        case LogEventCode::Muted:
+            return L"muted";
+        case LogEventCode::Restore:
+            return L"restore";
+        case LogEventCode::EndpointRestored:
+            return L"endpoint_restored";
+        case LogEventCode::EndpointError:
+            return L"endpoint_error";
+        case LogEventCode::None:
+        default:
+            return L"";
+    }
+}
+
+static TimestampFormatter::ZoneOffset LookUpZoneOffset(
+    TimestampFormatter::Clock::time_point time)
+{
+    namespace ch = std::chrono;
+    using Clock = TimestampFormatter::Clock;
+
+    // Zones without DST report a validity range far beyond what the clock
+    // can represent, so clamp before converting to clock ticks.
+    constexpr auto minSeconds = ch::ceil<ch::seconds>(
+        Clock::time_point::min().time_since_epoch());
+    constexpr auto maxSeconds = ch::floor<ch::seconds>(
+        Clock::time_point::max().time_since_epoch());
+    const auto info = ch::current_zone()->get_info(time);
+
+    TimestampFormatter::ZoneOffset zone;
+    zone.offset = info.offset;
+    if (info.begin.time_since_epoch() > minSeconds) {
+        zone.begin = Clock::time_point{info.begin.time_since_epoch()};
+    }
+    if (info.end.time_since_epoch() < maxSeconds) {
+        zone.end = Clock::time_point{info.end.time_since_epoch()};
+    }
+    return zone;
+}
+
+static void ConvertToUtf8(const std::wstring& text, std::string& utf8)
+{
+    utf8.clear();
+    const int length = static_cast<int>(text.length());
+    const int size = WideCharToMultiByte(CP_UTF8, 0, text.c_str(), length,
+                                         nullptr, 0, nullptr, nullptr);
+    if (size <= 0) {
+        return;
+    }
+    utf8.resize(static_cast<size_t>(size));
+    WideCharToMultiByte(CP_UTF8, 0, text.c_str(), length, utf8.data(), size,
+                        nullptr, nullptr);
 }
 
 WMLog& WMLog::GetInstance()
@@ -63,35 +117,52 @@ WMLog& WMLog::GetInstance()
     return log;
 }
 
+// How long an error message may wait for room in the full queue before it is
+// dropped as well. Everything else is dropped right away: a logging thread
+// (WASAPI or WLAN callbacks among them) must never stall on the log.
+static constexpr auto ERROR_BACKPRESSURE_TIMEOUT =
+    std::chrono::milliseconds(50);
+
 WMLog::WMLog() : enabled_(false)
 {
+    logFile_.SetPolicy(RotatingLogFile::Policy{});
+    writer_ = std::jthread([this](std::stop_token stopToken) {
+        WriterLoop(stopToken);
+    });
 }
 
 WMLog::~WMLog()
 {
-    if (logFile_.is_open()) {
-        logFile_.close();
+    // The writer drains the queue before it exits.
+    writer_.request_stop();
+    writerWakeup_.release();
+    if (writer_.joinable()) {
+        writer_.join();
     }
+    logFile_.Close();
+    jsonFile_.Close();
 }
 
-std::wstring WMLog::GetLogFilePath()
+std::wstring WMLog::GetJsonLogFilePath()
 {
     wchar_t tempPath[MAX_PATH + 1];
     if (GetTempPathW(ARRAY_SIZE(tempPath), tempPath)) {
         std::wstring path{tempPath};
-        path += LOG_FILE_NAME;
+        path += LOG_JSON_FILE_NAME;
         return path;
     }
     return std::wstring();
 }
 
-void WMLog::DeleteLogFile()
+std::wstring WMLog::GetLogFilePath()
 {
-    const auto logFilePath = GetLogFilePath();
-    if (logFile_.is_open()) {
-        logFile_.close();
+    wchar_t tempPath[MAX_PATH + 1];
+    if (GetTempPathW(ARRAY_SIZE(tempPath), tempPath)) {
+        std::wstring path{tempPath};
+        path += LOG_FILE_NAME;
+        return path;
     }
-    DeleteFileW(logFilePath.c_str());
+    return std::wstring();
 }
 
 void WMLog::EnableLogFile(bool enable)
@@ -99,112 +170,363 @@ void WMLog::EnableLogFile(bool enable)
     const std::lock_guard lock(logMutex_);
     if (enable == enabled_) {
         if (!enable) {
-            DeleteLogFile();
+            logFile_.Remove(GetLogFilePath());
+            jsonFile_.Remove(GetJsonLogFilePath());
         }
         return;
     }
 
     if (enable) {
-        if (OpenLogFile(GetLogFilePath(), logFile_)) {
+        const auto now = RotatingLogFile::Clock::now();
+        if (logFile_.Open(GetLogFilePath(), now)) {
             enabled_ = true;
+            if (jsonEnabled_) {
+                jsonFile_.Open(GetJsonLogFilePath(), now);
+            }
         }
     } else {
-        if (logFile_.is_open()) {
-            logFile_.close();
-        }
-        DeleteLogFile();
+        logFile_.Remove(GetLogFilePath());
+        jsonFile_.Remove(GetJsonLogFilePath());
         enabled_ = false;
     }
 }
 
+void WMLog::EnableJsonLog(bool enable)
+{
+    const std::lock_guard lock(logMutex_);
+    if (enable == jsonEnabled_) {
+        return;
+    }
+    jsonEnabled_ = enable;
+    if (!enabled_) {
+        return;
+    }
+    if (enable) {
+        jsonFile_.Open(GetJsonLogFilePath(), RotatingLogFile::Clock::now());
+    } else {
+        jsonFile_.Remove(GetJsonLogFilePath());
+    }
+}
+
+void WMLog::SetLogFileLimits(std::uint64_t maxFileBytes,
+                             std::chrono::hours maxFileAge,
+                             std::size_t retainedFiles)
+{
+    const std::lock_guard lock(logMutex_);
+    auto policy = logFile_.GetPolicy();
+    policy.maxFileBytes = maxFileBytes;
+    policy.maxFileAge = maxFileAge;
+    policy.retainedFiles = retainedFiles;
+    logFile_.SetPolicy(policy);
+    jsonFile_.SetPolicy(policy);
+}
+
+RotatingLogFile::Counters WMLog::GetLogFileCounters() const
+{
+    const std::lock_guard lock(logMutex_);
+    return logFile_.GetCounters();
+}
+
 bool WMLog::IsLogFileEnabled() const
 {
     return enabled_;
 }
 
+void WMLog::FormatLogTime(std::chrono::system_clock::time_point time,
+                          std::wstring& out) const
+{
+    // Both the writer thread and the log window format messages; give each
+    // its own cache.
+    thread_local TimestampFormatter timestamps{LookUpZoneOffset};
+    thread_local std::uint32_t zoneGeneration = 0;
+    const auto currentGeneration =
+        zoneGeneration_.load(std::memory_order_relaxed);
+    if (currentGeneration != zoneGeneration) {
+        timestamps.Invalidate();
+        zoneGeneration = currentGeneration;
+    }
+    timestamps.FormatTo(out, time);
+}
+
 std::wstring WMLog::FormatLogMessage(const LogMessage& logMsg,
                                      bool new_line) const
 {
-    auto msg = std::format(L"{:%F %T%Ez}  {}:  {}{}", logMsg.time,
-                           LogLevelToString(logMsg.level), logMsg.message,
-                           new_line ? L"\r\n" : L"");
+    std::wstring msg;
+    FormatLogTime(logMsg.time, msg);
+    msg += L"  ";
+    msg += GetLevelName(logMsg.level);
+    msg += L":  ";
+    logMsg.message.FormatTo(msg);
+    if (new_line) {
+        msg += L"\r\n";
+    }
     return msg;
 }
 
-void WMLog::StoreMessage(LogLevel level, const wchar_t* msg)
+void WMLog::RefreshTimeZone()
+{
+    zoneGeneration_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WMLog::SetMinimumLevel(LogLevel level)
+{
+    minLevel_.store(level, std::memory_order_relaxed);
+}
+
+void WMLog::StoreMessage(LogMessage& lm)
 {
     namespace ch = std::chrono;
 
+    lm.time = ch::system_clock::now();
+    lm.monotonic = ch::steady_clock::now();
+
+    bool queued = queue_.TryPush(std::move(lm));
+    if (!queued && lm.level == LogLevel::Error) {
+        const auto deadline =
+            ch::steady_clock::now() + ERROR_BACKPRESSURE_TIMEOUT;
+        do {
+            if (writerWaiting_.exchange(false)) {
+                writerWakeup_.release();
+            }
+            std::this_thread::yield();
+            queued = queue_.TryPush(std::move(lm));
+        } while (!queued && ch::steady_clock::now() < deadline);
+    }
+    if (!queued) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // Pairs with the fence in WriterLoop: either the writer sees the new
+    // message before it goes to sleep, or we see that it is waiting.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerWaiting_.exchange(false)) {
+        writerWakeup_.release();
+    }
+}
+
+void WMLog::WriterLoop(std::stop_token stopToken)
+{
+    std::uint64_t reportedDropped = 0;
     LogMessage lm;
-    lm.level = level;
-    lm.message = msg;
-    lm.time = ch::zoned_time<ch::milliseconds>{
-        ch::current_zone(),
-        ch::floor<ch::milliseconds>(ch::system_clock::now())};
+    for (;;) {
+        while (queue_.TryPop(lm)) {
+            FoldOrWriteMessage(lm);
+        }
+        const auto dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            LogMessage report;
+            report.level = LogLevel::Warning;
+            report.message.Capture<std::uint64_t>(
+                L"{} log message(s) dropped: the log queue was full",
+                dropped - reportedDropped);
+            report.time = std::chrono::system_clock::now();
+            report.monotonic = std::chrono::steady_clock::now();
+            WriteMessage(report);
+            reportedDropped = dropped;
+        }
+        // Once per batch, so a burst of records costs the log windows a
+        // single update.
+        NotifyLogWindows();
+        if (stopToken.stop_requested()) {
+            break;
+        }
+        writerWaiting_.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.TryPop(lm)) {
+            writerWaiting_.store(false);
+            FoldOrWriteMessage(lm);
+            continue;
+        }
+
+        // Sleep until the next message, but no longer than buffered records
+        // may wait for their commit or a folded run for being reported.
+        auto deadline = repeatFolder_.Deadline();
+        {
+            const std::scoped_lock<std::mutex> lock(logMutex_);
+            deadline = std::min({deadline, logFile_.CommitDeadline(),
+                                 jsonFile_.CommitDeadline()});
+        }
+        if (deadline == RotatingLogFile::Clock::time_point::max()) {
+            writerWakeup_.acquire();
+        } else if (!writerWakeup_.try_acquire_until(deadline)) {
+            const auto now = RotatingLogFile::Clock::now();
+            WriteRepeatCount(repeatFolder_.Last(),
+                             repeatFolder_.TakeRepeats(now));
+            NotifyLogWindows();
+            const std::scoped_lock<std::mutex> lock(logMutex_);
+            logFile_.CommitIfDue(now);
+            jsonFile_.CommitIfDue(now);
+        }
+    }
+    WriteRepeatCount(repeatFolder_.Last(),
+                     repeatFolder_.TakeRepeats(
+                         RotatingLogFile::Clock::now(), true));
+    const std::scoped_lock<std::mutex> lock(logMutex_);
+    logFile_.Commit();
+    jsonFile_.Commit();
+}
 
+void WMLog::FoldOrWriteMessage(LogMessage& lm)
+{
+    const auto now = std::chrono::steady_clock::now();
+    // A run that ends is reported while the folder still holds its record.
+    if (repeatFolder_.PendingRepeats() != 0 &&
+        !lm.Repeats(repeatFolder_.Last()))
+    {
+        WriteRepeatCount(repeatFolder_.Last(),
+                         repeatFolder_.TakeRepeats(now, true));
+    }
+    std::uint64_t repeats = 0;
+    const bool folded = repeatFolder_.Offer(lm, now, repeats);
+    WriteRepeatCount(repeatFolder_.Last(), repeats);
+    if (!folded) {
+        WriteMessage(lm);
+    }
+}
+
+void WMLog::WriteRepeatCount(const LogMessage& run, std::uint64_t repeats)
+{
+    if (repeats == 0) {
+        return;
+    }
+    LogMessage summary;
+    summary.level = run.level;
+    summary.event = run.event;
+    summary.trigger = run.trigger;
+    summary.duration = run.duration;
+    summary.endpointId = run.endpointId;
+    summary.repeats = repeats;
+    summary.time = std::chrono::system_clock::now();
+    summary.monotonic = std::chrono::steady_clock::now();
+    summary.message.Capture<std::uint64_t>(
+        L"Last message repeated {} times", repeats);
+    WriteMessage(summary);
+}
+
+void WMLog::WriteMessage(LogMessage& lm)
+{
     {
         // logMutex_ also guards logFile_, which EnableLogFile can close
         // concurrently from another thread.
         const std::scoped_lock<std::mutex> lock(logMutex_);
-        if (enabled_ && logFile_.is_open()) {
-            const auto logMsg = FormatLogMessage(lm, true);
-            logFile_.write(logMsg.c_str(), logMsg.length());
-            logFile_.flush();
+        LogMessage& stored = logMessages_.Append(lm.seq);
+        stored = lm;
+        if (enabled_ && logFile_.IsOpen()) {
+            ConvertToUtf8(FormatLogMessage(lm, true), utf8Record_);
+            logFile_.Append(utf8Record_, lm.level == LogLevel::Error,
+                            RotatingLogFile::Clock::now());
+        }
+        if (enabled_ && jsonFile_.IsOpen()) {
+            WriteJsonLine(lm);
         }
     }
+}
 
-    {
-        // Copy the window list first: holding wndMutex_ across SendMessageW
-        // deadlocks if the UI thread is simultaneously blocked on wndMutex_
-        // in (Un)RegisterForLogUpdates.
-        std::vector<HWND> logWindows;
-        {
-            const std::scoped_lock<std::mutex> lock(wndMutex_);
-            logWindows = registeredWindows_;
-        }
-        for (const auto hWnd : logWindows) {
-            if (IsWindow(hWnd)) {
-                SendMessageW(hWnd, WM_LOG_UPDATED, 0,
-                             reinterpret_cast<LPARAM>(&lm));
-            }
-        }
+void WMLog::AttachEvent(LogMessage& lm, const LogEventInfo& event)
+{
+    lm.event = event.code;
+    lm.trigger = event.trigger;
+    lm.duration = event.duration;
+    const auto length =
+        std::min(event.endpointId.length(), lm.endpointId.size() - 1);
+    std::copy_n(event.endpointId.data(), length, lm.endpointId.data());
+    lm.endpointId[length] = L'\0';
+}
+
+void WMLog::WriteJsonLine(const LogMessage& lm)
+{
+    namespace ch = std::chrono;
+
+    jsonTime_.clear();
+    FormatLogTime(lm.time, jsonTime_);
+    jsonMessage_.clear();
+    lm.message.FormatTo(jsonMessage_);
+
+    JsonLogRecord record;
+    record.level = GetLevelName(lm.level);
+    record.monotonicUs =
+        ch::duration_cast<ch::microseconds>(lm.monotonic.time_since_epoch())
+            .count();
+    record.time = jsonTime_;
+    record.event = GetEventName(lm.event);
+    if (lm.trigger != nullptr) {
+        record.trigger = lm.trigger;
     }
+    record.endpoint = lm.endpointId.data();
+    record.durationUs = lm.duration.count();
+    record.repeats = lm.repeats;
+    record.message = jsonMessage_;
 
-    {
-        const std::scoped_lock<std::mutex> lock(logMutex_);
-        logMessages_.push_back(std::move(lm));
-        if (logMessages_.size() >= kMaxLogEntries_) {
-            logMessages_.erase(logMessages_.begin(),
-                               logMessages_.begin() +
-                                   (logMessages_.size() - kMaxLogEntries_ / 2));
+    jsonLine_.clear();
+    AppendJsonLogLine(jsonLine_, record);
+    jsonFile_.Append(jsonLine_, lm.level == LogLevel::Error,
+                     RotatingLogFile::Clock::now());
+}
+
+void WMLog::NotifyLogWindows()
+{
+    const auto endSeq = GetEndSequence();
+    // PostMessageW never waits for the receiver, so holding wndMutex_ is
+    // fine here. A window that has not picked up the last notification yet
+    // will see these records as well when it does.
+    const std::scoped_lock<std::mutex> lock(wndMutex_);
+    for (auto& logWindow : registeredWindows_) {
+        if (logWindow.notified || logWindow.notifiedUpTo >= endSeq) {
+            continue;
+        }
+        if (PostMessageW(logWindow.hWnd, WM_LOG_UPDATED, 0,
+                         static_cast<LPARAM>(endSeq)))
+        {
+            logWindow.notified = true;
+            logWindow.notifiedUpTo = endSeq;
         }
     }
 }
 
-std::vector<LogMessage> WMLog::GetLogMessages() const
+std::uint64_t WMLog::GetFirstSequence() const
+{
+    const std::scoped_lock<std::mutex> lock(logMutex_);
+    return logMessages_.FirstSeq();
+}
+
+std::uint64_t WMLog::GetEndSequence() const
 {
     const std::scoped_lock<std::mutex> lock(logMutex_);
-    return logMessages_;
+    return logMessages_.EndSeq();
+}
+
+std::uint64_t WMLog::GetDroppedMessageCount() const
+{
+    return dropped_.load(std::memory_order_relaxed);
 }
 
 void WMLog::RegisterForLogUpdates(HWND hWnd)
 {
     const std::scoped_lock<std::mutex> lock(wndMutex_);
-    if (std::find(registeredWindows_.begin(), registeredWindows_.end(), hWnd) ==
-        registeredWindows_.end())
+    if (std::find_if(registeredWindows_.begin(), registeredWindows_.end(),
+                     [hWnd](const LogWindow& logWindow) {
+                         return logWindow.hWnd == hWnd;
+                     }) == registeredWindows_.end())
     {
-        registeredWindows_.push_back(hWnd);
+        registeredWindows_.push_back({hWnd, false, 0});
     }
 }
 
 void WMLog::UnregisterForLogUpdates(HWND hWnd)
 {
     const std::scoped_lock<std::mutex> lock(wndMutex_);
-    if (const auto it = std::find(registeredWindows_.begin(),
-                                  registeredWindows_.end(), hWnd);
-        it != registeredWindows_.end())
-    {
-        registeredWindows_.erase(it);
+    std::erase_if(registeredWindows_, [hWnd](const LogWindow& logWindow) {
+        return logWindow.hWnd == hWnd;
+    });
+}
+
+void WMLog::AcknowledgeLogUpdate(HWND hWnd)
+{
+    const std::scoped_lock<std::mutex> lock(wndMutex_);
+    for (auto& logWindow : registeredWindows_) {
+        if (logWindow.hWnd == hWnd) {
+            logWindow.notified = false;
+        }
     }
 }
 
@@ -228,6 +550,9 @@ void WMLog::LogWinError(const wchar_t* functionName, DWORD lastError)
     const std::wstring errorMsg = SafeVFormat(
         WMi18n::GetInstance().GetTranslationW("general.error.winapi.text"),
         functionName, lastError, errorMsgText);
-    StoreMessage(LogLevel::Error, errorMsg.c_str());
+    LogMessage lm;
+    lm.level = LogLevel::Error;
+    lm.message.CaptureText(errorMsg);
+    StoreMessage(lm);
     LocalFree(lpMsgBuf);
 }
@@ -44,10 +44,60 @@ enum class LogLevel {
     Error,
 };
 
+// What a record is about, for the JSON lines log. The names of these end up
+// in collected logs (see WMLog::GetEventName), so only ever append.
+enum class LogEventCode : std::uint8_t {
+    None,
+    TriggerStart,
+    TriggerEnd,
+    Muted,
+    Restore,
+    EndpointRestored,
+    EndpointError,
+};
+
+struct LogEventInfo {
+    LogEventCode code = LogEventCode::None;
+    // A string with static storage duration
+    // (MuteLatencyStats::TriggerToString), or nullptr.
+    const wchar_t* trigger = nullptr;
+    std::wstring_view endpointId;
+    // Negative if the event has no duration.
+    std::chrono::microseconds duration{-1};
+};
+
+// Fixed size, so the history never allocates after startup.
 struct LogMessage {
+    std::uint64_t seq = 0;  // assigned when the message enters the history
     LogLevel level = LogLevel::Info;
-    std::chrono::zoned_time<std::chrono::milliseconds> time;
-    std::wstring message;
+    // Raw clock readings; converted to local time only when formatted.
+    std::chrono::system_clock::time_point time;
+    std::chrono::steady_clock::time_point monotonic;
+    // Only formatted when a sink (log file, log window) needs the text.
+    // Strings that do not fit are cut off.
+    DeferredFormat<512> message;
+
+    LogEventCode event = LogEventCode::None;
+    const wchar_t* trigger = nullptr;
+    std::chrono::microseconds duration{-1};
+    // Zero-terminated, cut off if longer. Endpoint ids are ~55 characters.
+    std::array<wchar_t, 64> endpointId{};
+    // Set on the summary of folded repeats, which keeps the event fields of
+    // the record that was repeated.
+    std::uint64_t repeats = 0;
+
+    // Whether this record only differs from `other` in its seq and its clock
+    // readings. Such repeats are folded into a count, so every field that is
+    // not compared here is lost for them.
+    bool Repeats(const LogMessage& other) const
+    {
+        // Triggers have static storage, their address identifies them.
+        return level == other.level && event == other.event &&
+               trigger == other.trigger && duration == other.duration &&
+               std::wstring_view(endpointId.data()) ==
+                   std::wstring_view(other.endpointId.data()) &&
+               message.SameAs(other.message);
+    }
 };
 
 class WMLog {
@@ -55,43 +105,94 @@ class WMLog {
     static WMLog& GetInstance();
 
     // The format string is validated against the arguments at compile time.
+    // Nothing is formatted here: the arguments are captured and only
+    // formatted once a sink needs the text. Messages below the minimum level
+    // return before touching the arguments.
     template <typename... Args>
     void LogDebug(std::wformat_string<Args...> fmt, Args&&... args)
     {
-        StoreMessage(LogLevel::Debug,
-                     std::format(fmt, std::forward<Args>(args)...).c_str());
+        Log<Args...>(LogLevel::Debug, nullptr, fmt, args...);
     }
     template <typename... Args>
     void LogInfo(std::wformat_string<Args...> fmt, Args&&... args)
     {
-        StoreMessage(LogLevel::Info,
-                     std::format(fmt, std::forward<Args>(args)...).c_str());
+        Log<Args...>(LogLevel::Info, nullptr, fmt, args...);
     }
     template <typename... Args>
     void LogWarning(std::wformat_string<Args...> fmt, Args&&... args)
     {
-        StoreMessage(LogLevel::Warning,
-                     std::format(fmt, std::forward<Args>(args)...).c_str());
+        Log<Args...>(LogLevel::Warning, nullptr, fmt, args...);
     }
     template <typename... Args>
     void LogError(std::wformat_string<Args...> fmt, Args&&... args)
     {
-        StoreMessage(LogLevel::Error,
-                     std::format(fmt, std::forward<Args>(args)...).c_str());
+        Log<Args...>(LogLevel::Error, nullptr, fmt, args...);
+    }
+    // A message that also carries structured fields for the JSON lines log.
+    template <typename... Args>
+    void LogEvent(LogLevel level, const LogEventInfo& event,
+                  std::wformat_string<Args...> fmt, Args&&... args)
+    {
+        Log<Args...>(level, &event, fmt, args...);
     }
     void LogWinError(const wchar_t* functionName, DWORD errorCode = -1);
 
+    bool IsLevelEnabled(LogLevel level) const
+    {
+        return level >= minLevel_.load(std::memory_order_relaxed);
+    }
+    void SetMinimumLevel(LogLevel level);
+
     void EnableLogFile(bool enable);
     bool IsLogFileEnabled() const;
+    // Writes a JSON lines log (LOG_JSON_FILE_NAME) next to the log file,
+    // whenever the log file is enabled.
+    void EnableJsonLog(bool enable);
     std::wstring GetLogFilePath();
+    // Rotation limits for the log file; see RotatingLogFile::Policy.
+    void SetLogFileLimits(std::uint64_t maxFileBytes,
+                          std::chrono::hours maxFileAge,
+                          std::size_t retainedFiles);
+    RotatingLogFile::Counters GetLogFileCounters() const;
 
-    std::vector<LogMessage> GetLogMessages() const;
+    // Calls fn(const LogMessage&) for the stored messages with a sequence
+    // number in [fromSeq, toSeq), oldest first. The messages are not copied;
+    // the history is locked while fn runs, so fn must not log.
+    template <typename Fn>
+    void VisitLogMessages(std::uint64_t fromSeq, std::uint64_t toSeq,
+                          Fn&& fn) const
+    {
+        const std::scoped_lock<std::mutex> lock(logMutex_);
+        logMessages_.ForEach(
+            fromSeq, toSeq,
+            [&fn](std::uint64_t, const LogMessage& lm) { fn(lm); });
+    }
+    // Sequence number of the oldest stored message.
+    std::uint64_t GetFirstSequence() const;
+    // Sequence number the next stored message will get.
+    std::uint64_t GetEndSequence() const;
 
+    // Registered windows get WM_LOG_UPDATED posted (lParam: the end sequence
+    // number at that time) when new messages were stored. Further
+    // notifications are held back until the window calls
+    // AcknowledgeLogUpdate, which it must do before reading the new messages.
     void RegisterForLogUpdates(HWND hWnd);
     void UnregisterForLogUpdates(HWND hWnd);
+    void AcknowledgeLogUpdate(HWND hWnd);
 
     std::wstring FormatLogMessage(const LogMessage& logMsg,
                                   bool new_line = false) const;
+    // The pieces of FormatLogMessage, for showing them separately.
+    void FormatLogTime(std::chrono::system_clock::time_point time,
+                       std::wstring& out) const;
+    static const wchar_t* GetLevelName(LogLevel level);
+    static const wchar_t* GetEventName(LogEventCode event);
+    // Drops the cached UTC offset used for formatting timestamps. Call when
+    // the system time or time zone changed (WM_TIMECHANGE).
+    void RefreshTimeZone();
+
+    // Messages lost because the queue to the writer thread was full.
+    std::uint64_t GetDroppedMessageCount() const;
 
    private:
     WMLog();
@@ -99,16 +200,82 @@ class WMLog {
     WMLog(const WMLog&) = delete;
     WMLog& operator=(const WMLog&) = delete;
 
-    const size_t kMaxLogEntries_ = 500;
+    static constexpr size_t kMaxLogEntries_ = 1024;
 
-    void StoreMessage(LogLevel level, const wchar_t* msg);
-    void DeleteLogFile();
+    template <typename... Args>
+    void Log(LogLevel level, const LogEventInfo* event,
+             std::wformat_string<Args...> fmt, const Args&... args)
+    {
+        if (!IsLevelEnabled(level)) {
+            return;
+        }
+        LogMessage lm;
+        lm.level = level;
+        lm.message.Capture<Args...>(fmt, args...);
+        if (event != nullptr) {
+            AttachEvent(lm, *event);
+        }
+        StoreMessage(lm);
+    }
+    static void AttachEvent(LogMessage& lm, const LogEventInfo& event);
+
+    // Only queues the message; formatting, file I/O and notifying the log
+    // windows happen on the writer thread.
+    void StoreMessage(LogMessage& lm);
+    void WriterLoop(std::stop_token stopToken);
+    void FoldOrWriteMessage(LogMessage& lm);
+    void WriteRepeatCount(const LogMessage& run, std::uint64_t repeats);
+    void WriteMessage(LogMessage& lm);
+    void NotifyLogWindows();
+    std::wstring GetJsonLogFilePath();
+    void WriteJsonLine(const LogMessage& lm);
 
+    // logMutex_ guards the file and the history, which the writer thread
+    // and the UI share. Logging threads never take it.
     mutable std::mutex logMutex_;
     mutable std::mutex wndMutex_;
 
     bool enabled_;
-    std::wofstream logFile_;
-    std::vector<LogMessage> logMessages_;
-    std::vector<HWND> registeredWindows_;
+    // UTF-8. Records are buffered and committed in batches by the writer
+    // thread; errors are committed right away.
+    RotatingLogFile logFile_;
+    std::string utf8Record_;
+    bool jsonEnabled_ = false;
+    RotatingLogFile jsonFile_;
+    // Reused for every JSON line, so the sink does not allocate per record.
+    std::wstring jsonTime_;
+    std::wstring jsonMessage_;
+    std::string jsonLine_;
+    LogRing<LogMessage> logMessages_{kMaxLogEntries_};
+    struct LogWindow {
+        HWND hWnd;
+        // WM_LOG_UPDATED is posted and not acknowledged yet.
+        bool notified;
+        std::uint64_t notifiedUpTo;
+    };
+    std::vector<LogWindow> registeredWindows_;
+
+    MpscQueue<LogMessage, 1024> queue_;
+    struct SameLogMessage {
+        bool operator()(const LogMessage& a, const LogMessage& b) const
+        {
+            return a.Repeats(b);
+        }
+    };
+    // Writer thread only. Folds event storms before they reach the history
+    // and the file.
+    RepeatFolder<LogMessage, SameLogMessage> repeatFolder_;
+    std::atomic<LogLevel> minLevel_{LogLevel::Info};
+    std::atomic<std::uint64_t> dropped_{0};
+    // Bumped by RefreshTimeZone; each formatting thread compares it against
+    // the generation its cached offset was taken in.
+    std::atomic<std::uint32_t> zoneGeneration_{0};
+    // Set by the writer before it waits, so only the first producer after
+    // that has to signal.
+    std::atomic<bool> writerWaiting_{false};
+    std::counting_semaphore<> writerWakeup_{0};
+
+    // Declared last: it is stopped and joined first, while all other
+    // members are still alive.
+    std::jthread writer_;
 };
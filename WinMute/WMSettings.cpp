@@ -101,6 +101,9 @@ static const wchar_t* KeyToStr(SettingsKey key)
         case SettingsKey::MUTE_DELAY:
             keyStr = L"MuteDelay";
             break;
+        case SettingsKey::MUTE_GRACE_PERIOD:
+            keyStr = L"MuteGracePeriod";
+            break;
         case SettingsKey::MUTE_TRY_PAUSE_MEDIA:
             keyStr = L"MuteTryPauseMedia";
             break;
@@ -146,6 +149,24 @@ static const wchar_t* KeyToStr(SettingsKey key)
         case SettingsKey::GLOBAL_MUTE_HOTKEY:
             keyStr = L"GlobalMuteHotkey";
             break;
+        case SettingsKey::MUTE_RULES:
+            keyStr = L"MuteRules";
+            break;
+        case SettingsKey::LOG_LEVEL:
+            keyStr = L"LogLevel";
+            break;
+        case SettingsKey::LOG_MAX_FILE_SIZE_KB:
+            keyStr = L"LogMaxFileSizeKB";
+            break;
+        case SettingsKey::LOG_MAX_FILE_AGE_HOURS:
+            keyStr = L"LogMaxFileAgeHours";
+            break;
+        case SettingsKey::LOG_RETAINED_FILES:
+            keyStr = L"LogRetainedFiles";
+            break;
+        case SettingsKey::LOG_JSON_ENABLED:
+            keyStr = L"LogJsonEnabled";
+            break;
     }
     return keyStr;
 }
@@ -181,6 +202,8 @@ static DWORD GetDefaultSetting(SettingsKey key)
             return MUTE_ENDPOINT_MODE_INDIVIDUAL_ALLOW_LIST;
         case SettingsKey::MUTE_DELAY:
             return 0;
+        case SettingsKey::MUTE_GRACE_PERIOD:
+            return 0;
         case SettingsKey::MUTE_TRY_PAUSE_MEDIA:
             return 1;
         case SettingsKey::MUTE_TRY_RESUME_MEDIA:
@@ -207,6 +230,18 @@ static DWORD GetDefaultSetting(SettingsKey key)
             return 0;
         case SettingsKey::MANAGED_ENDPOINTS_ID_MIGRATED:
             return 0;
+        case SettingsKey::MUTE_RULES:
+            return 0;
+        case SettingsKey::LOG_LEVEL:
+            return static_cast<DWORD>(LogLevel::Info);
+        case SettingsKey::LOG_MAX_FILE_SIZE_KB:
+            return 1024;
+        case SettingsKey::LOG_MAX_FILE_AGE_HOURS:
+            return 24;
+        case SettingsKey::LOG_RETAINED_FILES:
+            return 3;
+        case SettingsKey::LOG_JSON_ENABLED:
+            return 0;
     }
     return 0;
 }
@@ -328,10 +363,10 @@ bool WMSettings::MigrateSettings()
             WMLog::GetInstance().LogError(
                 L"Error migrating Quiet Hours settings");
             TaskDialog(nullptr, nullptr, PROGRAM_NAME,
-                       i18n.GetTranslationW("init.error.winmute.title").c_str(),
+                       i18n.GetTranslationW("init.error.winmute.title").data(),
                        i18n.GetTranslationW(
                                "init.error.winmute.migrating-settings-error")
-                           .c_str(),
+                           .data(),
                        TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         }
     }
@@ -785,9 +820,9 @@ std::vector<std::pair<DWORD, DWORD>> WMSettings::GetQuietHoursTimes()
             numEntries);
         TaskDialog(
             nullptr, nullptr, PROGRAM_NAME,
-            i18n.GetTranslationW("init.error.winmute.title").c_str(),
+            i18n.GetTranslationW("init.error.winmute.title").data(),
             i18n.GetTranslationW("init.error.winmute.migrating-settings-error")
-                .c_str(),
+                .data(),
             TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         StoreQuietHoursTimes({});
         return {};
@@ -58,6 +58,8 @@ enum class SettingsKey {
     // 1 = mute specific (allowlist), 2 = mute specific (blocklist)
     MUTE_INDIVIDUAL_ENDPOINTS_MODE,
     MUTE_DELAY,
+    // In milliseconds, see MuteControl::SetMuteGracePeriod
+    MUTE_GRACE_PERIOD,
     MUTE_TRY_PAUSE_MEDIA,
     MUTE_TRY_RESUME_MEDIA,
     QUIETHOURS_ENABLE,
@@ -76,7 +78,18 @@ enum class SettingsKey {
     // pass has run. This is deliberately not folded into SETTINGS_VERSION:
     // MigrateSettings() runs from WMSettings::Init(), which happens before
     // CoInitializeEx(), so it cannot enumerate audio devices.
-    MANAGED_ENDPOINTS_ID_MIGRATED
+    MANAGED_ENDPOINTS_ID_MIGRATED,
+    // ';'-separated MuteRuleSet rules, e.g. "lock & !wlan; display"
+    MUTE_RULES,
+    // Minimum LogLevel that is recorded: 0 = Debug ... 3 = Error
+    LOG_LEVEL,
+    // Log file rotation: size and age limits of the current file and how
+    // many rotated files are kept
+    LOG_MAX_FILE_SIZE_KB,
+    LOG_MAX_FILE_AGE_HOURS,
+    LOG_RETAINED_FILES,
+    // Also write the JSON lines log while logging is enabled
+    LOG_JSON_ENABLED
 };
 
 class WMSettings {
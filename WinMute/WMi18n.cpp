@@ -37,12 +37,23 @@ extern HINSTANCE hglobInstance;
 
 WMi18n::WMi18n() noexcept
 {
+    PublishTexts(TranslationTable{});
 }
 
 WMi18n::~WMi18n() noexcept
 {
 }
 
+WMi18n::MappedPack::~MappedPack()
+{
+    if (view != nullptr) {
+        UnmapViewOfFile(view);
+    }
+    if (hMapping != nullptr) {
+        CloseHandle(hMapping);
+    }
+}
+
 WMi18n& WMi18n::GetInstance()
 {
     static WMi18n inst;
@@ -65,43 +76,70 @@ std::optional<fs::path> WMi18n::GetLanguageFilesPath() const
     return langPath.remove_filename() / L"lang";
 }
 
+static std::uint64_t ToUInt64(DWORD high, DWORD low)
+{
+    return (static_cast<std::uint64_t>(high) << 32) | low;
+}
+
 std::vector<LanguageModule> WMi18n::GetAvailableLanguages() const
 {
     std::vector<LanguageModule> langDlls;
     const auto langPath = GetLanguageFilesPath();
-    if (langPath.has_value()) {
-        const fs::path searchPath = *langPath / L"*.json";
-        WIN32_FIND_DATAW wfd{0};
-        HANDLE hFindFile = FindFirstFileExW(
-            searchPath.c_str(), FindExInfoBasic, &wfd, FindExSearchNameMatch,
-            nullptr, FIND_FIRST_EX_CASE_SENSITIVE);
-        if (hFindFile != INVALID_HANDLE_VALUE) {
-            do {
-                try {
-                    const fs::path langFilePath = *langPath / wfd.cFileName;
-                    std::ifstream json_file(langFilePath);
-                    nlohmann::json file_info = nlohmann::json::parse(json_file);
-                    if (file_info.contains("meta.lang.name")) {
-                        LanguageModule langMod;
-                        langMod.fileName = wfd.cFileName;
-                        langMod.langName = ConvertStringToWideString(
-                            file_info["meta.lang.name"]);
-                        langDlls.push_back(langMod);
-                    }
-                } catch (const nlohmann::json::parse_error& pe) {
-                    WMLog::GetInstance().LogError(
-                        L"Failed to parse language file \"{}\": {}",
-                        wfd.cFileName, ConvertStringToWideString(pe.what()));
-                }
-            } while (FindNextFileW(hFindFile, &wfd));
-        }
+    if (!langPath.has_value()) {
+        return langDlls;
     }
+    const fs::path searchPath = *langPath / L"*.json";
+    WIN32_FIND_DATAW wfd{0};
+    HANDLE hFindFile =
+        FindFirstFileExW(searchPath.c_str(), FindExInfoBasic, &wfd,
+                         FindExSearchNameMatch, nullptr,
+                         FIND_FIRST_EX_CASE_SENSITIVE);
+    if (hFindFile == INVALID_HANDLE_VALUE) {
+        return langDlls;
+    }
+    const std::lock_guard lock(scanMutex_);
+    std::map<std::wstring, ScannedLanguage> scanned;
+    do {
+        ScannedLanguage file;
+        file.size = ToUInt64(wfd.nFileSizeHigh, wfd.nFileSizeLow);
+        file.writeTime = ToUInt64(wfd.ftLastWriteTime.dwHighDateTime,
+                                  wfd.ftLastWriteTime.dwLowDateTime);
+        const auto known = scannedLanguages_.find(wfd.cFileName);
+        if (known != scannedLanguages_.end() &&
+            known->second.size == file.size &&
+            known->second.writeTime == file.writeTime)
+        {
+            file.langName = known->second.langName;
+        } else {
+            std::ifstream json_file(*langPath / wfd.cFileName,
+                                    std::ios::binary);
+            LanguageNameReader reader;
+            nlohmann::json::sax_parse(json_file, &reader);
+            if (reader.name.has_value()) {
+                file.langName = ConvertStringToWideString(*reader.name);
+            } else if (!reader.error.empty()) {
+                WMLog::GetInstance().LogError(
+                    L"Failed to parse language file \"{}\": {}",
+                    wfd.cFileName, ConvertStringToWideString(reader.error));
+            }
+        }
+        if (!file.langName.empty()) {
+            LanguageModule langMod;
+            langMod.fileName = wfd.cFileName;
+            langMod.langName = file.langName;
+            langDlls.push_back(langMod);
+        }
+        scanned.emplace(wfd.cFileName, std::move(file));
+    } while (FindNextFileW(hFindFile, &wfd));
+    FindClose(hFindFile);
+    // Forget removed files.
+    scannedLanguages_ = std::move(scanned);
     return langDlls;
 }
 
 std::wstring WMi18n::GetCurrentLanguageName() const
 {
-    return GetTranslationW("meta.lang.name");
+    return std::wstring{GetTranslationW("meta.lang.name")};
 }
 
 bool WMi18n::LoadDefaultLanguage()
@@ -117,31 +155,147 @@ bool WMi18n::LoadDefaultLanguage()
                    TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return false;
     }
+    PublishTexts(TranslationTable{});
     return true;
 }
 
-bool WMi18n::LoadLanguage(const std::wstring& fileName, TranslationMap& strings)
+static_assert(sizeof(wchar_t) == sizeof(char16_t),
+              "Language packs hold UTF-16 texts");
+
+// Fills `strings` with references to the texts of `pack`.
+static void ReferPackTexts(const LanguagePackView& pack,
+                           TranslationTable& strings)
 {
     WMLog& log = WMLog::GetInstance();
-    auto langFilePath = GetLanguageFilesPath();
-    if (!langFilePath) {
+    TranslationTable translations_temp;
+    for (size_t i = 0; i < pack.Size(); ++i) {
+        const std::string key{pack.GetKey(i)};
+        const auto text = pack.GetText(i);
+        if (text.empty()) {
+            log.LogInfo(L"No translation for \"{}\" found in language file",
+                        ConvertStringToWideString(key));
+            continue;
+        }
+        const TextId id = TextKey::Lookup(key);
+        if (id == TextId::Count) {
+            log.LogInfo(L"Ignoring unknown language key \"{}\"",
+                        ConvertStringToWideString(key));
+            continue;
+        }
+        // Keys are unique, the pack is sorted by them. Texts are
+        // null-terminated in the pack.
+        translations_temp.Refer(
+            id, {reinterpret_cast<const wchar_t*>(text.data()), text.size()});
+    }
+    strings = std::move(translations_temp);
+}
+
+// Maps the pack compiled from the language file at `langFilePath` and refers
+// to its texts in place. Returns false, leaving `strings` untouched, if there
+// is no pack or if it was not built from this very file, e.g. for a file
+// added or edited by the user. Called with langMutex_ held.
+bool WMi18n::ReadLanguagePack(const fs::path& langFilePath,
+                              TranslationTable& strings)
+{
+    WMLog& log = WMLog::GetInstance();
+    WIN32_FILE_ATTRIBUTE_DATA attributes{};
+    if (!GetFileAttributesExW(langFilePath.c_str(), GetFileExInfoStandard,
+                              &attributes))
+    {
         return false;
     }
-    const fs::path loadFilePath{fileName};
-    *langFilePath /= loadFilePath.filename();  // Sanitize
-    if (!fs::exists(*langFilePath)) {
-        log.LogError(L"Language module \"{}\" does not exist",
-                     langFilePath->wstring());
+    const std::uint64_t sourceSize =
+        ToUInt64(attributes.nFileSizeHigh, attributes.nFileSizeLow);
+    const std::uint64_t sourceWriteTime =
+        ToUInt64(attributes.ftLastWriteTime.dwHighDateTime,
+                 attributes.ftLastWriteTime.dwLowDateTime);
+    // Reuse a pack already checked against this very version of the file.
+    for (auto it = packs_.rbegin(); it != packs_.rend(); ++it) {
+        const MappedPack& known = **it;
+        if (known.sourcePath == langFilePath &&
+            known.sourceSize == sourceSize &&
+            known.sourceWriteTime == sourceWriteTime)
+        {
+            ReferPackTexts(known.pack, strings);
+            return true;
+        }
+    }
+
+    // Reading the JSON file to compare it is still far cheaper than parsing.
+    std::string source;
+    {
+        std::ifstream sourceFile(langFilePath, std::ios::binary);
+        if (!sourceFile) {
+            return false;
+        }
+        source.assign(std::istreambuf_iterator<char>(sourceFile),
+                      std::istreambuf_iterator<char>());
+    }
+    const auto sourceBytes = std::as_bytes(std::span{source});
+    fs::path packPath = langFilePath;
+    packPath.replace_extension(L".wmlang");
+    HANDLE hFile = CreateFileW(packPath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) {
         return false;
     }
+    auto mapped = std::make_unique<MappedPack>();
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(hFile, &size) && size.QuadPart > 0) {
+        mapped->hMapping =
+            CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    if (mapped->hMapping != nullptr) {
+        mapped->view = MapViewOfFile(mapped->hMapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    const DWORD mapError = GetLastError();
+    // The mapping keeps the file open.
+    CloseHandle(hFile);
+    if (mapped->view == nullptr) {
+        log.LogWinError(L"MapViewOfFile", mapError);
+        return false;
+    } else if (!mapped->pack.Open(
+                   {static_cast<const std::byte*>(mapped->view),
+                    static_cast<size_t>(size.QuadPart)}))
+    {
+        log.LogError(L"Language pack \"{}\" is damaged",
+                     packPath.filename().wstring());
+        return false;
+    } else if (mapped->pack.GetSourceSize() != sourceBytes.size() ||
+               mapped->pack.GetSourceHash() !=
+                   LanguagePackView::HashSource(sourceBytes))
+    {
+        log.LogInfo(L"Language pack \"{}\" is out of date, ignoring it",
+                    packPath.filename().wstring());
+        return false;
+    }
+    mapped->sourcePath = langFilePath;
+    mapped->sourceSize = sourceSize;
+    mapped->sourceWriteTime = sourceWriteTime;
+    ReferPackTexts(mapped->pack, strings);
+    packs_.push_back(std::move(mapped));
+    return true;
+}
+
+static bool ReadLanguageFile(const fs::path& langFilePath,
+                             TranslationTable& strings)
+{
+    WMLog& log = WMLog::GetInstance();
     try {
-        std::ifstream json_file(*langFilePath);
+        std::ifstream json_file(langFilePath);
         nlohmann::json json_data = nlohmann::json::parse(json_file);
-        TranslationMap translations_temp;
+        TranslationTable translations_temp;
+        // UTF-8 never takes fewer bytes than UTF-16 code units.
+        std::error_code ec;
+        const auto fileSize = fs::file_size(langFilePath, ec);
+        if (!ec) {
+            translations_temp.Reserve(static_cast<size_t>(fileSize));
+        }
         for (auto it = json_data.begin(); it != json_data.end(); ++it) {
             if (it->is_structured()) {
                 log.LogError(L"Language module \"{}\" has nested elements",
-                             langFilePath->wstring());
+                             langFilePath.wstring());
                 return false;
             }
             if (it.value() == L"") {
@@ -154,24 +308,57 @@ bool WMi18n::LoadLanguage(const std::wstring& fileName, TranslationMap& strings)
                                  ConvertStringToWideString(it.key()));
                     return false;
                 }
-                if (translations_temp.contains(it.key())) {
+                const TextId id = TextKey::Lookup(it.key());
+                if (id == TextId::Count) {
+                    log.LogInfo(L"Ignoring unknown language key \"{}\"",
+                                ConvertStringToWideString(it.key()));
+                    continue;
+                }
+                if (!translations_temp.Set(id, value)) {
                     log.LogError(L"Double entry for language key \"{}\" found.",
                                  ConvertStringToWideString(it.key()));
                     return false;
                 }
-                translations_temp[it.key()] = value;
             }
         }
         strings = std::move(translations_temp);
     } catch (const nlohmann::json::parse_error& pe) {
         log.LogError(L"Failed to parse language file \"{}\": {}",
-                     langFilePath->filename().wstring(),
+                     langFilePath.filename().wstring(),
                      ConvertStringToWideString(pe.what()));
         return false;
     }
     return true;
 }
 
+bool WMi18n::LoadLanguage(const std::wstring& fileName,
+                          TranslationTable& strings)
+{
+    WMLog& log = WMLog::GetInstance();
+    auto langFilePath = GetLanguageFilesPath();
+    if (!langFilePath) {
+        return false;
+    }
+    const fs::path loadFilePath{fileName};
+    *langFilePath /= loadFilePath.filename();  // Sanitize
+    if (!fs::exists(*langFilePath)) {
+        log.LogError(L"Language module \"{}\" does not exist",
+                     langFilePath->wstring());
+        return false;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const bool fromPack = ReadLanguagePack(*langFilePath, strings);
+    if (!fromPack && !ReadLanguageFile(*langFilePath, strings)) {
+        return false;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    log.LogInfo(L"Loaded language \"{}\" from its {} in {} us",
+                langFilePath->filename().wstring(),
+                fromPack ? L"language pack" : L"JSON file", elapsed.count());
+    return true;
+}
+
 bool WMi18n::LoadLanguage(const std::wstring& fileName)
 {
     const std::lock_guard lock(langMutex_);
@@ -180,69 +367,55 @@ bool WMi18n::LoadLanguage(const std::wstring& fileName)
         return true;
     }
 
-    TranslationMap new_lang;
+    TranslationTable new_lang;
     if (!LoadLanguage(fileName, new_lang)) {
         WMLog::GetInstance().LogError(L"Failed to load language \"{}\"",
                                       fileName);
         return false;
-    } else {
-        UnloadLanguage();
-        loadedLang_ = std::move(new_lang);
     }
+    PublishTexts(new_lang);
 
     return true;
 }
 
 void WMi18n::UnloadLanguage()
 {
-    loadedLang_.clear();
+    PublishTexts(TranslationTable{});
 }
 
-const std::wstring WMi18n::GetTranslationW(const std::string& textId) const
+void WMi18n::PublishTexts(const TranslationTable& strings)
 {
-    std::wstring text;
-    const std::lock_guard lock(langMutex_);
-    if (!loadedLang_.empty() && loadedLang_.contains(textId)) {
-        auto it = loadedLang_.find(textId);
-        if (it != loadedLang_.end() && !it->second.empty()) {
-            text = it->second;
-        }
-    }
-    if (text.empty() && defaultLang_.contains(textId)) {
-        auto it = defaultLang_.find(textId);
-        if (it != defaultLang_.cend() && !it->second.empty()) {
-            text = it->second;
-        }
-    }
-    if (text.empty()) {
-        std::wstring err = std::format(L"Translation for {} not found",
-                                       ConvertStringToWideString(textId));
-        return err;
-    }
-    return text;
+    texts_.Publish(ResolveTranslations(
+        strings, defaultLang_, [](std::string_view key) {
+            return std::format(L"Translation for {} not found",
+                               ConvertStringToWideString(std::string{key}));
+        }));
+}
+
+std::wstring_view WMi18n::GetTranslationW(TextKey textId) const
+{
+    return texts_.Get(textId.GetId());
 }
 
-const std::string WMi18n::GetTranslationA(const std::string& textId) const
+const std::string WMi18n::GetTranslationA(TextKey textId) const
 {
-    const std::wstring wtext = GetTranslationW(textId);
-    return ConvertWideStringToString(wtext);
+    return ConvertWideStringToString(std::wstring{GetTranslationW(textId)});
 }
 
-bool WMi18n::SetItemText(HWND hWnd, int dlgItem,
-                         const std::string& textId) const
+bool WMi18n::SetItemText(HWND hWnd, int dlgItem, TextKey textId) const
 {
     const auto text = GetTranslationW(textId);
-    if (!SetDlgItemTextW(hWnd, dlgItem, text.c_str())) {
+    if (!SetDlgItemTextW(hWnd, dlgItem, text.data())) {
         WMLog::GetInstance().LogWinError(L"SetDlgItemTextW", GetLastError());
         return false;
     }
     return true;
 }
 
-bool WMi18n::SetItemText(HWND hItem, const std::string& textId) const
+bool WMi18n::SetItemText(HWND hItem, TextKey textId) const
 {
     const auto text = GetTranslationW(textId);
-    if (!SetWindowTextW(hItem, text.c_str())) {
+    if (!SetWindowTextW(hItem, text.data())) {
         WMLog::GetInstance().LogWinError(L"SetDlgItemTextW", GetLastError());
         return false;
     }
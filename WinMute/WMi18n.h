@@ -40,8 +40,6 @@ struct LanguageModule {
     std::wstring fileName;
 };
 
-using TranslationMap = std::map<std::string, std::wstring>;
-
 class WMi18n {
    public:
     static WMi18n& GetInstance();
@@ -54,11 +52,13 @@ class WMi18n {
     std::optional<fs::path> GetLanguageFilesPath() const;
     std::wstring GetCurrentLanguageName() const;
 
-    const std::wstring GetTranslationW(const std::string& textId) const;
-    const std::string GetTranslationA(const std::string& textId) const;
+    // Does not lock. The text is null-terminated and stays valid until WMi18n
+    // is destroyed, even across language switches.
+    std::wstring_view GetTranslationW(TextKey textId) const;
+    const std::string GetTranslationA(TextKey textId) const;
 
-    bool SetItemText(HWND hWnd, int dlgItem, const std::string& textId) const;
-    bool SetItemText(HWND hItem, const std::string& textId) const;
+    bool SetItemText(HWND hWnd, int dlgItem, TextKey textId) const;
+    bool SetItemText(HWND hItem, TextKey textId) const;
 
    private:
     WMi18n() noexcept;
@@ -66,13 +66,51 @@ class WMi18n {
     WMi18n(const WMi18n&) = delete;
     WMi18n& operator=(const WMi18n&) = delete;
 
-    mutable std::mutex langMutex_;
+    // Serializes loading languages. Lookups do not take it.
+    std::mutex langMutex_;
     const std::wstring defaultLangName_ = L"lang-en.json";
     std::wstring curModuleName_;
-    TranslationMap loadedLang_;
-    TranslationMap defaultLang_;
+    TranslationTable defaultLang_;
+    // The texts handed out: those of the loaded language, with the gaps
+    // filled from the default language. Published under langMutex_.
+    PublishedTranslations texts_;
+
+    // What GetAvailableLanguages found in a language file, valid as long as
+    // the file keeps its size and last write time.
+    struct ScannedLanguage {
+        std::uint64_t size = 0;
+        std::uint64_t writeTime = 0;
+        // Empty if the file has no name, i.e. is no language file.
+        std::wstring langName;
+    };
+    mutable std::mutex scanMutex_;
+    mutable std::map<std::wstring, ScannedLanguage> scannedLanguages_;
+
+    // A language pack mapped into memory, along with the size and last write
+    // time its JSON file had when the pack was found to match it. Tables
+    // refer to the texts in the mapping, so it is kept until shutdown; a
+    // language loaded again while its JSON file is unchanged reuses it
+    // without reading and hashing the file again.
+    struct MappedPack {
+        MappedPack() = default;
+        MappedPack(const MappedPack&) = delete;
+        MappedPack& operator=(const MappedPack&) = delete;
+        ~MappedPack();
+
+        fs::path sourcePath;
+        std::uint64_t sourceSize = 0;
+        std::uint64_t sourceWriteTime = 0;
+        HANDLE hMapping = nullptr;
+        const void* view = nullptr;
+        LanguagePackView pack;
+    };
+    // Guarded by langMutex_.
+    std::vector<std::unique_ptr<MappedPack>> packs_;
 
     void UnloadLanguage();
     bool LoadDefaultLanguage();
-    bool LoadLanguage(const std::wstring& fileName, TranslationMap& strings);
+    bool LoadLanguage(const std::wstring& fileName, TranslationTable& strings);
+    bool ReadLanguagePack(const fs::path& langFilePath,
+                          TranslationTable& strings);
+    void PublishTexts(const TranslationTable& strings);
 };
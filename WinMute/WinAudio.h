@@ -41,11 +41,15 @@ class WinAudio {
    public:
     virtual bool Init(HWND hParent) = 0;
     virtual void ShouldReInit() = 0;
+    // Completes a pending re-init now, so the next mute does not pay for it.
+    virtual bool WarmUp() = 0;
     virtual void OnAudioServiceShutdown() = 0;
     virtual void OnDeviceArrived() = 0;
     virtual bool AllEndpointsMuted() = 0;
-    virtual bool SaveMuteStatus() = 0;
-    virtual bool RestoreMuteStatus() = 0;
+    // Returns the generation identifying this save (0 if nothing could be
+    // saved). Only the latest save can be restored.
+    virtual std::uint32_t SaveMuteStatus() = 0;
+    virtual bool RestoreMuteStatus(std::uint32_t generation) = 0;
     virtual void RestoreArrivedEndpoints() = 0;
     virtual void SetMute(bool mute) = 0;
     virtual void MuteSpecificEndpoints(bool muteSpecific) = 0;
@@ -60,6 +64,8 @@ struct Endpoint {
     // guaranteed to survive a driver update.
     std::wstring deviceId;
     std::wstring deviceName;
+    // Index into VistaAudio::endpointStates_, resolved once per (re-)init.
+    std::size_t stateSlot = 0;
     CComPtr<IAudioEndpointVolume> endpointVolume;
     CComPtr<IAudioSessionControl> sessionCtrl;
     // VistaAudioSessionEvents is a ref-counted COM object; holding it in a
@@ -80,11 +86,12 @@ class VistaAudio : public WinAudio {
 
     bool Init(HWND hParent) override;
     void ShouldReInit() override;
+    bool WarmUp() override;
     void OnAudioServiceShutdown() override;
     void OnDeviceArrived() override;
     bool AllEndpointsMuted() override;
-    bool SaveMuteStatus() override;
-    bool RestoreMuteStatus() override;
+    std::uint32_t SaveMuteStatus() override;
+    bool RestoreMuteStatus(std::uint32_t generation) override;
     void RestoreArrivedEndpoints() override;
     void SetMute(bool mute) override;
 
@@ -99,6 +106,7 @@ class VistaAudio : public WinAudio {
     bool LoadAllEndpoints();
     bool IsEndpointManaged(const Endpoint& ep) const;
     bool RestoreEndpoint(const Endpoint& ep, bool wasMuted);
+    std::size_t GetStateSlot(const std::wstring& deviceId);
 
     std::vector<std::unique_ptr<Endpoint>> endpoints_;
     CComPtr<MMNotificationClient> mmnAudioEvents_;
@@ -107,11 +115,27 @@ class VistaAudio : public WinAudio {
     // Saved mute state lives here, not on Endpoint: the endpoint objects are
     // torn down and rebuilt on every re-init, which would otherwise discard
     // the state saved just before a mute event (or between save and mute).
-    std::map<std::wstring, bool> savedMuteState_;
+    // Slots are only ever appended, one per device id seen, so a mute cycle
+    // just rewrites them in place. An entry is valid for the current cycle if
+    // it carries the current stamp; starting a new cycle is a counter bump.
+    struct EndpointState {
+        std::wstring deviceId;
+        bool wasMuted = false;
+        // saveGeneration_ of the save that recorded wasMuted.
+        std::uint32_t savedIn = 0;
+        // restorePass_ that found the device absent and is still waiting.
+        std::uint32_t pendingIn = 0;
+        // restorePass_ that found the device present.
+        std::uint32_t seenIn = 0;
+    };
+    std::vector<EndpointState> endpointStates_;
+    // 0 means nothing has been saved yet.
+    std::uint32_t saveGeneration_ = 0;
+    std::uint32_t restorePass_ = 0;
 
     // Endpoints that were saved but absent when the restore came in, plus the
     // deadline until which their late arrival still triggers a restore.
-    std::set<std::wstring> pendingRestoreIds_;
+    std::size_t pendingRestoreCount_ = 0;
     std::chrono::steady_clock::time_point restoreDeadline_{};
 
     std::atomic<bool> reInit_;
@@ -110,8 +110,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ PWSTR,
     }
     if (!settings.Init()) {
         TaskDialog(nullptr, nullptr, PROGRAM_NAME,
-                   i18n.GetTranslationW("init.error.settings.title").c_str(),
-                   i18n.GetTranslationW("init.error.settings.text").c_str(),
+                   i18n.GetTranslationW("init.error.settings.title").data(),
+                   i18n.GetTranslationW("init.error.settings.text").data(),
                    TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return FALSE;
     }
@@ -126,8 +126,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ PWSTR,
         CloseHandle(hMutex);
         TaskDialog(
             nullptr, nullptr, PROGRAM_NAME,
-            i18n.GetTranslationW("init.error.already-running.title").c_str(),
-            i18n.GetTranslationW("init.error.already-running.text").c_str(),
+            i18n.GetTranslationW("init.error.already-running.title").data(),
+            i18n.GetTranslationW("init.error.already-running.text").data(),
             TDCBF_OK_BUTTON, TD_INFORMATION_ICON, nullptr);
         return FALSE;
     }
@@ -138,8 +138,8 @@ int WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE, _In_ PWSTR,
 
     if (!InitWindowsComponents()) {
         TaskDialog(nullptr, nullptr, PROGRAM_NAME,
-                   i18n.GetTranslationW("init.error.winmute.title").c_str(),
-                   i18n.GetTranslationW("init.error.winmute.text").c_str(),
+                   i18n.GetTranslationW("init.error.winmute.title").data(),
+                   i18n.GetTranslationW("init.error.winmute.text").data(),
                    TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         ReleaseMutex(hMutex);
         CloseHandle(hMutex);
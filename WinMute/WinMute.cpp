@@ -46,16 +46,69 @@ static const wchar_t* TERMINAL_SERVER_KEY =
     L"SYSTEM\\CurrentControlSet\\Control\\Terminal Server\\";
 static const wchar_t* GLASS_SESSION_ID = L"GlassSessionId";
 
-static constexpr UINT_PTR WTS_RETRY_TIMER_ID = 190503;
 // When WinMute is started from autostart, the services Remote Desktop
 // Services depends on can still be coming up, which makes
 // WTSRegisterSessionNotification fail with RPC_S_INVALID_BINDING. Retry for
 // roughly half a minute before giving up.
-static constexpr UINT WTS_RETRY_INTERVAL_MS = 1000;
+static constexpr auto WTS_RETRY_INTERVAL = std::chrono::milliseconds(1000);
 static constexpr int WTS_RETRY_MAX_ATTEMPTS = 30;
 
 static constexpr int GLOBAL_HOTKEY_ID_MUTE = 1000;
 
+struct TriggerSourceInfo {
+    const wchar_t* name;
+    EventNormalizer::Rule rule;
+};
+
+// Indexed by TriggerSource. Every source drops repeated states: console and
+// session display notifications, for instance, both fire for the same
+// transition.
+static const TriggerSourceInfo TRIGGER_SOURCES[] = {
+    // Registering reports the current state right away. That initial "on"
+    // ends nothing and is ignored by MuteControl; dimming has to get through
+    // from the start.
+    {L"Display", {}},
+    // The lid-switch registration also reports the current state immediately.
+    // Ignore "closed" until the lid was open once, so a laptop started docked
+    // with its lid closed is not muted on launch.
+    {L"Lid", {.armedBy = 1}},
+    {L"Session Lock", {}},
+    {L"Remote Session", {}},
+    // A flaky headset can disconnect and reconnect several times a second.
+    // The first change still passes immediately.
+    {L"Bluetooth", {.debounce = std::chrono::seconds(1)}},
+    {L"WLAN", {}},
+};
+static_assert(ARRAY_SIZE(TRIGGER_SOURCES) ==
+              static_cast<size_t>(TriggerSource::Count));
+
+static std::vector<EventNormalizer::Rule> GetTriggerRules()
+{
+    std::vector<EventNormalizer::Rule> rules;
+    for (const auto& source : TRIGGER_SOURCES) {
+        rules.push_back(source.rule);
+    }
+    return rules;
+}
+
+static const wchar_t* VerdictToString(EventNormalizer::Verdict verdict)
+{
+    switch (verdict) {
+        case EventNormalizer::Verdict::Passed:
+            return L"passed";
+        case EventNormalizer::Verdict::Held:
+            return L"held back";
+        case EventNormalizer::Verdict::Duplicate:
+            return L"duplicate";
+        case EventNormalizer::Verdict::Unarmed:
+            return L"initial state";
+        case EventNormalizer::Verdict::OutOfOrder:
+            return L"out of order";
+        default:
+            return L"unknown";
+    }
+}
+
 extern void ShowLogDialog(HWND hParent);
 
 static LRESULT CALLBACK WinMuteWndProc(HWND hWnd, UINT msg, WPARAM wParam,
@@ -76,15 +129,6 @@ static LRESULT CALLBACK WinMuteWndProc(HWND hWnd, UINT msg, WPARAM wParam,
                 : DefWindowProcW(hWnd, msg, wParam, lParam);
 }
 
-static void CALLBACK WtsRetryTimerProc(HWND hWnd, UINT, UINT_PTR, DWORD)
-{
-    auto wm =
-        reinterpret_cast<WinMute*>(GetWindowLongPtrW(hWnd, GWLP_USERDATA));
-    if (wm != nullptr) {
-        wm->RetrySessionNotification();
-    }
-}
-
 static bool IsCurrentSessionRemoteable() noexcept
 {
     bool isRemoteable = false;
@@ -135,7 +179,11 @@ WinMute::WinMute(WMSettings& settings)
       hTrayIcon_(nullptr),
       hUpdateIcon_(nullptr),
       settings_(settings),
-      i18n_(WMi18n::GetInstance())
+      i18n_(WMi18n::GetInstance()),
+      triggerFilter_(GetTriggerRules(),
+                     [this](const EventNormalizer::Event& event) {
+                         OnTrigger(event);
+                     })
 {
 }
 
@@ -182,14 +230,14 @@ bool WinMute::InitAudio()
         TaskDialog(
             nullptr, nullptr, PROGRAM_NAME,
             i18n_.GetTranslationW("init.error.winmute.platform-support.title")
-                .c_str(),
+                .data(),
             i18n_.GetTranslationW("init.error.winmute.platform-support.text")
-                .c_str(),
+                .data(),
             TDCBF_OK_BUTTON, TD_ERROR_ICON, nullptr);
         return false;
     }
 
-    if (!muteCtrl_.Init(hWnd_, &wmTray_)) {
+    if (!muteCtrl_.Init(hWnd_, &wmTray_, &scheduler_)) {
         return false;
     }
 
@@ -238,39 +286,41 @@ bool WinMute::TryRegisterSessionNotification()
     return true;
 }
 
+bool WinMute::ScheduleSessionNotificationRetry()
+{
+    wtsRetryTimer_ = scheduler_.Schedule(WTS_RETRY_INTERVAL,
+                                         [this] { RetrySessionNotification(); });
+    return wtsRetryTimer_ != 0;
+}
+
 void WinMute::StartSessionNotificationRetry()
 {
     WMLog& log = WMLog::GetInstance();
 
-    if (wtsRetryTimerId_ != 0) {
+    if (scheduler_.IsPending(wtsRetryTimer_)) {
         return;
     }
-    if (SetTimer(hWnd_, WTS_RETRY_TIMER_ID, WTS_RETRY_INTERVAL_MS,
-                 WtsRetryTimerProc) == 0)
-    {
-        log.LogWinError(L"SetTimer (session notification retry)",
-                        GetLastError());
+    if (!ScheduleSessionNotificationRetry()) {
+        log.LogError(L"Failed to schedule session notification retry");
         log.LogError(L"Muting on workstation lock is not available");
         return;
     }
-    wtsRetryTimerId_ = WTS_RETRY_TIMER_ID;
     wtsRetryAttempts_ = 0;
     log.LogInfo(L"Retrying to register for session notifications every {} ms",
-                WTS_RETRY_INTERVAL_MS);
+                WTS_RETRY_INTERVAL.count());
 }
 
 void WinMute::StopSessionNotificationRetry() noexcept
 {
-    if (wtsRetryTimerId_ != 0) {
-        KillTimer(hWnd_, wtsRetryTimerId_);
-        wtsRetryTimerId_ = 0;
-    }
+    scheduler_.Cancel(wtsRetryTimer_);
+    wtsRetryTimer_ = 0;
 }
 
 void WinMute::RetrySessionNotification()
 {
     WMLog& log = WMLog::GetInstance();
 
+    wtsRetryTimer_ = 0;
     ++wtsRetryAttempts_;
     if (TryRegisterSessionNotification()) {
         StopSessionNotificationRetry();
@@ -288,6 +338,8 @@ void WinMute::RetrySessionNotification()
         wmTray_.ShowPopup(
             i18n_.GetTranslationW("popup.session-notification-failed.title"),
             i18n_.GetTranslationW("popup.session-notification-failed.text"));
+    } else if (!ScheduleSessionNotificationRetry()) {
+        log.LogError(L"Failed to schedule session notification retry");
     }
 }
 
@@ -297,11 +349,25 @@ bool WinMute::Init()
 
     hAppIcon_ = LoadIconW(hglobInstance, MAKEINTRESOURCE(IDI_APP));
 
+    log.SetLogFileLimits(
+        std::max<std::uint64_t>(
+            settings_.QueryValue(SettingsKey::LOG_MAX_FILE_SIZE_KB), 16) *
+            1024,
+        std::chrono::hours(std::max<DWORD>(
+            settings_.QueryValue(SettingsKey::LOG_MAX_FILE_AGE_HOURS), 1)),
+        std::clamp<DWORD>(settings_.QueryValue(SettingsKey::LOG_RETAINED_FILES),
+                          1, 20));
+    log.EnableJsonLog(settings_.QueryValue(SettingsKey::LOG_JSON_ENABLED) !=
+                      0);
 #ifdef _DEBUG
     WMLog::GetInstance().EnableLogFile(true);
+    log.SetMinimumLevel(LogLevel::Debug);
 #else
     WMLog::GetInstance().EnableLogFile(
         settings_.QueryValue(SettingsKey::LOGGING_ENABLED));
+    log.SetMinimumLevel(static_cast<LogLevel>(
+        std::min(settings_.QueryValue(SettingsKey::LOG_LEVEL),
+                 static_cast<DWORD>(LogLevel::Error))));
 #endif
     log.LogInfo(L"Starting new session...");
 
@@ -309,6 +375,10 @@ bool WinMute::Init()
         return false;
     }
 
+    if (!scheduler_.Init()) {
+        return false;
+    }
+
     if (!InitAudio()) {
         return false;
     }
@@ -379,7 +449,7 @@ bool WinMute::Init()
     updateTray_.Init(hWnd_, 1, hUpdateIcon_, L"WinMute Update", false,
                      WM_WINMUTE_UPDATE_POPUP);
 
-    quietHours_.Init(hWnd_, settings_);
+    quietHours_.Init(hWnd_, scheduler_, settings_);
 
     log.LogInfo(L"WinMute initialized");
 
@@ -440,6 +510,8 @@ bool WinMute::LoadSettings()
         settings_.QueryValue(SettingsKey::RESTORE_AUDIO) ? L"Yes" : L"No");
     log.LogInfo(L"\tMute delay: {}",
                 settings_.QueryValue(SettingsKey::MUTE_DELAY));
+    log.LogInfo(L"\tMute grace period: {} ms",
+                settings_.QueryValue(SettingsKey::MUTE_GRACE_PERIOD));
     log.LogInfo(
         L"\tMute on lock: {}",
         settings_.QueryValue(SettingsKey::MUTE_ON_LOCK) ? L"Yes" : L"No");
@@ -503,6 +575,8 @@ bool WinMute::LoadSettings()
         muteCtrl_.SetManagedEndpoints(endpoints, isAllowList);
     }
     muteCtrl_.SetMuteDelay(settings_.QueryValue(SettingsKey::MUTE_DELAY));
+    muteCtrl_.SetMuteGracePeriod(std::chrono::milliseconds(
+        settings_.QueryValue(SettingsKey::MUTE_GRACE_PERIOD)));
     muteCtrl_.SetRestoreVolume(
         settings_.QueryValue(SettingsKey::RESTORE_AUDIO));
     muteCtrl_.SetMuteOnWorkstationLock(
@@ -517,6 +591,7 @@ bool WinMute::LoadSettings()
         settings_.QueryValue(SettingsKey::MUTE_ON_SUSPEND));
     muteCtrl_.SetMuteOnShutdown(
         settings_.QueryValue(SettingsKey::MUTE_ON_SHUTDOWN));
+    const ConditionSet ruleConditions = LoadMuteRules();
     muteCtrl_.SetMuteTryPauseMedia(
         settings_.QueryValue(SettingsKey::MUTE_TRY_PAUSE_MEDIA));
     muteCtrl_.SetMuteTryResumeMedia(
@@ -549,21 +624,34 @@ bool WinMute::LoadSettings()
     }
 
     muteConfig_.muteOnWlan = settings_.QueryValue(SettingsKey::MUTE_ON_WLAN);
-    if (!muteConfig_.muteOnWlan) {
+    muteCtrl_.SetMuteOnWlan(muteConfig_.muteOnWlan);
+    // Mute rules can look at the WLAN without muting on connect.
+    const bool rulesUseWlan =
+        (ruleConditions & ConditionBit(MuteCondition::WlanConnected)) != 0;
+    std::optional<WlanConfig> wlanConfig;
+    if (!muteConfig_.muteOnWlan && !rulesUseWlan) {
         wifiDetector_.Unload();
+    } else if (wifiDetector_.Init(hWnd_)) {
+        wlanConfig = WlanConfig{
+            settings_.GetWifiNetworks(),
+            !settings_.QueryValue(SettingsKey::MUTE_ON_WLAN_ALLOWLIST),
+            muteConfig_.muteOnWlan};
+    } else if (muteConfig_.muteOnWlan) {
+        wmTray_.ShowPopup(
+            i18n_.GetTranslationW("popup.wlan-muting-disabled.title"),
+            i18n_.GetTranslationW("popup.wlan-muting-disabled.text"));
+        settings_.SetValue(SettingsKey::MUTE_ON_WLAN, FALSE);
     } else {
-        if (!wifiDetector_.Init(hWnd_)) {
-            wmTray_.ShowPopup(
-                i18n_.GetTranslationW("popup.wlan-muting-disabled.title"),
-                i18n_.GetTranslationW("popup.wlan-muting-disabled.text"));
-            settings_.SetValue(SettingsKey::MUTE_ON_WLAN, FALSE);
-        } else {
-            const bool isMuteList =
-                !settings_.QueryValue(SettingsKey::MUTE_ON_WLAN_ALLOWLIST);
-            wifiDetector_.SetNetworkList(settings_.GetWifiNetworks(),
-                                         isMuteList);
-            wifiDetector_.CheckNetwork();
-        }
+        log.LogError(L"WLAN unavailable, \"wlan\" in mute rules never holds");
+    }
+    if (wlanConfig != wlanConfig_) {
+        ResetWlanState();
+        wlanConfig_ = wlanConfig;
+    }
+    if (wlanConfig_) {
+        wifiDetector_.SetNetworkList(wlanConfig_->networks,
+                                     wlanConfig_->isMuteList);
+        wifiDetector_.CheckNetwork();
     }
 
     LoadGlobalHotkeys();
@@ -571,6 +659,26 @@ bool WinMute::LoadSettings()
     return true;
 }
 
+ConditionSet WinMute::LoadMuteRules()
+{
+    WMLog& log = WMLog::GetInstance();
+    const auto ruleText =
+        settings_.QueryStrValue(SettingsKey::MUTE_RULES).value_or(L"");
+    std::wstring error;
+    auto rules = MuteRuleSet::Compile(ruleText, error);
+    if (!rules) {
+        log.LogError(L"Ignoring mute rules: {}", error);
+        muteCtrl_.SetMuteRules(MuteRuleSet());
+        return 0;
+    }
+    for (const auto& rule : rules->GetRules()) {
+        log.LogInfo(L"\tMute rule: {}", MuteRuleSet::ToString(rule));
+    }
+    const ConditionSet used = rules->GetUsedConditions();
+    muteCtrl_.SetMuteRules(std::move(*rules));
+    return used;
+}
+
 void WinMute::ToggleMenuCheck(UINT item, bool* setting) noexcept
 {
     UINT state = GetMenuState(hTrayMenu_, item, MF_BYCOMMAND);
@@ -886,15 +994,110 @@ LRESULT WinMute::OnUpdatePopup(HWND hWnd, WPARAM, LPARAM lParam)
     return 0;
 }
 
+EventNormalizer::Verdict WinMute::SubmitTrigger(
+    TriggerSource source, int state, EventNormalizer::TimePoint received)
+{
+    const auto verdict = triggerFilter_.Submit(static_cast<size_t>(source),
+                                               state, received);
+    if (verdict != EventNormalizer::Verdict::Passed) {
+        WMLog::GetInstance().LogDebug(
+            L"{} event (state {}) {}",
+            TRIGGER_SOURCES[static_cast<size_t>(source)].name, state,
+            VerdictToString(verdict));
+    }
+    ArmTriggerFilterTimer();
+    return verdict;
+}
+
+void WinMute::ArmTriggerFilterTimer()
+{
+    scheduler_.Cancel(triggerFilterTimer_);
+    triggerFilterTimer_ = 0;
+    const auto due = triggerFilter_.NextDeadline();
+    if (!due) {
+        return;
+    }
+    const auto delay = std::chrono::ceil<std::chrono::milliseconds>(
+        *due - EventNormalizer::Clock::now());
+    triggerFilterTimer_ = scheduler_.Schedule(
+        std::max(delay, std::chrono::milliseconds(0)), [this] {
+            triggerFilterTimer_ = 0;
+            triggerFilter_.Poll(EventNormalizer::Clock::now());
+            ArmTriggerFilterTimer();
+        });
+}
+
+void WinMute::ResetWlanState()
+{
+    // The detector only reports the networks its list applies to. Once it is
+    // unloaded, or a network drops out of the list, the disconnect is never
+    // reported: forget the connection, or the next connect would be dropped
+    // as a repeat.
+    triggerFilter_.Reset(static_cast<size_t>(TriggerSource::Wlan));
+    ArmTriggerFilterTimer();
+    muteCtrl_.NotifyWlanConnected(false, EventNormalizer::Clock::now());
+}
+
+void WinMute::OnTrigger(const EventNormalizer::Event& event)
+{
+    const bool active = (event.state == 1);
+    switch (static_cast<TriggerSource>(event.source)) {
+        case TriggerSource::Display:
+            if (event.state == 0x0) {  // Display standby
+                muteCtrl_.NotifyDisplayStandby(true, event.received);
+            } else if (event.state == 0x1) {  // Display on
+                muteCtrl_.NotifyDisplayDimmed(false);
+                muteCtrl_.NotifyDisplayStandby(false, event.received);
+            } else if (event.state == 0x2) {  // Display dimmed
+                muteCtrl_.NotifyDisplayDimmed(true);
+            }
+            break;
+        case TriggerSource::Lid:
+            muteCtrl_.NotifyLidClosed(event.state == 0x0, event.received);
+            break;
+        case TriggerSource::SessionLock:
+            muteCtrl_.NotifyWorkstationLock(active, event.received);
+            break;
+        case TriggerSource::RemoteSession:
+            muteCtrl_.NotifyRemoteSession(active, event.received);
+            break;
+        case TriggerSource::Bluetooth:
+            muteCtrl_.NotifyBluetoothConnected(active, event.received);
+            break;
+        case TriggerSource::Wlan:
+            muteCtrl_.NotifyWlanConnected(active, event.received);
+            break;
+        default:
+            break;
+    }
+}
+
+void WinMute::LogTriggerFilterCounters()
+{
+    WMLog& log = WMLog::GetInstance();
+    for (size_t i = 0; i < triggerFilter_.SourceCount(); ++i) {
+        const auto& counters = triggerFilter_.GetCounters(i);
+        if (counters.Dropped() == 0) {
+            continue;
+        }
+        log.LogInfo(
+            L"{} events: {} passed, {} duplicates, {} initial, {} out of "
+            L"order, {} coalesced",
+            TRIGGER_SOURCES[i].name, counters.passed, counters.duplicates,
+            counters.unarmed, counters.outOfOrder, counters.coalesced);
+    }
+}
+
 LRESULT WinMute::OnSettingChange(HWND, WPARAM, LPARAM)
 {
     return 0;
 }
 
-LRESULT WinMute::OnPowerBroadcast(HWND, WPARAM wParam, LPARAM lParam)
+LRESULT WinMute::OnPowerBroadcast(HWND, WPARAM wParam, LPARAM lParam,
+                                  MuteLatencyStats::TimePoint received)
 {
     if (wParam == PBT_APMSUSPEND) {
-        muteCtrl_.NotifySuspend(true);
+        muteCtrl_.NotifySuspend(true, received);
     } else if (wParam == PBT_POWERSETTINGCHANGE) {
         const PPOWERBROADCAST_SETTING bs =
             reinterpret_cast<PPOWERBROADCAST_SETTING>(lParam);
@@ -907,33 +1110,24 @@ LRESULT WinMute::OnPowerBroadcast(HWND, WPARAM wParam, LPARAM lParam)
             WMLog::GetInstance().LogDebug(
                 L"Power event: {} display state {}",
                 isSession ? L"session" : L"console", state);
-            // Both notifications describe the same display, so ignore the
-            // duplicate that arrives for the second registration.
-            if (state != lastDisplayState_) {
-                lastDisplayState_ = state;
-                if (state == 0x0) {  // Display standby
-                    muteCtrl_.NotifyDisplayStandby(true);
-                } else if (state == 0x1) {  // Display on
-                    muteCtrl_.NotifyDisplayStandby(false);
-                } else if (state == 0x2) {  // Display dimmed
-                }
-            }
+            SubmitTrigger(TriggerSource::Display, static_cast<int>(state),
+                          received);
         } else if (IsEqualGUID(bs->PowerSetting, GUID_LIDSWITCH_STATE_CHANGE)) {
             const DWORD state = bs->Data[0];
-            if (state == 0x0) {  // Lid closed
-                muteCtrl_.NotifyLidClosed(true);
-            } else if (state == 0x1) {  // Lid open
-                muteCtrl_.NotifyLidClosed(false);
+            if (state == 0x0 || state == 0x1) {  // Lid closed / open
+                SubmitTrigger(TriggerSource::Lid, static_cast<int>(state),
+                              received);
             }
         }
     }
     return TRUE;
 }
 
-LRESULT WinMute::OnQuietHours(HWND, UINT msg, WPARAM, LPARAM)
+LRESULT WinMute::OnQuietHours(HWND, UINT msg, WPARAM, LPARAM,
+                              MuteLatencyStats::TimePoint received)
 {
     if (msg == WM_WINMUTE_QUIETHOURS_START) {
-        muteCtrl_.NotifyQuietHours(true);
+        muteCtrl_.NotifyQuietHours(true, received);
         if (settings_.QueryValue(SettingsKey::QUIETHOURS_NOTIFICATIONS)) {
             wmTray_.ShowPopup(
                 i18n_.GetTranslationW("popup.quiet-hours-started.title"),
@@ -942,15 +1136,14 @@ LRESULT WinMute::OnQuietHours(HWND, UINT msg, WPARAM, LPARAM)
         quietHours_.SetEnd();
         return 0;
     } else if (msg == WM_WINMUTE_QUIETHOURS_END) {
-        muteCtrl_.NotifyQuietHours(false);
+        muteCtrl_.NotifyQuietHours(
+            false, received,
+            settings_.QueryValue(SettingsKey::QUIETHOURS_FORCEUNMUTE) != 0);
         if (settings_.QueryValue(SettingsKey::QUIETHOURS_NOTIFICATIONS)) {
             wmTray_.ShowPopup(
                 i18n_.GetTranslationW("popup.quiet-hours-ended.title"),
                 i18n_.GetTranslationW("popup.quiet-hours-ended.text"));
         }
-        if (settings_.QueryValue(SettingsKey::QUIETHOURS_FORCEUNMUTE)) {
-            muteCtrl_.SetMute(false);
-        }
         quietHours_.SetStart();
     }
     return 0;
@@ -961,35 +1154,40 @@ LRESULT WinMute::OnAudioServiceShutdown(HWND hWnd, WPARAM, LPARAM)
     TaskDialog(
         hWnd, hglobInstance, PROGRAM_NAME,
         i18n_.GetTranslationW("general.error.audio-service-shutdown.title")
-            .c_str(),
+            .data(),
         i18n_.GetTranslationW("general.error.audio-service-shutdown.text")
-            .c_str(),
+            .data(),
         TDCBF_OK_BUTTON, TD_WARNING_ICON, nullptr);
     return 0;
 }
 
-LRESULT WinMute::OnDeviceChange(HWND, UINT msg, WPARAM wParam, LPARAM lParam)
+LRESULT WinMute::OnDeviceChange(HWND, UINT msg, WPARAM wParam, LPARAM lParam,
+                                MuteLatencyStats::TimePoint received)
 {
     if (muteConfig_.muteOnBluetooth) {
         const auto btStatus =
             btDetector_.GetBluetoothStatus(msg, wParam, lParam);
         if (btStatus == BluetoothDetector::BluetoothStatus::Connected) {
-            muteCtrl_.NotifyBluetoothConnected(true);
+            SubmitTrigger(TriggerSource::Bluetooth, 1, received);
         } else if (btStatus == BluetoothDetector::BluetoothStatus::Disconnected)
         {
-            muteCtrl_.NotifyBluetoothConnected(false);
+            SubmitTrigger(TriggerSource::Bluetooth, 0, received);
         }
     }
     return TRUE;
 }
 
-LRESULT WinMute::OnWifiStatusChange(HWND, WPARAM wParam, LPARAM lParam)
+LRESULT WinMute::OnWifiStatusChange(HWND, WPARAM wParam, LPARAM lParam,
+                                    MuteLatencyStats::TimePoint received)
 {
-    if (!muteConfig_.muteOnWlan) {
-        return 0;
-    }
-    if (wParam != 1) {  // Not Connected
-        return 0;
+    // Always passed on: mute rules track the connection even when connecting
+    // does not mute.
+    const auto verdict =
+        SubmitTrigger(TriggerSource::Wlan, (wParam == 1) ? 1 : 0, received);
+    if (!muteConfig_.muteOnWlan || wParam != 1 ||
+        verdict != EventNormalizer::Verdict::Passed)
+    {
+        return 0;  // Not muting, or already muted for this connection
     }
 
     if (settings_.QueryValue(SettingsKey::NOTIFICATIONS_ENABLED)) {
@@ -1008,7 +1206,6 @@ LRESULT WinMute::OnWifiStatusChange(HWND, WPARAM wParam, LPARAM lParam)
         wmTray_.ShowPopup(
             i18n_.GetTranslationW("popup.workstation-muted.title"), popupMsg);
     }
-    muteCtrl_.SetMute(true);
 
     return 0;
 }
@@ -1017,6 +1214,9 @@ LRESULT CALLBACK WinMute::WindowProc(HWND hWnd, UINT msg, WPARAM wParam,
                                      LPARAM lParam)
 {
     static UINT uTaskbarRestart = 0;
+    // Taken before anything else, so mute latency covers the whole handling
+    // of the triggering message.
+    const auto received = MuteLatencyStats::Clock::now();
     switch (msg) {
         case WM_CREATE:
             uTaskbarRestart = RegisterWindowMessageW(L"TaskbarCreated");
@@ -1035,41 +1235,48 @@ LRESULT CALLBACK WinMute::WindowProc(HWND hWnd, UINT msg, WPARAM wParam,
         }
         case WM_WTSSESSION_CHANGE: {
             if (wParam == WTS_SESSION_LOCK) {
-                muteCtrl_.NotifyWorkstationLock(true);
+                SubmitTrigger(TriggerSource::SessionLock, 1, received);
             } else if (wParam == WTS_SESSION_UNLOCK) {
-                muteCtrl_.NotifyWorkstationLock(false);
+                SubmitTrigger(TriggerSource::SessionLock, 0, received);
+            } else if (wParam == WTS_REMOTE_CONNECT) {
+                SubmitTrigger(TriggerSource::RemoteSession, 1, received);
+            } else if (wParam == WTS_REMOTE_DISCONNECT) {
+                SubmitTrigger(TriggerSource::RemoteSession, 0, received);
             }
             return 0;
         }
         case WM_POWERBROADCAST:
-            return OnPowerBroadcast(hWnd, wParam, lParam);
+            return OnPowerBroadcast(hWnd, wParam, lParam, received);
         case WM_QUERYENDSESSION:
             return TRUE;
         case WM_ENDSESSION:
             if (wParam == TRUE) {
                 if (lParam == 0) {  // Shutdown
-                    muteCtrl_.NotifyShutdown();
+                    muteCtrl_.NotifyShutdown(received);
                 } else if ((lParam & ENDSESSION_LOGOFF)) {
-                    muteCtrl_.NotifyLogout();
+                    muteCtrl_.NotifyLogout(received);
                 }
             }
             break;
         case WM_WINMUTE_QUIETHOURS_START:  // fall through
         case WM_WINMUTE_QUIETHOURS_END:
-            return OnQuietHours(hWnd, msg, wParam, lParam);
+            return OnQuietHours(hWnd, msg, wParam, lParam, received);
         case WM_WINMUTE_AUDIO_SERVICE_SHUTDOWN:
             return OnAudioServiceShutdown(hWnd, wParam, lParam);
         case WM_WINMUTE_AUDIO_DEVICE_ARRIVED:
             muteCtrl_.NotifyAudioDeviceArrived();
             return 0;
         case WM_DEVICECHANGE:
-            return OnDeviceChange(hWnd, msg, wParam, lParam);
+            return OnDeviceChange(hWnd, msg, wParam, lParam, received);
         case WM_WIFISTATUSCHANGED:
-            return OnWifiStatusChange(hWnd, wParam, lParam);
+            return OnWifiStatusChange(hWnd, wParam, lParam, received);
         case WM_WINMUTE_UPDATE_CHECK_DONE:
             return OnUpdateCheckDone(hWnd, wParam, lParam);
         case WM_SETTINGCHANGE:
             return OnSettingChange(hWnd, wParam, lParam);
+        case WM_TIMECHANGE:
+            WMLog::GetInstance().RefreshTimeZone();
+            return 0;
         default:
             if (msg ==
                 uTaskbarRestart) {  // Restore trayicon if explorer.exe crashes
@@ -1097,6 +1304,8 @@ void WinMute::Unload() noexcept
         hLidCloseNotify_ = nullptr;
     }
     StopSessionNotificationRetry();
+    scheduler_.Cancel(triggerFilterTimer_);
+    triggerFilterTimer_ = 0;
     if (wtsSessionNotificationRegistered_) {
         WTSUnRegisterSessionNotification(hWnd_);
         wtsSessionNotificationRegistered_ = false;
@@ -1106,6 +1315,15 @@ void WinMute::Unload() noexcept
 
 void WinMute::Close()
 {
+    LogTriggerFilterCounters();
+    if (WMLog& log = WMLog::GetInstance(); log.IsLogFileEnabled()) {
+        const auto logFile = log.GetLogFileCounters();
+        log.LogInfo(
+            L"Log file: {} records in {} writes ({} bytes), {} rotations, {} "
+            L"failed writes",
+            logFile.records, logFile.commits, logFile.bytesCommitted,
+            logFile.rotations, logFile.failedWrites);
+    }
     Unload();
     PostQuitMessage(0);
 }
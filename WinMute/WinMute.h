@@ -37,6 +37,17 @@ POSSIBILITY OF SUCH DAMAGE.
 
 class WinAudio;
 
+// Sources fed through the trigger EventNormalizer, see TRIGGER_SOURCES.
+enum class TriggerSource {
+    Display = 0,    // GUID_*_DISPLAY_STATE: 0 off, 1 on, 2 dimmed
+    Lid,            // GUID_LIDSWITCH_STATE_CHANGE: 0 closed, 1 open
+    SessionLock,    // 1 locked, 0 unlocked
+    RemoteSession,  // 1 connected, 0 disconnected
+    Bluetooth,      // 1 connected, 0 disconnected
+    Wlan,           // 1 connected to a relevant network, 0 disconnected
+    Count           // Meta
+};
+
 class WinMute {
    public:
     explicit WinMute(WMSettings& settings);
@@ -52,7 +63,6 @@ class WinMute {
     // for internal use
     LRESULT CALLBACK WindowProc(HWND hWnd, UINT msg, WPARAM wParam,
                                 LPARAM lParam);
-    void RetrySessionNotification();
 
    private:
     HWND hWnd_;
@@ -73,15 +83,14 @@ class WinMute {
     };
 
     bool wtsSessionNotificationRegistered_ = false;
-    UINT_PTR wtsRetryTimerId_ = 0;
+    TimerScheduler::TimerHandle wtsRetryTimer_ = 0;
     int wtsRetryAttempts_ = 0;
     HPOWERNOTIFY hPowerNotify_ = nullptr;
     HPOWERNOTIFY hSessionDisplayNotify_ = nullptr;
     HPOWERNOTIFY hLidCloseNotify_ = nullptr;
-    // Console and session display notifications can both fire for the same
-    // transition. 0xFFFFFFFF means "no state seen yet".
-    DWORD lastDisplayState_ = 0xFFFFFFFF;
 
+    // Declared before every component that holds timers, so it outlives them.
+    TimerScheduler scheduler_;
     TrayIcon wmTray_;
     TrayIcon updateTray_;
     WifiDetector wifiDetector_;
@@ -91,6 +100,17 @@ class WinMute {
     QuietHoursTimer quietHours_;
     BluetoothDetector btDetector_;
     UpdateInfo updateInfo_;
+    EventNormalizer triggerFilter_;
+    TimerScheduler::TimerHandle triggerFilterTimer_ = 0;
+    // What wifiDetector_ was set up with, nothing while it is unloaded.
+    struct WlanConfig {
+        std::vector<std::wstring> networks;
+        bool isMuteList = true;
+        bool muteOnConnect = false;
+
+        bool operator==(const WlanConfig& other) const = default;
+    };
+    std::optional<WlanConfig> wlanConfig_;
 
     std::map<int, GlobalHotKey> globalHotkeys_;
 
@@ -100,10 +120,14 @@ class WinMute {
     bool InitAudio();
     bool InitTrayMenu();
     bool LoadSettings();
+    // Returns the conditions the loaded rules look at.
+    ConditionSet LoadMuteRules();
 
     bool TryRegisterSessionNotification();
     void StartSessionNotificationRetry();
+    bool ScheduleSessionNotificationRetry();
     void StopSessionNotificationRetry() noexcept;
+    void RetrySessionNotification();
 
     void Unload() noexcept;
 
@@ -114,18 +138,29 @@ class WinMute {
     void LoadMainMenuText();
     void LoadGlobalHotkeys();
 
+    EventNormalizer::Verdict SubmitTrigger(TriggerSource source, int state,
+                                           EventNormalizer::TimePoint received);
+    void OnTrigger(const EventNormalizer::Event& event);
+    void ArmTriggerFilterTimer();
+    void LogTriggerFilterCounters();
+    void ResetWlanState();
+
     // Windows Callback
     LRESULT OnCommand(HWND hWnd, WPARAM wParam, LPARAM lParam);
     LRESULT OnTrayIcon(HWND hWnd, WPARAM wParam, LPARAM lParam);
     LRESULT OnHotKey(HWND hWnd, WPARAM wParam, LPARAM lParam);
     LRESULT OnSettingChange(HWND hWnd, WPARAM wParam, LPARAM lParam);
-    LRESULT OnPowerBroadcast(HWND hWnd, WPARAM wParam, LPARAM lParam);
-    LRESULT OnWifiStatusChange(HWND hWnd, WPARAM wParam, LPARAM lParam);
+    LRESULT OnPowerBroadcast(HWND hWnd, WPARAM wParam, LPARAM lParam,
+                             MuteLatencyStats::TimePoint received);
+    LRESULT OnWifiStatusChange(HWND hWnd, WPARAM wParam, LPARAM lParam,
+                               MuteLatencyStats::TimePoint received);
     LRESULT OnUpdatePopup(HWND hWnd, WPARAM wParam, LPARAM lParam);
     LRESULT OnUpdateCheckDone(HWND hWnd, WPARAM wParam, LPARAM lParam);
 
-    LRESULT OnDeviceChange(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-    LRESULT OnQuietHours(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+    LRESULT OnDeviceChange(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam,
+                           MuteLatencyStats::TimePoint received);
+    LRESULT OnQuietHours(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam,
+                         MuteLatencyStats::TimePoint received);
     LRESULT OnAudioServiceShutdown(HWND hWnd, WPARAM wParam, LPARAM lParam);
 
     // Runs on updateThread_; must only touch its own locals and post the
@@ -79,6 +79,7 @@ POSSIBILITY OF SUCH DAMAGE.
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <semaphore>
 #include <set>
 #include <span>
 #include <string>
@@ -104,6 +105,7 @@ namespace fs = std::filesystem;
 #include <powrprof.h>
 #include <roapi.h>
 #include <sal.h>
+#include <shobjidl.h>
 #include <strsafe.h>
 #include <tchar.h>
 #include <time.h>
@@ -117,11 +119,31 @@ namespace fs = std::filesystem;
 #pragma warning(default : 4201)
 
 #include "ManagedEndpoint.hpp"
+#include "TimerWheel.hpp"
+#include "EventNormalizer.hpp"
+#include "LatencyHistogram.hpp"
+#include "MuteRules.hpp"
+#include "MuteHysteresis.hpp"
+#include "RestoreScopes.hpp"
+#include "DeferredFormat.hpp"
+#include "MpscQueue.hpp"
+#include "LogRing.hpp"
+#include "TimestampFormatter.hpp"
+#include "RotatingLogFile.hpp"
+#include "RepeatFolder.hpp"
+#include "JsonLogLine.hpp"
+#include "LogFilterIndex.hpp"
+#include "LanguagePack.hpp"
+#include "TranslationTable.hpp"
+#include "LanguageNameReader.hpp"
 
 #include "BluetoothDetector.h"
 #include "MediaController.h"
+#include "MuteLatency.h"
 #include "MuteControl.h"
 #include "QuietHoursTimer.h"
+#include "TimerScheduler.h"
+#include "TranslationKeys.h"
 #include "TrayIcon.h"
 #include "UpdateChecker.h"
 #include "Utility.h"
@@ -145,9 +167,11 @@ namespace fs = std::filesystem;
 
 static const wchar_t* PROGRAM_NAME = L"WinMute";
 static const wchar_t* LOG_FILE_NAME = L"WinMute.log";
+static const wchar_t* LOG_JSON_FILE_NAME = L"WinMute.jsonl";
 
 constexpr int WM_SAVESETTINGS = WM_USER + 300;
 constexpr int WM_WINMUTE_UPDATE_POPUP = WM_USER + 301;
+/* lParam = end sequence number of the log history when it was posted */
 constexpr int WM_LOG_UPDATED = WM_USER + 302;
 constexpr int WM_WINMUTE_AUDIO_SERVICE_SHUTDOWN = WM_USER + 303;
 /* wParam = success. lParam = UpdateInfo*, ownership passes to the receiver */
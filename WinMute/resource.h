@@ -140,6 +140,9 @@
 #define IDC_HOTKEY1                     1082
 #define IDC_GLOBAL_MUTE_HOTKEY          1082
 #define IDC_SETTINGS_TREE               1083
+#define IDC_LOG_FILTER_LEVEL            1084
+#define IDC_LOG_FILTER_TRIGGER          1085
+#define IDC_LOG_FILTER_TEXT             1086
 #define ID_TRAYMENU_INFO                40001
 #define ID_TRAYMENU_                    40002
 #define ID_TRAYMENU_MUTEON              40003
@@ -190,7 +193,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        152
 #define _APS_NEXT_COMMAND_VALUE         40044
-#define _APS_NEXT_CONTROL_VALUE         1084
+#define _APS_NEXT_CONTROL_VALUE         1087
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif